@@ -3,6 +3,7 @@
 #include "engine/EventManager.hxx"
 #include "engine/UIManager.hxx"
 #include "engine/ResourcesManager.hxx"
+#include "engine/Sprite.hxx"
 #include "engine/WindowManager.hxx"
 #include "engine/basics/Camera.hxx"
 #include "LOG.hxx"
@@ -323,6 +324,7 @@ void Game::run(bool SkipMenu)
 
   benchmarkTimer.start();
   Engine &engine = Engine::instance();
+  engine.gameClock = &m_GameClock;
 
   debug_scope {
     LOG(LOG_DEBUG) << "Map initialized in " << benchmarkTimer.getElapsedTime() << "ms";
@@ -373,6 +375,13 @@ void Game::run(bool SkipMenu)
   }
 #endif // USE_AUDIO
 
+  m_GameClock.addGameTimeClockTask(
+      []() {
+        Engine::instance().queueSimulationTick();
+        return false;
+      },
+      GameClock::GameMinute, GameClock::GameMinute);
+
   // FPS Counter variables
   const float fpsIntervall = 1.0; // interval the fps counter is refreshed in seconds.
   Uint32 fpsLastTime = SDL_GetTicks();
@@ -388,11 +397,18 @@ void Game::run(bool SkipMenu)
 
     evManager.checkEvents(event, engine);
 
+    engine.updateSimulation();
+
     // render the tileMap
     if (engine.map != nullptr)
     {
+      Sprite::setAnimationTime(SDL_GetTicks());
       engine.map->renderMap();
     }
+    if (engine.simulation != nullptr)
+    {
+      engine.simulation->render();
+    }
 
     // render the ui
     // TODO: This is only temporary until the new UI is ready. Remove this afterwards
@@ -422,6 +438,11 @@ void Game::run(bool SkipMenu)
     MicroProfileFlip(nullptr);
 #endif
   }
+
+  if (!Settings::instance().recordCommands.empty())
+  {
+    engine.saveCommandLog(Settings::instance().recordCommands);
+  }
 }
 
 template <typename MQType, typename Visitor> void Game::LoopMain(GameContext &context, Visitor visitor)
@@ -4,49 +4,294 @@
 #include "basics/mapEdit.hxx"
 #include "basics/Settings.hxx"
 #include "ResourcesManager.hxx"
+#include "../services/GameClock.hxx"
+#include "../util/Filesystem.hxx"
 #include "../util/LOG.hxx"
 
+#include <algorithm>
+#include <iomanip>
+#include <random>
+#include <sstream>
+
 Engine::Engine() {}
 
 Engine::~Engine() { 
   debug_scope {
     LOG(LOG_DEBUG) << "Destroying Engine";
   }
+  delete simulation;
   delete map;
 }
 
 void Engine::increaseHeight(const Point &isoCoordinates) const
 {
   terrainEditMode = TerrainEdit::RAISE;
-  map->increaseHeight(isoCoordinates);
+  MapCommand command;
+  command.type = MapCommand::RAISE_TERRAIN;
+  command.nodes.push_back(isoCoordinates);
+  execute(command);
 }
 
 void Engine::decreaseHeight(const Point &isoCoordinates) const
 {
   terrainEditMode = TerrainEdit::LOWER;
-  map->decreaseHeight(isoCoordinates);
+  MapCommand command;
+  command.type = MapCommand::LOWER_TERRAIN;
+  command.nodes.push_back(isoCoordinates);
+  execute(command);
+}
+
+void Engine::demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeighboringTiles, Layer layer) const
+{
+  MapCommand command;
+  command.type = MapCommand::DEMOLISH;
+  command.nodes = isoCoordinates;
+  command.layer = layer;
+  command.updateNeighbors = updateNeighboringTiles;
+  execute(command);
+}
+
+void Engine::addTransitLine(const std::vector<Point> &stops, int vehicles) const
+{
+  MapCommand command;
+  command.type = MapCommand::ADD_LINE;
+  command.nodes = stops;
+  command.value = static_cast<float>(vehicles);
+  execute(command);
+}
+
+void Engine::removeTransitLine(const Point &stop) const
+{
+  MapCommand command;
+  command.type = MapCommand::REMOVE_LINE;
+  command.nodes.push_back(stop);
+  execute(command);
+}
+
+void Engine::execute(MapCommand command) const
+{
+  if (simulation)
+  {
+    command.tick = simulation->getTickCount();
+    simulation->getCommandLog().record(command);
+  }
+  if (command.type == MapCommand::SPEED)
+  {
+    if (gameClock)
+    {
+      gameClock->setGameClockSpeed(command.value);
+    }
+  }
+  else if (simulation)
+  {
+    simulation->applyCommand(command);
+  }
+  else
+  {
+    map->applyCommand(command);
+  }
+}
+
+void Engine::setGameSpeed(float speedFactor)
+{
+  m_gameSpeed = speedFactor;
+  MapCommand command;
+  command.type = MapCommand::SPEED;
+  command.value = speedFactor;
+  execute(command);
+}
+
+void Engine::recordCamera()
+{
+  const Camera &camera = Camera::instance();
+  if (camera.cameraOffset().x == m_recordedCamera.cameraX && camera.cameraOffset().y == m_recordedCamera.cameraY &&
+      static_cast<float>(camera.zoomLevel()) == m_recordedCamera.value)
+  {
+    return;
+  }
+  m_recordedCamera.type = MapCommand::CAMERA;
+  m_recordedCamera.tick = simulation->getTickCount();
+  m_recordedCamera.cameraX = camera.cameraOffset().x;
+  m_recordedCamera.cameraY = camera.cameraOffset().y;
+  m_recordedCamera.value = static_cast<float>(camera.zoomLevel());
+  simulation->getCommandLog().record(m_recordedCamera);
+}
+
+void Engine::saveCommandLog(const std::string &fileName) const
+{
+  if (!simulation)
+  {
+    return;
+  }
+
+  CommandLog &log = simulation->getCommandLog();
+  log.setEnd(simulation->getTickCount(), simulation->getStateHash().getHash());
+  std::vector<uint8_t> buffer;
+  log.save(buffer);
+  fs::writeStringToFile(fileName, std::string(buffer.begin(), buffer.end()), true);
+
+  LOG(LOG_INFO) << "Recorded " << log.getCommands().size() << " commands over " << log.getEndTick() << " ticks to "
+                << fileName;
+}
+
+bool Engine::replay(const std::string &fileName)
+{
+  CommandLog log;
+  try
+  {
+    const std::string data = fs::readFileAsString(fileName, true);
+    log.load(std::vector<uint8_t>(data.begin(), data.end()));
+  }
+  catch (const CytopiaError &e)
+  {
+    LOG(LOG_ERROR) << "Could not load the command log " << fileName << ": " << e.what();
+    return false;
+  }
+
+  const CommandLog::Start &start = log.getStart();
+  if (start.saveGame.empty())
+  {
+    delete simulation;
+    simulation = nullptr;
+    delete map;
+    map = new Map(start.columns, start.rows, true, start.terrainSeed);
+    createSimulation(log.getSeed());
+  }
+  else
+  {
+    // the seed is part of the savegame
+    loadGame(start.saveGame);
+  }
+  if (!simulation || simulation->getTickCount() > log.getEndTick())
+  {
+    LOG(LOG_ERROR) << "Could not recreate the map the session " << fileName << " started with";
+    return false;
+  }
+
+  // the camera and the speed don't change the city, the simulation runs as fast as possible without rendering
+  const std::vector<MapCommand> &commands = log.getCommands();
+  size_t command = 0;
+  std::vector<double> tickDurations;
+  tickDurations.reserve(log.getEndTick() - simulation->getTickCount());
+  const auto replayStart = std::chrono::steady_clock::now();
+  while (simulation->getTickCount() < log.getEndTick())
+  {
+    const auto tickStart = std::chrono::steady_clock::now();
+    for (; command < commands.size() && commands[command].tick <= simulation->getTickCount(); ++command)
+    {
+      if (!commands[command].isView())
+      {
+        simulation->applyCommand(commands[command]);
+      }
+    }
+    simulation->tick();
+    tickDurations.push_back(
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tickStart).count());
+  }
+  const std::chrono::duration<double, std::milli> total = std::chrono::steady_clock::now() - replayStart;
+
+  std::ostringstream timings;
+  timings << "tick,milliseconds\n";
+  const unsigned int firstTick = log.getEndTick() - static_cast<unsigned int>(tickDurations.size());
+  for (size_t tick = 0; tick < tickDurations.size(); ++tick)
+  {
+    timings << firstTick + tick + 1 << ',' << tickDurations[tick] << '\n';
+  }
+  fs::writeStringToFile(fileName + ".timings.csv", timings.str());
+
+  const uint64_t stateHash = simulation->getStateHash().getHash();
+  const bool reproduced = stateHash == log.getEndHash();
+  std::sort(tickDurations.begin(), tickDurations.end());
+  auto percentile = [&tickDurations](double fraction) {
+    return tickDurations.empty() ? 0.0 : tickDurations[static_cast<size_t>(fraction * (tickDurations.size() - 1))];
+  };
+  LOG(LOG_INFO) << "Replayed " << tickDurations.size() << " ticks and " << command << " commands of " << fileName
+                << " in " << total.count() << "ms, tick median " << percentile(0.5) << "ms, 99th percentile "
+                << percentile(0.99) << "ms, max " << percentile(1.0) << "ms";
+  std::ostringstream hash;
+  hash << std::hex << std::setw(16) << std::setfill('0') << stateHash;
+  if (reproduced)
+  {
+    LOG(LOG_INFO) << "Final state hash " << hash.str() << " matches the recorded session";
+  }
+  else
+  {
+    LOG(LOG_ERROR) << "Final state hash " << hash.str() << " differs from the recorded session, the replay diverged";
+  }
+  return reproduced;
 }
 
 void Engine::toggleFullScreen() { WindowManager::instance().toggleFullScreen(); };
 
 void Engine::loadGame(const std::string &fileName)
 {
-  Map *newMap = Map::loadMapFromFile(fileName);
+  std::vector<uint8_t> simulationData;
+  Map *newMap = Map::loadMapFromFile(fileName, &simulationData);
 
   if (newMap)
   {
+    delete simulation;
+    simulation = nullptr;
     delete map;
     map = newMap;
+    // the seed is restored with the state of the simulation
+    createSimulation(0);
+    simulation->load(simulationData);
+    simulation->getCommandLog().setStart({fileName, map->getColumns(), map->getRows(), 0});
     m_running = true;
   }
 }
 
+void Engine::saveGame(const std::string &fileName) const
+{
+  std::vector<uint8_t> simulationData;
+
+  if (simulation)
+  {
+    simulation->save(simulationData);
+  }
+
+  map->saveMapToFile(fileName, simulationData);
+}
+
 void Engine::newGame()
 {
+  delete simulation;
+  simulation = nullptr;
   delete map;
   m_running = true;
 
   const int mapSize = Settings::instance().mapSize;
 
   map = new Map(mapSize, mapSize);
+  createSimulation(std::random_device{}());
+  simulation->getCommandLog().setStart({"", mapSize, mapSize, map->getTerrainSeed()});
+}
+
+void Engine::createSimulation(uint64_t seed)
+{
+  simulation = new Simulation(*map, seed);
+  simulation->rebuild();
+  m_pendingSimulationTicks = 0;
+  m_recordedCamera = MapCommand();
+}
+
+void Engine::updateSimulation()
+{
+  int ticks = m_pendingSimulationTicks.exchange(0);
+  const auto now = std::chrono::steady_clock::now();
+  const std::chrono::duration<float> elapsed = now - m_lastSimulationUpdate;
+  m_lastSimulationUpdate = now;
+
+  if (!simulation)
+  {
+    return;
+  }
+
+  recordCamera();
+  while (ticks-- > 0)
+  {
+    simulation->tick();
+  }
+  simulation->advance(elapsed.count());
 }
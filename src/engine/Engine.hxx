@@ -6,8 +6,14 @@
 #include "WindowManager.hxx"
 #include "basics/point.hxx"
 #include "Map.hxx"
+#include "simulation/Simulation.hxx"
 #include "../util/Singleton.hxx"
 
+#include <atomic>
+#include <chrono>
+
+class GameClock;
+
 class Engine : public Singleton<Engine>
 {
 public:
@@ -43,9 +49,65 @@ public:
   {
     static_assert(std::is_same_v<Point, typename std::iterator_traits<Iterator>::value_type>,
                   "Iterator value must be a const Point");
-    map->setTileIDOfNode<std::vector<Point>::iterator>(begin, end, tileID, isMultiObject);
+    MapCommand command;
+    command.type = isMultiObject ? MapCommand::PLACE : MapCommand::PLACE_OBJECT;
+    command.tileID = tileID;
+    command.nodes.assign(begin, end);
+    execute(command);
   }
 
+  /** @brief Demolish nodes
+    * @see Map#demolishNode
+    */
+  void demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeighboringTiles = false,
+                    Layer layer = Layer::NONE) const;
+
+  /** @brief Add a transit line
+    * @param stops road nodes the vehicles stop at, in the order they are served before returning to the first one
+    * @param vehicles number of vehicles serving the line
+    * @see TransitLines#addLine
+    */
+  void addTransitLine(const std::vector<Point> &stops, int vehicles) const;
+
+  /** @brief Remove the transit line that stops at the given node
+    * @see TransitLines#removeLineAt
+    */
+  void removeTransitLine(const Point &stop) const;
+
+  /** @brief Execute an edit of the player
+    * All edits of the map by the player go through here, so they are recorded in the command log of the simulation.
+    * @param command the edit, its tick is set to the current tick of the simulation.
+    * @see Map#applyCommand
+    */
+  void execute(MapCommand command) const;
+
+  /** @brief Set the speed of the game
+    * The change is recorded in the command log of the simulation.
+    * @param speedFactor scale factor of the game clock, e.g. 4.0 runs the game 4 times faster
+    * @see GameClock#setGameClockSpeed
+    */
+  void setGameSpeed(float speedFactor);
+
+  /** @brief Get the speed factor of the game clock that has been set last
+    */
+  float getGameSpeed() const { return m_gameSpeed; };
+
+  /** @brief Write the commands of the current session to a file
+    * Together with the seed and the map the session started with, they are enough to replay it.
+    * @param fileName FileName of the command log
+    * @see CommandLog#save
+    */
+  void saveCommandLog(const std::string &fileName) const;
+
+  /** @brief Replay a recorded session without rendering
+    * Recreates the map the session started with and executes the recorded commands while the simulation runs as fast as
+    * possible until the tick the recording ended with. The duration of every tick and the final state hash are logged
+    * and the durations are written to fileName.timings.csv, so the same session can be compared across builds.
+    * @param fileName FileName of a command log written by saveCommandLog()
+    * @returns true if the replay reached the state hash of the recorded session
+    */
+  bool replay(const std::string &fileName);
+
   /** @brief Checks if game is running
     * Checks if game is running
     * @returns Returns true if the game is running, and false otherwise
@@ -64,19 +126,48 @@ public:
     */
   void loadGame(const std::string &fileName);
 
-  void saveGame(const std::string &fileName) const { map->saveMapToFile(fileName); };
+  /** @brief Saves the game
+    * Saves the map along with the state of the simulation
+    * @param fileName FileName of the saved game
+    * @see Map#saveMapToFile
+    */
+  void saveGame(const std::string &fileName) const;
 
   /** @brief Creates a new game
     * Creates a new game
     */
   void newGame();
 
-  Map *map;
+  /** @brief Queue a simulation tick
+    * Called from the GameClock, which may run on a different thread than the map.
+    * The queued ticks are processed by updateSimulation().
+    */
+  void queueSimulationTick() { m_pendingSimulationTicks++; };
+
+  /** @brief Process all queued simulation ticks and advance the real time simulation
+    * Must be called from the thread that owns the map.
+    */
+  void updateSimulation();
+
+  Map *map = nullptr;
+  Simulation *simulation = nullptr;
+  GameClock *gameClock = nullptr;
 
 private:
   Engine();
   ~Engine();
   bool m_running = false;
+  float m_gameSpeed = 1.f;
+  std::atomic<int> m_pendingSimulationTicks = 0;
+  std::chrono::steady_clock::time_point m_lastSimulationUpdate = std::chrono::steady_clock::now();
+  /// the camera state that has been recorded last
+  MapCommand m_recordedCamera;
+
+  /// (Re)create the simulation for the current map
+  void createSimulation(uint64_t seed);
+
+  /// Record the camera if it has been moved or zoomed since it has been recorded last
+  void recordCamera();
 };
 
 #endif
@@ -16,6 +16,15 @@
 #include "microprofile.h"
 #endif
 
+#include <algorithm>
+
+namespace
+{
+/// Range of the speed factor of the game clock, the keys + and - double and halve it
+constexpr float MIN_GAME_SPEED = 0.25f;
+constexpr float MAX_GAME_SPEED = 8.f;
+} // namespace
+
 EventManager::~EventManager()
 {
   debug_scope {
@@ -37,6 +46,26 @@ void EventManager::unHighlightNodes()
   m_nodesToPlace.clear();
 }
 
+void EventManager::finishTransitLine(Engine &engine)
+{
+  if (m_transitStops.size() >= 2)
+  {
+    // one vehicle per stop, so longer lines keep their frequency
+    const int vehicles = static_cast<int>(std::min(m_transitStops.size(), static_cast<size_t>(TransitLines::MaxVehicles)));
+    engine.addTransitLine(m_transitStops, vehicles);
+  }
+  clearTransitStops(engine);
+}
+
+void EventManager::clearTransitStops(Engine &engine)
+{
+  for (const Point &stop : m_transitStops)
+  {
+    engine.map->unHighlightNode(stop);
+  }
+  m_transitStops.clear();
+}
+
 void EventManager::checkEvents(SDL_Event &event, Engine &engine)
 {
 #ifdef MICROPROFILE_ENABLED
@@ -58,7 +87,12 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
       switch (event.key.keysym.sym)
       {
       case SDLK_ESCAPE:
-        if (!tileToPlace.empty())
+        if (m_transitLineMode)
+        {
+          clearTransitStops(engine);
+          m_transitLineMode = false;
+        }
+        else if (!tileToPlace.empty())
         {
           m_uiManager.closeOpenMenus();
           tileToPlace.clear();
@@ -83,6 +117,17 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
           GameStates::instance().placementMode = PlacementMode::STRAIGHT_LINE;
         }
         break;
+      case SDLK_LALT:
+        if (GameStates::instance().placementMode == PlacementMode::RECTANGLE)
+        {
+          GameStates::instance().placementMode = PlacementMode::FILL;
+        }
+        else if (GameStates::instance().placementMode == PlacementMode::LINE &&
+                 TileManager::instance().getTileLayer(tileToPlace) == Layer::ROAD)
+        {
+          GameStates::instance().placementMode = PlacementMode::ROUTE;
+        }
+        break;
       case SDLK_F11:
         m_uiManager.toggleDebugMenu();
         break;
@@ -101,6 +146,18 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
       case SDLK_i:
         m_tileInfoMode = !m_tileInfoMode;
         break;
+      case SDLK_t:
+        // click on roads to collect the stops, enter or a click on the first stop closes the line
+        clearTransitStops(engine);
+        m_transitLineMode = !m_transitLineMode;
+        break;
+      case SDLK_RETURN:
+      case SDLK_KP_ENTER:
+        if (m_transitLineMode)
+        {
+          finishTransitLine(engine);
+        }
+        break;
       case SDLK_h:
         // TODO: This is only temporary until the new UI is ready. Remove this afterwards
         GameStates::instance().drawUI = !GameStates::instance().drawUI;
@@ -108,6 +165,26 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
       case SDLK_f:
         engine.toggleFullScreen();
         break;
+      case SDLK_o:
+        if (engine.simulation)
+        {
+          engine.simulation->nextDataMap();
+        }
+        break;
+      case SDLK_p:
+        if (engine.simulation)
+        {
+          engine.simulation->nextColorRamp();
+        }
+        break;
+      case SDLK_PLUS:
+      case SDLK_KP_PLUS:
+        engine.setGameSpeed(std::min(engine.getGameSpeed() * 2.f, MAX_GAME_SPEED));
+        break;
+      case SDLK_MINUS:
+      case SDLK_KP_MINUS:
+        engine.setGameSpeed(std::max(engine.getGameSpeed() / 2.f, MIN_GAME_SPEED));
+        break;
       case SDLK_UP:
       case SDLK_w:
         if (Camera::instance().cameraOffset().y > -2 * m_Window->getBounds().height()* Camera::instance().zoomLevel())
@@ -187,6 +264,16 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
           GameStates::instance().placementMode = PlacementMode::LINE;
         }
         break;
+      case SDLK_LALT:
+        if (GameStates::instance().placementMode == PlacementMode::FILL)
+        {
+          GameStates::instance().placementMode = PlacementMode::RECTANGLE;
+        }
+        else if (GameStates::instance().placementMode == PlacementMode::ROUTE)
+        {
+          GameStates::instance().placementMode = PlacementMode::LINE;
+        }
+        break;
 
       default:
         break;
@@ -339,8 +426,18 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
             }
           }
 
+          const TileData *fillTileData = TileManager::instance().getTileData(tileToPlace);
+          const bool fill = GameStates::instance().placementMode == PlacementMode::FILL &&
+                            (demolishMode || (fillTileData && fillTileData->tileType == +TileType::ZONE));
+
+          // the fill tool selects the area under the mouse, without dragging
+          if (fill)
+          {
+            m_nodesToPlace = engine.map->getFillNodes(mouseIsoCoords, demolishMode ? "" : tileToPlace);
+            m_nodesToHighlight = m_nodesToPlace;
+          }
           // if mouse is held down, we need to check for plamentmodes LINE and RECTANGLE
-          if ((SDL_GetMouseState(NULL, NULL) & SDL_BUTTON(SDL_BUTTON_LEFT)))
+          else if ((SDL_GetMouseState(NULL, NULL) & SDL_BUTTON(SDL_BUTTON_LEFT)))
           {
             switch (GameStates::instance().placementMode)
             {
@@ -359,6 +456,15 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
               m_nodesToPlace = getRectangleSelectionNodes(m_clickDownCoords, mouseIsoCoords);
               m_nodesToHighlight = m_nodesToPlace;
               break;
+            case PlacementMode::ROUTE:
+              m_nodesToPlace = engine.map->getRoadRoute(m_clickDownCoords, mouseIsoCoords, tileToPlace);
+              m_nodesToHighlight = m_nodesToPlace;
+              break;
+            case PlacementMode::FILL:
+              // only zones can be filled, other tiles fall back to a rectangle
+              m_nodesToPlace = getRectangleSelectionNodes(m_clickDownCoords, mouseIsoCoords);
+              m_nodesToHighlight = m_nodesToPlace;
+              break;
             }
           }
 
@@ -374,6 +480,12 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
           // if we touch a bigger than 1x1 tile also add all nodes of the building to highlight.
           for (const auto &coords : m_nodesToHighlight)
           {
+            // filled areas contain no buildings, and can be too big for this lookup
+            if (fill)
+            {
+              break;
+            }
+
             // If we place a ground decoration tile, we must add all tiles of bigger than 1x1 buildings from the Layer BUILDINGS
             Layer layer;
             if (demolishMode || (tileToPlaceData && tileToPlaceData->tileType == +TileType::GROUNDDECORATION))
@@ -406,9 +518,11 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
           }
 
           // we need to check if placement is allowed and set a bool to color ALL the highlighted tiles and not just those who can't be placed
+          // routes only lead over nodes that can take a road once their buildings are demolished
+          const bool route = GameStates::instance().placementMode == PlacementMode::ROUTE;
           for (const auto &highlitNode : m_nodesToHighlight)
           {
-            if (!engine.map->isPlacementOnNodeAllowed(highlitNode, tileToPlace) || demolishMode)
+            if (!engine.map->isPlacementOnNodeAllowed(highlitNode, tileToPlace, route) || demolishMode)
             {
               // already occupied tile, mark red
               m_placementAllowed = false;
@@ -542,6 +656,22 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
         {
           engine.map->getNodeInformation({mouseIsoCoords.x, mouseIsoCoords.y, 0, 0});
         }
+        else if (m_transitLineMode && isPointWithinMapBoundaries(mouseIsoCoords))
+        {
+          // with the demolish tool a click removes the line that stops there
+          if (demolishMode)
+          {
+            engine.removeTransitLine(mouseIsoCoords);
+          }
+          else if (m_transitStops.size() >= 2 && m_transitStops.front() == mouseIsoCoords)
+          {
+            finishTransitLine(engine);
+          }
+          else if (!engine.map->getTileID(mouseIsoCoords, Layer::ROAD).empty())
+          {
+            m_transitStops.push_back(mouseIsoCoords);
+          }
+        }
         else if (terrainEditMode == TerrainEdit::RAISE)
         {
           engine.increaseHeight(mouseIsoCoords);
@@ -560,16 +690,36 @@ void EventManager::checkEvents(SDL_Event &event, Engine &engine)
           }
           else
           {
-            engine.setTileIDOfNode(m_nodesToPlace.begin(), m_nodesToPlace.end(), tileToPlace, true);
+            // routes can lead through buildings, which make way for the road, but only if the whole road can be placed
+            if (GameStates::instance().placementMode == PlacementMode::ROUTE)
+            {
+              const bool routeAllowed =
+                  std::all_of(m_nodesToPlace.begin(), m_nodesToPlace.end(), [&engine](const Point &node) {
+                    return engine.map->isPlacementOnNodeAllowed(node, tileToPlace, true);
+                  });
+              if (routeAllowed)
+              {
+                engine.demolishNode(m_nodesToPlace, false, Layer::BUILDINGS);
+                engine.setTileIDOfNode(m_nodesToPlace.begin(), m_nodesToPlace.end(), tileToPlace, true);
+              }
+            }
+            else
+            {
+              engine.setTileIDOfNode(m_nodesToPlace.begin(), m_nodesToPlace.end(), tileToPlace, true);
+            }
           }
         }
         else if (demolishMode)
         {
-          engine.map->demolishNode(m_nodesToHighlight, true);
+          engine.demolishNode(m_nodesToHighlight, true);
         }
       }
       // when we're done, reset highlighting
       unHighlightNodes();
+      for (const Point &stop : m_transitStops)
+      {
+        engine.map->highlightNode(stop, SpriteHighlightColor::GRAY);
+      }
 
       if (highlightSelection)
       {
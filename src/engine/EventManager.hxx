@@ -24,6 +24,14 @@ public:
   void setWindow(class Window*);
 
 private:
+  /** @brief Add a transit line through the collected stops and start a new one.
+    * @param engine the engine that executes the command.
+    */
+  void finishTransitLine(Engine &engine);
+  /** @brief Forget the collected stops and remove their highlighting.
+    */
+  void clearTransitStops(Engine &engine);
+
   UIManager &m_uiManager = UIManager::instance();
 
   UIElement *m_lastHoveredElement = nullptr;
@@ -34,10 +42,12 @@ private:
   bool m_skipLeftClick = false;
   bool m_tileInfoMode = false;
   bool m_cancelTileSelection = false; /// determines if a right click should cancel tile selection
+  bool m_transitLineMode = false;     /// clicks on roads collect the stops of a new transit line
   Point m_pinchCenterCoords = {0, 0, 0, 0};
   Point m_clickDownCoords = {0, 0, 0, 0};
   std::vector<Point> m_nodesToPlace = {};
   std::vector<Point> m_nodesToHighlight = {};
+  std::vector<Point> m_transitStops = {};
   std::vector<Timer *> m_timers;
   std::vector<Point> m_transparentBuildings;
   class Window * m_Window = nullptr;
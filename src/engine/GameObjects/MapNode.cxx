@@ -1,7 +1,7 @@
-#include <cstdlib>
 #include "MapNode.hxx"
 
 #include "LOG.hxx"
+#include "Hash.hxx"
 #include "../map/MapLayers.hxx"
 #include "GameStates.hxx"
 #include "Settings.hxx"
@@ -110,10 +110,13 @@ void MapNode::setTileID(const std::string &tileID, const Point &origCornerPoint)
     // Determine if the tile should have a random rotation or not.
     if (m_mapNodeData[layer].tileData->tiles.pickRandomTile && m_mapNodeData[layer].tileData->tiles.count > 1)
     {
-      /** set tileIndex to a rand between 1 and count, this will be the displayed image of the entire tileset
+      /** set tileIndex to a random value between 0 and count - 1, this will be the displayed image of the entire tileset
       * if this tile has ordered frames, like roads then pickRandomTile must be set to 0.
+      * The value is derived from the position, so the same edits always produce the same map.
       **/
-      m_mapNodeData[layer].tileIndex = rand() % m_mapNodeData[layer].tileData->tiles.count;
+      const uint64_t position = (static_cast<uint64_t>(m_isoCoordinates.x) << 32) | static_cast<uint32_t>(m_isoCoordinates.y);
+      const uint64_t random = xxHash64(tileID.data(), tileID.size(), position);
+      m_mapNodeData[layer].tileIndex = static_cast<int32_t>(random % m_mapNodeData[layer].tileData->tiles.count);
     }
     else
     {
@@ -197,7 +200,7 @@ bool MapNode::isPlacableOnSlope(const std::string &tileID) const
   return true;
 }
 
-bool MapNode::isPlacementAllowed(const std::string &newTileID) const
+bool MapNode::isPlacementAllowed(const std::string &newTileID, bool demolishBuildings) const
 {
   TileData *tileData = TileManager::instance().getTileData(newTileID);
   const Layer layer = TileManager::instance().getTileLayer(newTileID);
@@ -211,7 +214,8 @@ bool MapNode::isPlacementAllowed(const std::string &newTileID) const
       {
         return true;
       }
-      else if ((isLayerOccupied(Layer::BUILDINGS) && (m_mapNodeData[Layer::BUILDINGS].tileData->category != "Flora")) ||
+      else if ((!demolishBuildings && isLayerOccupied(Layer::BUILDINGS) &&
+                (m_mapNodeData[Layer::BUILDINGS].tileData->category != "Flora")) ||
                isLayerOccupied(Layer::WATER) || !isPlacableOnSlope(newTileID))
       {
         return false;
@@ -343,6 +347,8 @@ void MapNode::updateTexture(const Layer &layer)
           m_sprite->setClipRect({clipRect.x + m_clippingWidth * m_mapNodeData[currentLayer].tileData->tiles.offset, 0,
                                  m_clippingWidth, m_mapNodeData[currentLayer].tileData->tiles.clippingHeight},
                                 static_cast<Layer>(currentLayer));
+          m_sprite->setAnimation(TileManager::instance().getAnimation(m_mapNodeData[currentLayer].tileID),
+                                 static_cast<Layer>(currentLayer));
           if (m_mapNodeData[currentLayer].shouldRender)
           {
             m_sprite->setTexture(TileManager::instance().getTexture(m_mapNodeData[currentLayer].tileID),
@@ -368,6 +374,7 @@ void MapNode::updateTexture(const Layer &layer)
           m_sprite->setClipRect({clipRect.x + m_clippingWidth * m_mapNodeData[currentLayer].tileData->shoreTiles.offset, 0,
                                  m_clippingWidth, m_mapNodeData[currentLayer].tileData->shoreTiles.clippingHeight},
                                 static_cast<Layer>(currentLayer));
+          m_sprite->setAnimation(nullptr, static_cast<Layer>(currentLayer));
           if (m_mapNodeData[currentLayer].shouldRender)
           {
             m_sprite->setTexture(TileManager::instance().getTexture(m_mapNodeData[currentLayer].tileID + "_shore"),
@@ -391,6 +398,7 @@ void MapNode::updateTexture(const Layer &layer)
           m_sprite->setClipRect({clipRect.x + m_mapNodeData[currentLayer].tileData->slopeTiles.offset * m_clippingWidth, 0,
                                  m_clippingWidth, m_mapNodeData[currentLayer].tileData->slopeTiles.clippingHeight},
                                 static_cast<Layer>(currentLayer));
+          m_sprite->setAnimation(nullptr, static_cast<Layer>(currentLayer));
           m_sprite->setTexture(TileManager::instance().getTexture(m_mapNodeData[currentLayer].tileID),
                                static_cast<Layer>(currentLayer));
         }
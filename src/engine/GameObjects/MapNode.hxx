@@ -91,7 +91,11 @@ public:
     */
   const std::string &getTileID(Layer layer) const { return m_mapNodeData[layer].tileID; };
 
-  bool isPlacementAllowed(const std::string &newTileID) const;
+  /** @brief Check if a tile can be placed on this node.
+    * @param newTileID the tile to place.
+    * @param demolishBuildings whether the buildings on the node are demolished first, which only matters for roads.
+    */
+  bool isPlacementAllowed(const std::string &newTileID, bool demolishBuildings = false) const;
 
   /// Overwrite m_mapData with the one loaded from a savegame. This function to be used only by loadGame
   void setMapNodeData(std::vector<MapNodeData> &&mapNodeData, const Point &isoCoordinates);
@@ -9,16 +9,17 @@
 #include "common/Constants.hxx"
 #include "ResourcesManager.hxx"
 #include "map/MapLayers.hxx"
+#include "simulation/CommandLog.hxx"
 #include "common/JsonSerialization.hxx"
 #include "Filesystem.hxx"
 #include "../view/Window.hxx"
 #include "json.hxx"
 
+#include <algorithm>
 #include <sstream>
 #include <string>
 #include <set>
 #include <queue>
-#include <unordered_set>
 
 #ifdef MICROPROFILE_ENABLED
 #include "microprofile.h"
@@ -86,15 +87,17 @@ void Map::getNodeInformation(const Point &isoCoordinates) const
   LOG(LOG_INFO) << "TileIndex: " << mapNodeData.tileIndex;
 }
 
-Map::Map(int columns, int rows, const bool generateTerrain)
-    : pMapNodesVisible(new Sprite *[columns * rows]), m_columns(columns), m_rows(rows)
+Map::Map(int columns, int rows, const bool generateTerrain, int terrainSeed)
+    : pMapNodesVisible(new Sprite *[columns * rows]), m_columns(columns), m_rows(rows), m_floodFill(columns, rows),
+      m_roadRouter(columns, rows)
 {
   // TODO move Random Engine out of map
   randomEngine.seed();
-  MapLayers::enableLayers({TERRAIN, BUILDINGS, WATER, GROUND_DECORATION, ZONE, ROAD});
+  MapLayers::enableLayers({TERRAIN, BUILDINGS, WATER, GROUND_DECORATION, ZONE, ROAD, MOVABLE_OBJECTS});
 
   if (generateTerrain)
   {
+    m_terrainGen.setSeed(terrainSeed);
     m_terrainGen.generateTerrain(mapNodes, mapNodesInDrawingOrder);
   }
 
@@ -135,11 +138,15 @@ bool Map::updateHeight(MapNode &mapNode, const bool higher, std::vector<Neighbor
 {
   if (mapNode.changeHeight(higher))
   {
+    NodeSnapshot snapshot;
+
     for (const auto neighbour : neighbors)
     {
       if (neighbour.pNode->isLayerOccupied(Layer::ZONE))
       {
+        takeNodeSnapshot(*neighbour.pNode, snapshot);
         neighbour.pNode->demolishLayer(Layer::ZONE);
+        emitNodeChanges(*neighbour.pNode, snapshot);
       }
     }
 
@@ -183,6 +190,12 @@ void Map::increaseHeight(const Point &isoCoordinates) { changeHeight(isoCoordina
 
 void Map::decreaseHeight(const Point &isoCoordinates) { changeHeight(isoCoordinates, false); }
 
+void Map::sortNodeIndices(std::vector<int> &indices)
+{
+  std::sort(indices.begin(), indices.end());
+  indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
 void Map::updateNodeNeighbors(std::vector<MapNode *> &nodes)
 {
   // those bitmask combinations require the tile to be elevated.
@@ -194,11 +207,12 @@ void Map::updateNodeNeighbors(std::vector<MapNode *> &nodes)
       NeighbourNodesPosition::BOTOM_LEFT | NeighbourNodesPosition::RIGHT | NeighbourNodesPosition::TOP,
       NeighbourNodesPosition::BOTOM_RIGHT | NeighbourNodesPosition::LEFT | NeighbourNodesPosition::TOP};
 
-  std::unordered_set<MapNode *> nodesToBeUpdated;
+  // node indices, they are sorted before the changes are applied so the order doesn't depend on the node addresses
+  std::vector<int> nodesToBeUpdated;
   std::map<MapNode *, std::vector<NeighborNode>> nodeCache;
   std::queue<MapNode *> nodesUpdatedHeight;
   std::vector<MapNode *> nodesToElevate;
-  std::unordered_set<MapNode *> nodesToDemolish;
+  std::vector<int> nodesToDemolish;
 
   for (auto &pUpdateNode : nodes)
   {
@@ -249,7 +263,7 @@ void Map::updateNodeNeighbors(std::vector<MapNode *> &nodes)
       while (nodesUpdatedHeight.empty() && !nodesToElevate.empty())
       {
         MapNode *pEleNode = nodesToElevate.back();
-        nodesToBeUpdated.insert(pEleNode);
+        nodesToBeUpdated.push_back(nodeIdx(pEleNode->getCoordinates().x, pEleNode->getCoordinates().y));
         nodesToElevate.pop_back();
 
         if (nodeCache.count(pEleNode) == 0)
@@ -261,7 +275,7 @@ void Map::updateNodeNeighbors(std::vector<MapNode *> &nodes)
 
         if (elevationBitmask != pEleNode->getElevationBitmask())
         {
-          nodesToDemolish.insert(pEleNode);
+          nodesToDemolish.push_back(nodeIdx(pEleNode->getCoordinates().x, pEleNode->getCoordinates().y));
           pEleNode->setElevationBitMask(elevationBitmask);
         }
 
@@ -278,35 +292,152 @@ void Map::updateNodeNeighbors(std::vector<MapNode *> &nodes)
     }
   }
 
+  sortNodeIndices(nodesToDemolish);
+  sortNodeIndices(nodesToBeUpdated);
+
   if (!nodesToDemolish.empty())
   {
     std::vector<Point> nodesToDemolishV(nodesToDemolish.size());
     std::transform(nodesToDemolish.begin(), nodesToDemolish.end(), nodesToDemolishV.begin(),
-                   [](MapNode *mn) { return mn->getCoordinates(); });
+                   [this](int index) { return mapNodes[index].getCoordinates(); });
     demolishNode(nodesToDemolishV);
   }
 
-  for (auto pNode : nodesToBeUpdated)
+  for (int index : nodesToBeUpdated)
   {
+    MapNode *pNode = &mapNodes[index];
     pNode->setAutotileBitMask(calculateAutotileBitmask(pNode, nodeCache[pNode]));
   }
 
-  for (auto pNode : nodesToBeUpdated)
+  for (int index : nodesToBeUpdated)
   {
-    pNode->updateTexture();
+    mapNodes[index].updateTexture();
+  }
+
+  // announce the new heights, the terrain tiles stay the same
+  for (int index : nodesToBeUpdated)
+  {
+    const MapNode *pNode = &mapNodes[index];
+    updateRoutingCost(*pNode);
+    const MapNodeData &terrain = pNode->getMapNodeDataForLayer(Layer::TERRAIN);
+    signalNodeChanged.emit(MapNodeChange{pNode->getCoordinates(), Layer::TERRAIN, terrain.tileData, terrain.tileData,
+                                         terrain.origCornerPoint, terrain.origCornerPoint});
+  }
+}
+
+void Map::takeNodeSnapshot(const MapNode &mapNode, NodeSnapshot &snapshot) const
+{
+  for (unsigned int layer = 0; layer < LAYERS_COUNT; ++layer)
+  {
+    const MapNodeData &mapNodeData = mapNode.getMapNodeDataForLayer(static_cast<Layer>(layer));
+    snapshot.tileData[layer] = mapNodeData.tileData;
+    snapshot.origCornerPoint[layer] = mapNodeData.origCornerPoint;
+  }
+}
+
+void Map::emitNodeChanges(const MapNode &mapNode, const NodeSnapshot &snapshot)
+{
+  updateRoutingCost(mapNode);
+
+  for (unsigned int layer = 0; layer < LAYERS_COUNT; ++layer)
+  {
+    const MapNodeData &mapNodeData = mapNode.getMapNodeDataForLayer(static_cast<Layer>(layer));
+
+    if (mapNodeData.tileData != snapshot.tileData[layer] ||
+        (mapNodeData.tileData && mapNodeData.origCornerPoint != snapshot.origCornerPoint[layer]))
+    {
+      signalNodeChanged.emit(MapNodeChange{mapNode.getCoordinates(), static_cast<Layer>(layer), snapshot.tileData[layer],
+                                           mapNodeData.tileData, snapshot.origCornerPoint[layer],
+                                           mapNodeData.origCornerPoint});
+    }
   }
 }
 
 void Map::updateAllNodes() { updateNodeNeighbors(mapNodesInDrawingOrder); }
 
-bool Map::isPlacementOnNodeAllowed(const Point &isoCoordinates, const std::string &tileID) const
+bool Map::isPlacementOnNodeAllowed(const Point &isoCoordinates, const std::string &tileID, bool demolishBuildings) const
 {
   if (TileManager::instance().getTileLayer(tileID) == Layer::ZONE)
   {
     return true;
   }
 
-  return mapNodes[nodeIdx(isoCoordinates.x, isoCoordinates.y)].isPlacementAllowed(tileID);
+  return mapNodes[nodeIdx(isoCoordinates.x, isoCoordinates.y)].isPlacementAllowed(tileID, demolishBuildings);
+}
+
+std::vector<Point> Map::getFillNodes(const Point &isoCoordinates, const std::string &tileID)
+{
+  auto isEligible = [this, &tileID](int x, int y) {
+    const MapNode &mapNode = mapNodes[nodeIdx(x, y)];
+    if (mapNode.getTileData(Layer::ROAD) || mapNode.getTileData(Layer::WATER) || mapNode.getTileData(Layer::BUILDINGS))
+    {
+      return false;
+    }
+    return tileID.empty() ? mapNode.getTileData(Layer::ZONE) != nullptr : isPlacementOnNodeAllowed(Point{x, y}, tileID);
+  };
+
+  std::vector<int> filledNodes;
+  m_floodFill.fill(isoCoordinates.x, isoCoordinates.y, isEligible, Settings::instance().maxFillArea, filledNodes);
+
+  std::vector<Point> nodes;
+  nodes.reserve(filledNodes.size());
+  for (int node : filledNodes)
+  {
+    nodes.push_back(Point{node / m_columns, node % m_columns});
+  }
+  return nodes;
+}
+
+std::vector<Point> Map::getRoadRoute(const Point &start, const Point &end, const std::string &tileID)
+{
+  if (m_routingCostsDirty || tileID != m_routingTileID)
+  {
+    updateRoutingCosts(tileID);
+  }
+
+  std::vector<Point> route;
+  m_roadRouter.findRoute(start, end, route);
+  return route;
+}
+
+void Map::updateRoutingCosts(const std::string &tileID)
+{
+  m_routingTileID = tileID;
+  m_routingCostsDirty = false;
+
+  for (const MapNode &mapNode : mapNodes)
+  {
+    updateRoutingCost(mapNode);
+  }
+}
+
+void Map::updateRoutingCost(const MapNode &mapNode)
+{
+  if (m_routingCostsDirty)
+  {
+    return;
+  }
+
+  const Point &coordinates = mapNode.getCoordinates();
+  const TileData *building = mapNode.getTileData(Layer::BUILDINGS);
+  int cost = 0;
+
+  if (building && building->category != "Flora" && !mapNode.getTileData(Layer::ROAD))
+  {
+    // the building only makes way if the road can be placed on the node once it is gone
+    cost = isPlacementOnNodeAllowed(coordinates, m_routingTileID, true) ? RoadRouter::DemolishCost : RoadRouter::BLOCKED;
+  }
+  else if (!isPlacementOnNodeAllowed(coordinates, m_routingTileID))
+  {
+    cost = RoadRouter::BLOCKED;
+  }
+  else if (mapNode.getTileData(Layer::WATER))
+  {
+    cost = RoadRouter::WaterCost;
+  }
+
+  m_roadRouter.setCost(coordinates.x, coordinates.y, cost);
+  m_roadRouter.setHeight(coordinates.x, coordinates.y, coordinates.height);
 }
 
 std::vector<Point> Map::getObjectCoords(const Point &isoCoordinates, const std::string &tileID)
@@ -504,7 +635,7 @@ Point Map::findNodeInMap(const SDL_Point &screenCoordinates, const Layer &layer)
 
 void Map::demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeighboringTiles, Layer layer)
 {
-  std::unordered_set<MapNode *> nodesToDemolish;
+  std::vector<int> nodesToDemolish;
 
   for (auto &isoCoord : isoCoordinates)
   {
@@ -529,19 +660,25 @@ void Map::demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeig
 
           for (auto coords : objectCoordinates)
           {
-            nodesToDemolish.insert(&mapNodes[nodeIdx(coords.x, coords.y)]);
+            nodesToDemolish.push_back(nodeIdx(coords.x, coords.y));
           }
         }
       }
 
-      nodesToDemolish.insert(&node);
+      nodesToDemolish.push_back(nodeIdx(isoCoord.x, isoCoord.y));
     }
   }
 
+  // demolish in the order of the nodes, so the changes are emitted in the same order in every replay
+  sortNodeIndices(nodesToDemolish);
   std::vector<MapNode *> updateNodes;
-  for (auto pNode : nodesToDemolish)
+  NodeSnapshot snapshot;
+  for (int index : nodesToDemolish)
   {
+    MapNode *pNode = &mapNodes[index];
+    takeNodeSnapshot(*pNode, snapshot);
     pNode->demolishNode(layer);
+    emitNodeChanges(*pNode, snapshot);
     // TODO: Play sound effect here
     if (updateNeighboringTiles)
     {
@@ -555,6 +692,33 @@ void Map::demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeig
   }
 }
 
+void Map::applyCommand(const MapCommand &command)
+{
+  switch (command.type)
+  {
+  case MapCommand::PLACE:
+  case MapCommand::PLACE_OBJECT:
+    setTileIDOfNode(command.nodes.begin(), command.nodes.end(), command.tileID, command.type == MapCommand::PLACE);
+    break;
+  case MapCommand::DEMOLISH:
+    demolishNode(command.nodes, command.updateNeighbors, command.layer);
+    break;
+  case MapCommand::RAISE_TERRAIN:
+  case MapCommand::LOWER_TERRAIN:
+    for (const Point &node : command.nodes)
+    {
+      changeHeight(node, command.type == MapCommand::RAISE_TERRAIN);
+    }
+    break;
+  case MapCommand::CAMERA:
+  case MapCommand::SPEED:
+  case MapCommand::ADD_LINE:
+  case MapCommand::REMOVE_LINE:
+    // don't change the map, transit lines belong to the simulation
+    break;
+  }
+}
+
 bool Map::isClickWithinTile(const SDL_Point &screenCoordinates, int isoX, int isoY, const Layer &layer = Layer::NONE) const
 {
   if (!isPointWithinMapBoundaries(isoX, isoY))
@@ -647,11 +811,14 @@ void Map::unHighlightNode(const Point &isoCoordinates)
   }
 }
 
-void Map::saveMapToFile(const std::string &fileName)
+void Map::saveMapToFile(const std::string &fileName, const std::vector<uint8_t> &simulationData)
 {
   //create savegame json string
-  const json j =
-      json{{"Savegame version", SAVEGAME_VERSION}, {"columns", this->m_columns}, {"rows", this->m_rows}, {"mapNode", mapNodes}};
+  const json j = json{{"Savegame version", SAVEGAME_VERSION},
+                      {"columns", this->m_columns},
+                      {"rows", this->m_rows},
+                      {"mapNode", mapNodes},
+                      {"simulation", simulationData}};
 
 #ifdef DEBUG
   // Write uncompressed savegame for easier debugging
@@ -666,7 +833,7 @@ void Map::saveMapToFile(const std::string &fileName)
   }
 }
 
-Map *Map::loadMapFromFile(const std::string &fileName)
+Map *Map::loadMapFromFile(const std::string &fileName, std::vector<uint8_t> *simulationData)
 {
   std::string jsonAsString = decompressString(fs::readFileAsString(fileName, true));
 
@@ -716,6 +883,11 @@ Map *Map::loadMapFromFile(const std::string &fileName)
 
   map->updateAllNodes();
 
+  if (simulationData)
+  {
+    *simulationData = saveGameJSON.value("simulation", std::vector<uint8_t>{});
+  }
+
   return map;
 }
 
@@ -762,11 +934,11 @@ void Map::calculateVisibleMap(void)
   const Point bottomRight = calculateIsoCoordinates({m_Window->getBounds().width(), m_Window->getBounds().height()});
 
   // Screen edges
-  const int left = topLeft.x + topLeft.y - 2;
-  const int right = bottomRight.x + bottomRight.y + 1;
-  const int top = topLeft.y - topLeft.x + 1;
+  m_visibleLeft = topLeft.x + topLeft.y - 2;
+  m_visibleRight = bottomRight.x + bottomRight.y + 1;
+  m_visibleTop = topLeft.y - topLeft.x + 1;
   // Lower the bottom because of high terrain nodes under the screen which will be pushed into the view
-  const int bottom = bottomRight.y - bottomRight.x - 1 - MapNode::maxHeight;
+  m_visibleBottom = bottomRight.y - bottomRight.x - 1 - MapNode::maxHeight;
 
   m_visibleNodesCount = 0;
 
@@ -774,10 +946,7 @@ void Map::calculateVisibleMap(void)
   {
     for (int y = m_columns - 1; y >= 0; y--)
     {
-      const int xVal = x + y;
-      const int yVal = y - x;
-
-      if ((xVal >= left) && (xVal <= right) && (yVal <= top) && (yVal >= bottom))
+      if (isNodeVisible(Point{x, y, 0, 0}))
       {
         pMapNodesVisible[m_visibleNodesCount++] = mapNodes[nodeIdx(x, y)].getSprite();
       }
@@ -6,6 +6,9 @@
 
 #include "GameObjects/MapNode.hxx"
 #include "map/TerrainGenerator.hxx"
+#include "map/RoadRouter.hxx"
+#include "basics/signal.hxx"
+#include "FloodFill.hxx"
 
 /** \brief Position of the surrounding nodes and its bit mask values.
   */
@@ -18,10 +21,28 @@ struct NeighborNode
   NeighbourNodesPosition position;
 };
 
+struct MapCommand;
+
+/** \brief Describes the change of a single layer of a map node.
+  * Emitted by the Map whenever tiles are placed or demolished, so simulation systems can update incrementally.
+  */
+struct MapNodeChange
+{
+  Point isoCoordinates;
+  Layer layer;
+  const TileData *oldTileData;
+  const TileData *newTileData;
+  Point oldOrigCornerPoint; /// origin of the multi-node object that has been removed
+  Point newOrigCornerPoint; /// origin of the multi-node object that has been placed
+};
+
 class Map
 {
 public:
-  Map(int columns, int rows, const bool generateTerrain = true);
+  /**
+   * @param terrainSeed the seed of the generated terrain, 0 for a random terrain.
+   */
+  Map(int columns, int rows, const bool generateTerrain = true, int terrainSeed = 0);
   ~Map();
   Map(Map &other) = delete;
   Map &operator=(const Map &other) = delete;
@@ -94,6 +115,7 @@ public:
     }
 
     int groundtileIndex = -1;
+    NodeSnapshot snapshot;
     for (auto it = begin; it != end; ++it)
     {
       const bool shouldRender = !(!isMultiObjects && (it != begin));
@@ -111,6 +133,8 @@ public:
         demolishNode(std::vector<Point>{*it}, 0, Layer::BUILDINGS);
       }
 
+      // take the snapshot after demolishing, the demolished tiles have already been announced
+      takeNodeSnapshot(currentMapNode, snapshot);
       currentMapNode.setRenderFlag(layer, shouldRender);
       currentMapNode.setTileID(tileID, isMultiObjects ? *it : *begin);
       auto pTileData = currentMapNode.getMapNodeDataForLayer(layer).tileData;
@@ -127,6 +151,8 @@ public:
         currentMapNode.setTileID(pTileData->groundDecoration[groundtileIndex], isMultiObjects ? *it : *begin);
       }
 
+      emitNodeChanges(currentMapNode, snapshot);
+
       //For layers that autotile to each other, we need to update their neighbors too
       if (MapNode::isDataAutoTile(TileManager::instance().getTileData(tileID)))
       {
@@ -150,6 +176,22 @@ public:
  */
   void demolishNode(const std::vector<Point> &isoCoordinates, bool updateNeighboringTiles = false, Layer layer = Layer::NONE);
 
+  /**
+   * @brief Execute an edit of the player.
+   * @see Engine#execute
+   */
+  void applyCommand(const MapCommand &command);
+
+  /**
+   * @brief Seed the random choices made while editing the map, like the ground decoration of placed tiles.
+   */
+  void setRandomSeed(uint32_t seed) { randomEngine.seed(seed); };
+
+  /**
+   * @brief Get the seed the terrain of the map has been generated with.
+   */
+  int getTerrainSeed() const { return m_terrainGen.getSeed(); };
+
   /**
    * @brief Refresh all the map tile textures
    *
@@ -157,6 +199,17 @@ public:
    */
   void refresh();
 
+  /** \brief Check if a node is inside the visible part of the map
+  * The visible area is updated by refresh().
+  * @param isoCoordinates the node to check.
+  */
+  bool isNodeVisible(const Point &isoCoordinates) const
+  {
+    const int xVal = isoCoordinates.x + isoCoordinates.y;
+    const int yVal = isoCoordinates.y - isoCoordinates.x;
+    return (xVal >= m_visibleLeft) && (xVal <= m_visibleRight) && (yVal <= m_visibleTop) && (yVal >= m_visibleBottom);
+  };
+
   /**
    * @brief Get original corner point of given point within building borders.
    */
@@ -165,15 +218,17 @@ public:
   /** \Brief Save Map to file
   * Serializes the Map class to json and writes the data to a file.
   * @param fileName The file the map should be written to
+  * @param simulationData Serialized state of the simulation that is stored along with the map
   */
-  void saveMapToFile(const std::string &fileName);
+  void saveMapToFile(const std::string &fileName, const std::vector<uint8_t> &simulationData = {});
 
   /** \Brief Load Map from file
   * Deserializes the Map class from a json file, creates a new Map and returns it.
   * @param fileName The file the map should be written to
+  * @param simulationData If not nullptr, receives the serialized state of the simulation. Empty for older savegames.
   * @returns Map* Pointer to the newly created Map.
   */
-  static Map *loadMapFromFile(const std::string &fileName);
+  static Map *loadMapFromFile(const std::string &fileName, std::vector<uint8_t> *simulationData = nullptr);
 
   /**
  * @brief Debug MapNodeData to Console
@@ -185,8 +240,27 @@ public:
   /** \Brief check if Tile is occupied
   * @param isoCoordinates Tile to inspect
   * @param tileID tileID which should be checked
+  * @param demolishBuildings whether the buildings on the tile are demolished before a road is placed
+  */
+  bool isPlacementOnNodeAllowed(const Point &isoCoordinates, const std::string &tileID, bool demolishBuildings = false) const;
+
+  /** \brief Get the connected area around a node for the fill tool.
+  * The area is bounded by roads, water and buildings and limited to Settings::maxFillArea nodes.
+  * @param isoCoordinates the node the fill starts at.
+  * @param tileID the zone that should be placed, or an empty string to get the zoned area for demolishing.
+  * @return the nodes of the area, empty if the start node can't be filled.
+  */
+  std::vector<Point> getFillNodes(const Point &isoCoordinates, const std::string &tileID);
+
+  /** \brief Propose a route for a new road between two nodes.
+  * The route avoids slopes, water and buildings where possible, buildings on the route have to be demolished before the
+  * road can be placed.
+  * @param start the first node of the road.
+  * @param end the last node of the road.
+  * @param tileID the road that should be placed.
+  * @return the nodes of the route, empty if there is no route.
   */
-  bool isPlacementOnNodeAllowed(const Point &isoCoordinates, const std::string &tileID) const;
+  std::vector<Point> getRoadRoute(const Point &start, const Point &end, const std::string &tileID);
 
   /** \brief Return vector of Points of an Object Tiles selection.
   *
@@ -204,6 +278,21 @@ public:
   */
   const MapNode *getMapNode(Point isoCoords) const { return &mapNodes[nodeIdx(isoCoords.x, isoCoords.y)]; };
 
+  /** \brief Get the number of columns of the map.
+  */
+  int getColumns() const { return m_columns; };
+
+  /** \brief Get the number of rows of the map.
+  */
+  int getRows() const { return m_rows; };
+
+  /** \brief Signal that is emitted for every layer of a map node that changed.
+  * Emitted from setTileIDOfNode and demolishNode, after the node has been updated.
+  * Height changes are emitted for the terrain layer with unchanged tile data.
+  * @see MapNodeChange
+  */
+  Signal::Signal<void(const MapNodeChange &)> signalNodeChanged;
+
   /**
    * @brief Sets the Window
    * @todo  Remove this when the New UI is complete
@@ -211,6 +300,26 @@ public:
   static void setWindow(class Window *);
 
 private:
+  /**\brief Tile data and origin of all layers of a node, used to detect changes.
+  */
+  struct NodeSnapshot
+  {
+    const TileData *tileData[LAYERS_COUNT];
+    Point origCornerPoint[LAYERS_COUNT];
+  };
+
+  /** \brief Store the tile data of all layers of a node.
+  * @param mapNode the node to take the snapshot of.
+  * @param snapshot the snapshot to fill.
+  */
+  void takeNodeSnapshot(const MapNode &mapNode, NodeSnapshot &snapshot) const;
+
+  /** \brief Emit signalNodeChanged for all layers of the node that differ from the snapshot.
+  * @param mapNode the node that might have changed.
+  * @param snapshot the snapshot taken before the node was changed.
+  */
+  void emitNodeChanges(const MapNode &mapNode, const NodeSnapshot &snapshot);
+
   /**\brief Update all mapNodes
   * Updates all mapNode and its adjacent tiles regarding height information, draws slopes for adjacent tiles and
   * sets tiling for mapNode sprite if applicable
@@ -278,6 +387,18 @@ private:
   */
   bool updateHeight(MapNode &mapNode, const bool higher, std::vector<NeighborNode> &neighbors);
 
+  /* \brief Update the costs of the road router for placing the given road on each node.
+  */
+  void updateRoutingCosts(const std::string &tileID);
+
+  /* \brief Update the routing cost of a changed node, if the costs have been computed.
+  */
+  void updateRoutingCost(const MapNode &mapNode);
+
+  /* \brief Sort node indices and remove the duplicates.
+  */
+  static void sortNodeIndices(std::vector<int> &indices);
+
   /* \brief For implementing frustum culling, find all map nodes which are visible on the screen. Only visible nodes will be rendered.
   */
   void calculateVisibleMap(void);
@@ -286,10 +407,21 @@ private:
   std::vector<MapNode *> mapNodesInDrawingOrder;
   Sprite **pMapNodesVisible;
   int m_visibleNodesCount = 0;
+  /// bounds of the visible nodes in diagonal coordinates, see calculateVisibleMap
+  int m_visibleLeft = 0;
+  int m_visibleRight = -1;
+  int m_visibleTop = -1;
+  int m_visibleBottom = 0;
   int m_columns;
   int m_rows;
   std::default_random_engine randomEngine;
   TerrainGenerator m_terrainGen;
+  FloodFill m_floodFill;
+  RoadRouter m_roadRouter;
+  /// the road the routing costs have been computed for, changed nodes update their cost right away
+  std::string m_routingTileID;
+  /// true until the routing costs have been computed for the first time
+  bool m_routingCostsDirty = true;
   static class Window * m_Window;
   static const size_t m_saveGameVersion;
 };
@@ -15,6 +15,8 @@
 #include "microprofile.h"
 #endif
 
+Uint32 Sprite::m_animationTime = 0;
+
 Sprite::Sprite(Point _isoCoordinates) : isoCoordinates(_isoCoordinates)
 {
   m_screenCoordinates = convertIsoToScreenCoordinates(_isoCoordinates);
@@ -44,7 +46,17 @@ void Sprite::render() const
         SDL_SetTextureAlphaMod(m_SpriteData[currentLayer].texture, m_SpriteData[currentLayer].alpha);
       }
 
-      if (m_SpriteData[currentLayer].clipRect.w != 0)
+      if (m_SpriteData[currentLayer].animation && m_SpriteData[currentLayer].clipRect.w != 0)
+      {
+        const SpriteAnimation &animation = *m_SpriteData[currentLayer].animation;
+        const size_t frame =
+            (m_animationTime / animation.frameDuration + m_SpriteData[currentLayer].animationPhase) % animation.frameOffset.size();
+        SDL_Rect clipRect = m_SpriteData[currentLayer].clipRect;
+        clipRect.x += animation.frameOffset[frame];
+        SDL_RenderCopy(WindowManager::instance().getRenderer(), m_SpriteData[currentLayer].texture, &clipRect,
+                       &m_SpriteData[currentLayer].destRect);
+      }
+      else if (m_SpriteData[currentLayer].clipRect.w != 0)
       {
         SDL_RenderCopy(WindowManager::instance().getRenderer(), m_SpriteData[currentLayer].texture,
                        &m_SpriteData[currentLayer].clipRect, &m_SpriteData[currentLayer].destRect);
@@ -134,6 +146,13 @@ void Sprite::setTexture(SDL_Texture *texture, Layer layer)
 void Sprite::setClipRect(SDL_Rect clipRect, const Layer layer) { m_SpriteData[layer].clipRect = clipRect; }
 void Sprite::setDestRect(SDL_Rect destRect, Layer layer) { m_SpriteData[layer].destRect = destRect; }
 
+void Sprite::setAnimation(const SpriteAnimation *animation, Layer layer)
+{
+  m_SpriteData[layer].animation = animation;
+  // derive the phase from the coordinates, so it stays the same across refreshes
+  m_SpriteData[layer].animationPhase = static_cast<unsigned int>(isoCoordinates.x * 7 + isoCoordinates.y * 13);
+}
+
 SDL_Rect Sprite::getActiveClipRect()
 {
   if (MapLayers::isLayerActive(Layer::BUILDINGS) && m_SpriteData[Layer::BUILDINGS].clipRect.w != 0 &&
@@ -171,4 +190,5 @@ void Sprite::clearSprite(Layer layer)
   m_SpriteData[layer].clipRect = {0, 0, 0, 0};
   m_SpriteData[layer].destRect = {0, 0, 0, 0};
   m_SpriteData[layer].texture = nullptr;
+  m_SpriteData[layer].animation = nullptr;
 }
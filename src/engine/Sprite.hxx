@@ -7,12 +7,21 @@
 #include "basics/point.hxx"
 #include "common/enums.hxx"
 
+/// Frames of an animated sprite, all frames have the same size as the clipRect of the sprite
+struct SpriteAnimation
+{
+  std::vector<int> frameOffset; /// x offset of each frame from the clipRect chosen for the sprite
+  Uint32 frameDuration = 1000; /// duration of a frame in milliseconds
+};
+
 struct SpriteData
 {
   SDL_Texture *texture = nullptr;
   SDL_Rect clipRect{0, 0, 0, 0};
   SDL_Rect destRect{0, 0, 0, 0};
   unsigned char alpha = 255;
+  const SpriteAnimation *animation = nullptr;
+  unsigned int animationPhase = 0; /// frame offset, so neighboring sprites don't animate in lockstep
 };
 
 struct SpriteRGBColor
@@ -42,6 +51,19 @@ public:
   void setClipRect(SDL_Rect clipRect, Layer layer = Layer::TERRAIN);
   void setDestRect(SDL_Rect clipRect, Layer layer = Layer::TERRAIN);
 
+  /** @brief Animate the sprite of a layer.
+    * The frame is picked from the animation clock when the sprite is rendered, so sprites that are not visible cost
+    * nothing.
+    * @param animation the frames, or nullptr to show the clipRect only.
+    */
+  void setAnimation(const SpriteAnimation *animation, Layer layer = Layer::TERRAIN);
+
+  /** @brief Set the time of the animation clock, shared by all sprites.
+    * Should be called once per frame, before the sprites are rendered.
+    * @param milliseconds elapsed time since the start of the game.
+    */
+  static void setAnimationTime(Uint32 milliseconds) { m_animationTime = milliseconds; };
+
   void clearSprite(Layer layer);
 
   size_t spriteCount = 1;
@@ -58,6 +80,8 @@ public:
   Point isoCoordinates{0, 0, 0, 0};
 
 private:
+  static Uint32 m_animationTime;
+
   SDL_Point m_screenCoordinates{0, 0};
 
   bool m_needsRefresh = false;
@@ -7,6 +7,8 @@
 #include "Filesystem.hxx"
 
 #include <bitset>
+#include <algorithm>
+#include <numeric>
 
 using json = nlohmann::json;
 
@@ -289,10 +291,156 @@ void TileManager::init()
     addJSONObjectToTileData(tileDataJSON, idx, id);
     idx++;
   }
+
+  buildRCISpawnTables();
+  buildAnimations();
+}
+
+const SpriteAnimation *TileManager::getAnimation(const std::string &tileID) const
+{
+  auto it = m_animations.find(tileID);
+  return it == m_animations.end() ? nullptr : &it->second;
+}
+
+void TileManager::buildAnimations()
+{
+  m_animations.clear();
+
+  for (const auto &[tileID, tileData] : m_tileData)
+  {
+    SpriteAnimation animation;
+    if (buildAnimation(tileData, animation))
+    {
+      m_animations[tileID] = std::move(animation);
+    }
+    else if (tileData.tiles.fps > 0 && tileData.tiles.count > 1)
+    {
+      LOG(LOG_WARNING) << "Tile " << tileID << " picks its image by its orientation and can't be animated";
+    }
+  }
+}
+
+bool TileManager::buildAnimation(const TileData &tileData, SpriteAnimation &animation)
+{
+  const TileSetData &tiles = tileData.tiles;
+  if (tiles.fps <= 0 || tiles.count <= 1)
+  {
+    return false;
+  }
+  switch (tileData.tileType)
+  {
+  case TileType::TERRAIN:
+  case TileType::WATER:
+  case TileType::AUTOTILE:
+  case TileType::ROAD:
+  case TileType::UNDERGROUND:
+    return false;
+  default:
+    break;
+  }
+
+  animation.frameDuration = std::max(1000u / static_cast<Uint32>(tiles.fps), 1u);
+  animation.frameOffset.clear();
+  for (int frame = 0; frame < tiles.count; ++frame)
+  {
+    animation.frameOffset.push_back(frame * tiles.clippingWidth);
+  }
+  return true;
+}
+
+size_t TileManager::getRCISpawnTableIndex(Zones zone, Wealth wealth, Style style)
+{
+  return (zone._to_index() * Wealth::_size() + wealth._to_index()) * Style::_size() + style._to_index();
+}
+
+void TileManager::buildRCISpawnTables()
+{
+  for (auto &table : m_rciSpawnTables)
+  {
+    table.footprints.clear();
+    table.tileIDs.clear();
+  }
+
+  for (const auto &[id, tileData] : m_tileData)
+  {
+    if (tileData.tileType != +TileType::RCI)
+    {
+      continue;
+    }
+
+    // tiles without wealth or style restrictions can spawn with every wealth / style
+    std::vector<Wealth> wealths = tileData.wealth;
+    if (wealths.empty())
+    {
+      wealths.assign(Wealth::_values().begin(), Wealth::_values().end());
+    }
+    std::vector<Style> styles = tileData.style;
+    if (styles.empty())
+    {
+      styles.assign(Style::_values().begin(), Style::_values().end());
+    }
+
+    for (Zones zone : tileData.zones)
+    {
+      for (Wealth wealth : wealths)
+      {
+        for (Style style : styles)
+        {
+          RCISpawnTable &table = m_rciSpawnTables[getRCISpawnTableIndex(zone, wealth, style)];
+          const RequiredTilesData &footprint = tileData.RequiredTiles;
+          auto it = std::find_if(table.footprints.begin(), table.footprints.end(), [&footprint](const RequiredTilesData &f) {
+            return f.width == footprint.width && f.height == footprint.height;
+          });
+
+          if (it == table.footprints.end())
+          {
+            table.footprints.push_back(footprint);
+            table.tileIDs.emplace_back();
+            it = table.footprints.end() - 1;
+          }
+          table.tileIDs[it - table.footprints.begin()].push_back(id);
+        }
+      }
+    }
+  }
+
+  for (auto &table : m_rciSpawnTables)
+  {
+    // order footprints from biggest to smallest area, and the tileIDs so the result doesn't depend on the hash map order
+    std::vector<size_t> order(table.footprints.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&table](size_t a, size_t b) {
+      const RequiredTilesData &fa = table.footprints[a];
+      const RequiredTilesData &fb = table.footprints[b];
+      return (fa.width * fa.height != fb.width * fb.height) ? (fa.width * fa.height > fb.width * fb.height)
+                                                            : (fa.width != fb.width ? fa.width > fb.width : fa.height > fb.height);
+    });
+
+    RCISpawnTable sortedTable;
+    for (size_t i : order)
+    {
+      sortedTable.footprints.push_back(table.footprints[i]);
+      sortedTable.tileIDs.push_back(std::move(table.tileIDs[i]));
+      std::sort(sortedTable.tileIDs.back().begin(), sortedTable.tileIDs.back().end());
+    }
+    table = std::move(sortedTable);
+  }
+}
+
+const std::vector<RequiredTilesData> &TileManager::getRCISpawnFootprints(Zones zone, Wealth wealth, Style style) const
+{
+  return m_rciSpawnTables[getRCISpawnTableIndex(zone, wealth, style)].footprints;
+}
+
+const std::vector<std::string> &TileManager::getRCISpawnCandidates(Zones zone, Wealth wealth, Style style,
+                                                                   size_t footprintIndex) const
+{
+  return m_rciSpawnTables[getRCISpawnTableIndex(zone, wealth, style)].tileIDs.at(footprintIndex);
 }
 
 void TileManager::addJSONObjectToTileData(const nlohmann::json &tileDataJSON, size_t idx, const std::string &id)
 {
+  m_tileData[id].id = id;
   m_tileData[id].author = tileDataJSON[idx].value("author", "");
   m_tileData[id].title = tileDataJSON[idx].value("title", "");
   m_tileData[id].description = tileDataJSON[idx].value("description", "");
@@ -427,7 +575,10 @@ void TileManager::addJSONObjectToTileData(const nlohmann::json &tileDataJSON, si
   }
   m_tileData[id].tiles.offset = offset;
   m_tileData[id].tiles.count = tileDataJSON[idx]["tiles"].value("count", 1);
-  m_tileData[id].tiles.pickRandomTile = tileDataJSON[idx]["tiles"].value("pickRandomTile", true);
+  m_tileData[id].tiles.fps = std::max(tileDataJSON[idx]["tiles"].value("fps", 0), 0);
+  // the frames of an animation are ordered, so a random image must not be picked
+  m_tileData[id].tiles.pickRandomTile =
+      m_tileData[id].tiles.fps == 0 && tileDataJSON[idx]["tiles"].value("pickRandomTile", true);
 
   if (!m_tileData[id].tiles.fileName.empty())
   {
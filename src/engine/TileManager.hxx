@@ -4,10 +4,13 @@
 #include <SDL.h>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <array>
 
 #include "tileData.hxx"
 #include "json.hxx"
 #include "Singleton.hxx"
+#include "Sprite.hxx"
 #include "../common/enums.hxx"
 
 enum TileMap : size_t
@@ -76,12 +79,59 @@ public:
   const std::unordered_map<std::string, TileData> &getAllTileData() const { return m_tileData; };
   void init();
 
+  /** @brief Get all footprints of RCI tiles that can spawn with the given properties.
+    * @param zone the zone the tile should spawn on.
+    * @param wealth the wealth level of the tile.
+    * @param style the art style of the tile.
+    * @return the footprints, ordered from the biggest to the smallest area.
+    */
+  const std::vector<RequiredTilesData> &getRCISpawnFootprints(Zones zone, Wealth wealth, Style style) const;
+
+  /** @brief Get all RCI tiles that can spawn with the given properties.
+    * The spawn tables are built once during init(), so lookups never filter the tile definitions.
+    * @param zone the zone the tile should spawn on.
+    * @param wealth the wealth level of the tile.
+    * @param style the art style of the tile.
+    * @param footprintIndex index into the footprints returned by getRCISpawnFootprints().
+    * @return tileIDs of all matching tiles.
+    */
+  const std::vector<std::string> &getRCISpawnCandidates(Zones zone, Wealth wealth, Style style, size_t footprintIndex) const;
+
+  /** @brief Get the frames of an animated tile.
+    * The frames are built once during init() from the tile definitions with a frame rate.
+    * @return the animation or nullptr if the tile is not animated.
+    */
+  const SpriteAnimation *getAnimation(const std::string &tileID) const;
+
+  /** @brief Build the frames of a tile with a frame rate.
+    * The first image of the tileset is the clipRect of the sprite, the frames follow it in the spritesheet.
+    * Tiles that choose their image by their orientation can't be animated, their images are the orientations.
+    * @param tileData the tile.
+    * @param animation receives the frames.
+    * @return false if the tile is not animated.
+    */
+  static bool buildAnimation(const TileData &tileData, SpriteAnimation &animation);
+
 private:
   TileManager();
   ~TileManager();
 
+  /// All RCI tiles for one combination of zone, wealth and style, grouped by their footprint
+  struct RCISpawnTable
+  {
+    std::vector<RequiredTilesData> footprints;
+    std::vector<std::vector<std::string>> tileIDs;
+  };
+
+  static constexpr size_t RCI_SPAWN_TABLE_COUNT = Zones::_size() * Wealth::_size() * Style::_size();
+
   std::unordered_map<std::string, TileData> m_tileData;
+  std::array<RCISpawnTable, RCI_SPAWN_TABLE_COUNT> m_rciSpawnTables;
+  std::unordered_map<std::string, SpriteAnimation> m_animations;
   void addJSONObjectToTileData(const nlohmann::json &tileDataJSON, size_t idx, const std::string &id);
+  void buildRCISpawnTables();
+  void buildAnimations();
+  static size_t getRCISpawnTableIndex(Zones zone, Wealth wealth, Style style);
 };
 
 #endif
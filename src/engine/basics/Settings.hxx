@@ -34,6 +34,23 @@ struct SettingsData
    */
   int maxElevationHeight;
 
+  /**
+   * @brief the maximum number of nodes the fill tool zones at once
+   */
+  size_t maxFillArea;
+
+  /**
+   * @brief File the commands of the session are written to when the game ends, nothing is recorded if empty
+   * @details Only set from the command line, e.g. --Game.RecordCommands session.ctcl
+   */
+  std::string recordCommands;
+
+  /**
+   * @brief File of recorded commands that are replayed without rendering instead of starting the game
+   * @details Only set from the command line, e.g. --Game.ReplayCommands session.ctcl
+   */
+  std::string replayCommands;
+
   /**
   * @brief the value of the zone layer transparency, (0 - 1.0).
   * where 0 is full opaque and 1 for full transparency.
@@ -78,6 +78,8 @@ struct TileSetData
   int offset =
       0; /// offset is where the first image in this tileset is, so a file could contain multiple tilesets and offset would define where to start this tileset and count would define how many images it has. offset = 0 is the first image, offset = 3 is the 4th tile.
   bool pickRandomTile = false; // determines if a random tile of the tileset should be used, if set to true
+  int fps =
+      0; /// frames per second if the images of this tileset are the frames of an animation, 0 for static tiles. The count images from offset on are played in order and none is picked at random. Only tiles that don't pick their image by orientation (terrain, water, roads, autotiles, underground) can be animated.
   int rotations =
       1; /// rotations is the number of rotations that exist in this tileset (for buildings).  this is not applicable for terrain and roads, their orientation is figured out differently. For buildings that have multiple orientations, this isn't implemented yet but it prevents buildings with multiple orientations from being placed with  a random image (that might be the wrong size).
 };
@@ -118,7 +120,7 @@ struct TileData
       groundDecoration; /// tileID of the item that should be drawn on ground below sprite instead of terrain(grass, concrete, ...). Must be a tileID with tileType GroundDecoration
   bool placeOnGround = true;     /// wether or not this building is placeable on ground
   bool placeOnWater = false;     /// whether or not this building is placeable on water
-  bool isOverPlacable;           /// Determines if other tiles can be placed over this one tile.
+  bool isOverPlacable = false;   /// Determines if other tiles can be placed over this one tile.
   int pollutionLevel = 0;        /// Pollution this building produces or prevents
   int crimeLevel = 0;            /// Crime this building produces or prevents (police station)
   int fireHazardLevel = 0;       /// Fire Danger this building produces or prevents
@@ -55,6 +55,9 @@ inline void from_json(const json &j, SettingsData &s)
   s.mapSize = j.value("/Game/MapSize"_json_pointer, 64);
   s.biome = j.value("/Game/Biome"_json_pointer, "GrassLands");
   s.maxElevationHeight = j.value("/Game/MaxElevationHeight"_json_pointer, 32);
+  s.maxFillArea = j.value("/Game/MaxFillArea"_json_pointer, 65536);
+  s.recordCommands = j.value("/Game/RecordCommands"_json_pointer, "");
+  s.replayCommands = j.value("/Game/ReplayCommands"_json_pointer, "");
   s.zoneLayerTransparency = j.value("/Game/ZoneLayerTransperancy"_json_pointer, 0.5f);
   s.showBuildingsInBlueprint = j.value("/Game/ShowBuildingsInBluePrint"_json_pointer, false);
   s.gameLanguage = j.value("/Game/Language"_json_pointer, "en");
@@ -295,6 +298,8 @@ inline void to_json(json &j, const SettingsData &s)
   j["/Game/MapSize"_json_pointer] = s.mapSize;
   j["/Game/Biome"_json_pointer] = s.biome;
   j["/Game/MaxElevationHeight"_json_pointer] = s.maxElevationHeight;
+  j["/Game/MaxFillArea"_json_pointer] = s.maxFillArea;
+  // RecordCommands and ReplayCommands are not saved, they are only meant for the current run
   j["/Game/ZoneLayerTransperancy"_json_pointer] = s.zoneLayerTransparency;
   j["/Game/ShowBuildingsInBluePrint"_json_pointer] = s.showBuildingsInBlueprint;
   j["/Game/Language"_json_pointer] = s.gameLanguage;
@@ -43,7 +43,9 @@ enum class PlacementMode
   SINGLE,        /// Place tiles on a single spot
   STRAIGHT_LINE, /// Place tiles in a straight, rectangular line
   LINE,          /// Place tiles in a line from start to end point
-  RECTANGLE      /// draw a rectangle between start and end point
+  RECTANGLE,     /// draw a rectangle between start and end point
+  FILL,          /// Fill the connected area around the node, bounded by roads, water and buildings
+  ROUTE          /// Find the best route for a road between start and end point
 };
 
 enum class DemolishMode
@@ -0,0 +1,114 @@
+#include "RoadRouter.hxx"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+#include <tuple>
+
+namespace
+{
+/// estimated total cost, estimated remaining cost and node; ties prefer nodes closer to the end
+using QueueItem = std::tuple<int, int, int>;
+using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+} // namespace
+
+RoadRouter::RoadRouter(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_cost(columns * rows, 0), m_height(columns * rows, 0),
+      m_distance(columns * rows, 0), m_previous(columns * rows, -1), m_stamp(columns * rows, 0)
+{
+}
+
+bool RoadRouter::findRoute(const Point &start, const Point &end, std::vector<Point> &route)
+{
+  route.clear();
+  m_routeCost = 0;
+
+  auto isInside = [this](const Point &point) {
+    return point.x >= 0 && point.x < m_rows && point.y >= 0 && point.y < m_columns;
+  };
+  if (!isInside(start) || !isInside(end))
+  {
+    return false;
+  }
+
+  const int startNode = nodeIdx(start.x, start.y);
+  const int endNode = nodeIdx(end.x, end.y);
+  if (m_cost[startNode] == BLOCKED || m_cost[endNode] == BLOCKED)
+  {
+    return false;
+  }
+
+  m_currentStamp++;
+  MinQueue queue;
+  auto estimate = [&end](int x, int y) { return (std::abs(x - end.x) + std::abs(y - end.y)) * StepCost; };
+
+  m_stamp[startNode] = m_currentStamp;
+  m_distance[startNode] = 0;
+  m_previous[startNode] = -1;
+  queue.push({estimate(start.x, start.y), estimate(start.x, start.y), startNode});
+
+  constexpr int offsetX[] = {-1, 1, 0, 0};
+  constexpr int offsetY[] = {0, 0, -1, 1};
+
+  while (!queue.empty())
+  {
+    const auto [total, remaining, node] = queue.top();
+    queue.pop();
+
+    const int distance = total - remaining;
+    if (distance > m_distance[node])
+    {
+      // outdated entry, the node has been reached on a cheaper path since
+      continue;
+    }
+    if (node == endNode)
+    {
+      break;
+    }
+
+    const int x = node / m_columns;
+    const int y = node % m_columns;
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int neighborX = x + offsetX[direction];
+      const int neighborY = y + offsetY[direction];
+      if (neighborX < 0 || neighborX >= m_rows || neighborY < 0 || neighborY >= m_columns)
+      {
+        continue;
+      }
+
+      const int neighbor = nodeIdx(neighborX, neighborY);
+      if (m_cost[neighbor] == BLOCKED)
+      {
+        continue;
+      }
+
+      const int neighborDistance =
+          distance + StepCost + m_cost[neighbor] + SlopeCost * std::abs(m_height[neighbor] - m_height[node]);
+      if (m_stamp[neighbor] == m_currentStamp && m_distance[neighbor] <= neighborDistance)
+      {
+        continue;
+      }
+
+      m_stamp[neighbor] = m_currentStamp;
+      m_distance[neighbor] = neighborDistance;
+      m_previous[neighbor] = node;
+      const int neighborEstimate = estimate(neighborX, neighborY);
+      queue.push({neighborDistance + neighborEstimate, neighborEstimate, neighbor});
+    }
+  }
+
+  if (m_stamp[endNode] != m_currentStamp)
+  {
+    return false;
+  }
+
+  for (int node = endNode; node != -1; node = m_previous[node])
+  {
+    route.push_back(Point{node / m_columns, node % m_columns});
+  }
+  std::reverse(route.begin(), route.end());
+  m_routeCost = m_distance[endNode];
+  return true;
+}
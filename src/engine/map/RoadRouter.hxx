@@ -0,0 +1,64 @@
+#ifndef ROAD_ROUTER_HXX_
+#define ROAD_ROUTER_HXX_
+
+#include <cstdint>
+#include <vector>
+
+#include "../basics/point.hxx"
+
+/** @brief Proposes a path for a new road between two nodes.
+  * Every node has a cost for building a road on it and a height. A step costs StepCost, the cost of the node that is
+  * entered and SlopeCost for each level of height difference, so the route avoids water crossings, demolitions and
+  * hills where possible. The path is found with A* over the cost grid, using the Manhattan distance as heuristic.
+  */
+class RoadRouter
+{
+public:
+  /// Cost of nodes that roads can't be built on
+  static constexpr int BLOCKED = -1;
+  /// Cost of moving to a neighboring node
+  static constexpr int StepCost = 10;
+  /// Cost of each level of height difference between two neighboring nodes
+  static constexpr int SlopeCost = 15;
+  /// Cost of entering a node with water, roads on water need bridges
+  static constexpr int WaterCost = 60;
+  /// Cost of entering a node with a building that needs to be demolished
+  static constexpr int DemolishCost = 100;
+
+  RoadRouter(int columns, int rows);
+
+  /** @brief Set the additional cost of building a road on a node.
+    * @param cost 0 or more, or BLOCKED.
+    */
+  void setCost(int x, int y, int cost) { m_cost[nodeIdx(x, y)] = cost; };
+  int getCost(int x, int y) const { return m_cost[nodeIdx(x, y)]; };
+
+  void setHeight(int x, int y, int height) { m_height[nodeIdx(x, y)] = static_cast<int16_t>(height); };
+
+  /** @brief Find the cheapest route between two nodes.
+    * @param route receives the nodes of the route, including start and end.
+    * @return whether a route exists.
+    */
+  bool findRoute(const Point &start, const Point &end, std::vector<Point> &route);
+
+  /** @brief Get the cost of the last route that has been found.
+    */
+  int getRouteCost() const { return m_routeCost; };
+
+private:
+  int m_columns;
+  int m_rows;
+  std::vector<int> m_cost;
+  std::vector<int16_t> m_height;
+  int m_routeCost = 0;
+
+  /// scratch data for A*, only valid for nodes with the current stamp
+  std::vector<int> m_distance;
+  std::vector<int> m_previous;
+  std::vector<unsigned int> m_stamp;
+  unsigned int m_currentStamp = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+};
+
+#endif
@@ -53,6 +53,14 @@ public:
 
   void loadTerrainDataFromJSON();
 
+  /** @brief Set the seed of the next terrain, 0 generates a random seed.
+    */
+  void setSeed(int seed) { m_terrainSettings.seed = seed; };
+
+  /** @brief Get the seed the terrain has been generated with.
+    */
+  int getSeed() const { return m_terrainSettings.seed; };
+
 private:
   TerrainSettings m_terrainSettings;
 
@@ -0,0 +1,143 @@
+#include "Budget.hxx"
+
+#include "CityStats.hxx"
+#include "Map.hxx"
+#include "ServiceCoverage.hxx"
+
+#include <algorithm>
+
+Budget::Budget() { m_taxRates.fill(DefaultTaxRate); }
+
+Budget::Category Budget::getUpkeepCategory(Layer layer, const TileData &tileData)
+{
+  // terrain and zones are not part of the city's infrastructure, like in the CityStats
+  if (layer == Layer::TERRAIN || layer == Layer::ZONE || layer == Layer::BLUEPRINT)
+  {
+    return CATEGORIES_COUNT;
+  }
+  if (layer == Layer::ROAD)
+  {
+    return ROADS;
+  }
+  if (layer == Layer::UNDERGROUND || tileData.water > 0)
+  {
+    return WATER;
+  }
+  if (tileData.power > 0 || (tileData.tileType == +TileType::AUTOTILE && tileData.category == "Power"))
+  {
+    return POWER;
+  }
+  if (ServiceCoverage::getService(tileData) != ServiceCoverage::SERVICES_COUNT)
+  {
+    return SERVICES;
+  }
+  return OTHER;
+}
+
+Budget::Category Budget::getTaxCategory(Layer layer, const TileData &tileData)
+{
+  if (layer != Layer::BUILDINGS || tileData.tileType != +TileType::RCI)
+  {
+    return CATEGORIES_COUNT;
+  }
+  if (CityStats::isResidential(tileData))
+  {
+    return RESIDENTIAL_TAX;
+  }
+  if (std::find(tileData.zones.begin(), tileData.zones.end(), +Zones::COMMERCIAL) != tileData.zones.end())
+  {
+    return COMMERCIAL_TAX;
+  }
+  return INDUSTRIAL_TAX;
+}
+
+void Budget::onNodeChanged(const MapNodeChange &change)
+{
+  const bool removed = change.oldTileData && change.isoCoordinates == change.oldOrigCornerPoint;
+  const bool added = change.newTileData && change.isoCoordinates == change.newOrigCornerPoint;
+
+  if (removed)
+  {
+    addTile(change.layer, *change.oldTileData, -1);
+  }
+  if (added)
+  {
+    addTile(change.layer, *change.newTileData, 1);
+  }
+
+  // updates of a tile, like the height of the terrain or the shape of a road, are free
+  if (m_editing && change.oldTileData != change.newTileData)
+  {
+    if (removed)
+    {
+      m_editCosts += change.oldTileData->price / DemolitionCostDivisor;
+    }
+    if (added)
+    {
+      m_editCosts += change.newTileData->price;
+    }
+  }
+}
+
+void Budget::addTile(Layer layer, const TileData &tileData, int sign)
+{
+  const Category upkeep = getUpkeepCategory(layer, tileData);
+  if (upkeep != CATEGORIES_COUNT)
+  {
+    m_totals[upkeep] += sign * tileData.upkeepCost;
+  }
+  const Category tax = getTaxCategory(layer, tileData);
+  if (tax != CATEGORIES_COUNT)
+  {
+    m_totals[tax] += sign * tileData.inhabitants;
+  }
+}
+
+void Budget::endEdit(uint32_t tick)
+{
+  m_editing = false;
+  if (m_editCosts != 0)
+  {
+    book(tick, CONSTRUCTION, -m_editCosts);
+    m_editCosts = 0;
+  }
+}
+
+void Budget::closeMonth(uint32_t tick)
+{
+  for (unsigned int category = ROADS; category <= OTHER; ++category)
+  {
+    if (m_totals[category] != 0)
+    {
+      book(tick, static_cast<Category>(category), -m_totals[category]);
+    }
+  }
+  for (unsigned int category = RESIDENTIAL_TAX; category <= INDUSTRIAL_TAX; ++category)
+  {
+    const int64_t income = getTaxIncome(static_cast<Category>(category));
+    if (income != 0)
+    {
+      book(tick, static_cast<Category>(category), income);
+    }
+  }
+
+  m_lastMonth = m_thisMonth;
+  m_thisMonth.fill(0);
+}
+
+int64_t Budget::getTaxIncome(Category category) const
+{
+  return m_totals[category] * getTaxRate(category) * TaxPerInhabitant / 100;
+}
+
+void Budget::setTaxRate(Category category, int percent)
+{
+  m_taxRates[category - RESIDENTIAL_TAX] = std::max(0, std::min(MaxTaxRate, percent));
+}
+
+void Budget::book(uint32_t tick, Category category, int64_t amount)
+{
+  m_funds += amount;
+  m_thisMonth[category] += amount;
+  m_ledger.push(Transaction{tick, category, amount});
+}
@@ -0,0 +1,137 @@
+#ifndef BUDGET_HXX_
+#define BUDGET_HXX_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "RingBuffer.hxx"
+#include "common/enums.hxx"
+
+struct MapNodeChange;
+struct TileData;
+
+/** @brief The treasury of the city.
+  * The monthly upkeep and the tax bases are running totals per category that are kept up to date with the changes of
+  * the map, so closing a month is O(categories) instead of a scan of the map. Placing and demolishing tiles costs money
+  * while an edit of the player is applied. Every transaction is recorded in a ledger of bounded size.
+  */
+class Budget
+{
+public:
+  enum Category : unsigned int
+  {
+    ROADS,           /// upkeep of roads
+    POWER,           /// upkeep of power plants and power lines
+    WATER,           /// upkeep of water pumps and pipes
+    SERVICES,        /// upkeep of police, fire stations, schools and hospitals
+    OTHER,           /// upkeep of all other tiles, like parks
+    RESIDENTIAL_TAX, /// taxes of the residents
+    COMMERCIAL_TAX,  /// taxes of commercial jobs
+    INDUSTRIAL_TAX,  /// taxes of industrial and agricultural jobs
+    CONSTRUCTION,    /// placing and demolishing tiles
+    CATEGORIES_COUNT
+  };
+
+  struct Transaction
+  {
+    /// simulation tick of the transaction
+    uint32_t tick = 0;
+    Category category = CONSTRUCTION;
+    /// positive for income, negative for expenses
+    int64_t amount = 0;
+  };
+
+  /// Number of transactions kept in the ledger
+  static constexpr size_t LedgerSize = 256;
+  static constexpr int64_t StartingFunds = 20000;
+  /// Demolishing a tile costs its price divided by this
+  static constexpr int DemolitionCostDivisor = 4;
+  /// Tax rate of all zones in a new city, in percent
+  static constexpr int DefaultTaxRate = 7;
+  static constexpr int MaxTaxRate = 20;
+  /// Monthly tax of one inhabitant at a tax rate of 100%
+  static constexpr int TaxPerInhabitant = 10;
+
+  Budget();
+
+  /** @brief Get the upkeep category of a tile, or CATEGORIES_COUNT if it costs no upkeep.
+    */
+  static Category getUpkeepCategory(Layer layer, const TileData &tileData);
+
+  /** @brief Get the tax category of a tile, or CATEGORIES_COUNT if it pays no taxes.
+    */
+  static Category getTaxCategory(Layer layer, const TileData &tileData);
+
+  /** @brief Apply the difference between the old and the new tile of a changed node.
+    * Between beginEdit() and endEdit(), placed tiles are paid for as well and removed tiles cost demolition.
+    */
+  void onNodeChanged(const MapNodeChange &change);
+
+  /** @brief Add or remove the upkeep and the tax base of a single tile.
+    * @param sign 1 to add the tile, -1 to remove it.
+    */
+  void addTile(Layer layer, const TileData &tileData, int sign);
+
+  /** @brief Start charging the changes of the map, as they are edits of the player.
+    */
+  void beginEdit() { m_editing = true; };
+
+  /** @brief Stop charging the changes of the map and record the costs of the edit in the ledger.
+    * @param tick the simulation tick of the edit.
+    */
+  void endEdit(uint32_t tick);
+
+  /** @brief Pay the upkeep and collect the taxes of one month.
+    * @param tick the simulation tick the month ended with.
+    */
+  void closeMonth(uint32_t tick);
+
+  int64_t getFunds() const { return m_funds; };
+  void setFunds(int64_t funds) { m_funds = funds; };
+
+  /** @brief Get the current monthly upkeep of an upkeep category.
+    */
+  int64_t getUpkeep(Category category) const { return m_totals[category]; };
+
+  /** @brief Get the number of inhabitants that pay the taxes of a tax category.
+    */
+  int64_t getTaxBase(Category category) const { return m_totals[category]; };
+
+  /** @brief Get the taxes of a tax category that will be collected at the end of the month.
+    */
+  int64_t getTaxIncome(Category category) const;
+
+  /** @brief Get the tax rate of a tax category in percent.
+    */
+  int getTaxRate(Category category) const { return m_taxRates[category - RESIDENTIAL_TAX]; };
+
+  /** @brief Set the tax rate of a tax category, clamped to 0 - MaxTaxRate percent.
+    */
+  void setTaxRate(Category category, int percent);
+
+  /** @brief Get the sum of all transactions of a category in the last closed month, including construction costs.
+    */
+  int64_t getLastMonth(Category category) const { return m_lastMonth[category]; };
+
+  /** @brief Get the latest transactions, oldest first.
+    */
+  const RingBuffer<Transaction, LedgerSize> &getLedger() const { return m_ledger; };
+
+private:
+  int64_t m_funds = StartingFunds;
+  /// monthly upkeep of the upkeep categories, tax base of the tax categories
+  std::array<int64_t, CATEGORIES_COUNT> m_totals{};
+  std::array<int, INDUSTRIAL_TAX - RESIDENTIAL_TAX + 1> m_taxRates;
+  /// transactions of the running and the last closed month
+  std::array<int64_t, CATEGORIES_COUNT> m_thisMonth{};
+  std::array<int64_t, CATEGORIES_COUNT> m_lastMonth{};
+  RingBuffer<Transaction, LedgerSize> m_ledger;
+  bool m_editing = false;
+  /// costs of the running edit
+  int64_t m_editCosts = 0;
+
+  void book(uint32_t tick, Category category, int64_t amount);
+};
+
+#endif
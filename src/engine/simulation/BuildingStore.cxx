@@ -0,0 +1,173 @@
+#include "BuildingStore.hxx"
+
+#include "ByteStream.hxx"
+#include "tileData.hxx"
+
+#include <utility>
+
+BuildingStore::BuildingStore(int columns, int rows)
+    : m_columns(columns), m_slotOfNode(columns * rows, NONE), m_slotOfOrigin(columns * rows, NONE)
+{
+}
+
+bool BuildingStore::isBuilding(const TileData &tileData)
+{
+  if (tileData.tileType == +TileType::RCI)
+  {
+    return true;
+  }
+  return tileData.tileType == +TileType::DEFAULT && tileData.category != "Flora" && tileData.category != "Decoration";
+}
+
+void BuildingStore::setNode(int x, int y, int origin, const TileData *tileData)
+{
+  const int node = x * m_columns + y;
+  detach(node);
+
+  if (!tileData)
+  {
+    return;
+  }
+
+  uint32_t slot = m_slotOfOrigin[origin];
+  // a different building at the same origin can still have nodes that haven't been cleared yet
+  if (slot == NONE || m_tileData[m_slots[slot].index] != tileData)
+  {
+    slot = create(origin, tileData);
+  }
+
+  m_slotOfNode[node] = slot;
+  m_nodeCount[m_slots[slot].index]++;
+}
+
+void BuildingStore::detach(int node)
+{
+  const uint32_t slot = m_slotOfNode[node];
+
+  if (slot == NONE)
+  {
+    return;
+  }
+
+  m_slotOfNode[node] = NONE;
+  if (--m_nodeCount[m_slots[slot].index] == 0)
+  {
+    destroy(slot);
+  }
+}
+
+uint32_t BuildingStore::create(int origin, const TileData *tileData)
+{
+  uint32_t slot;
+  if (m_freeSlots.empty())
+  {
+    slot = static_cast<uint32_t>(m_slots.size());
+    m_slots.emplace_back();
+  }
+  else
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+  }
+
+  m_slots[slot].index = static_cast<uint32_t>(m_origin.size());
+  m_slotOfOrigin[origin] = slot;
+  m_slotOfIndex.push_back(slot);
+  m_origin.push_back(origin);
+  m_tileData.push_back(tileData);
+  m_nodeCount.push_back(0);
+  m_occupancy.push_back(tileData->inhabitants);
+  m_powered.push_back(0);
+  m_waterServed.push_back(0.f);
+  m_landValue.push_back(0.f);
+  m_age.push_back(0);
+  return slot;
+}
+
+void BuildingStore::destroy(uint32_t slot)
+{
+  const uint32_t index = m_slots[slot].index;
+  const uint32_t last = static_cast<uint32_t>(m_origin.size() - 1);
+
+  if (m_slotOfOrigin[m_origin[index]] == slot)
+  {
+    m_slotOfOrigin[m_origin[index]] = NONE;
+  }
+
+  // move the last building into the gap
+  m_slotOfIndex[index] = m_slotOfIndex[last];
+  m_origin[index] = m_origin[last];
+  m_tileData[index] = m_tileData[last];
+  m_nodeCount[index] = m_nodeCount[last];
+  m_occupancy[index] = m_occupancy[last];
+  m_powered[index] = m_powered[last];
+  m_waterServed[index] = m_waterServed[last];
+  m_landValue[index] = m_landValue[last];
+  m_age[index] = m_age[last];
+  m_slots[m_slotOfIndex[index]].index = index;
+
+  m_slotOfIndex.pop_back();
+  m_origin.pop_back();
+  m_tileData.pop_back();
+  m_nodeCount.pop_back();
+  m_occupancy.pop_back();
+  m_powered.pop_back();
+  m_waterServed.pop_back();
+  m_landValue.pop_back();
+  m_age.pop_back();
+
+  m_slots[slot].index = NONE;
+  m_slots[slot].generation++;
+  m_freeSlots.push_back(slot);
+}
+
+BuildingId BuildingStore::getBuildingAt(int x, int y) const
+{
+  const uint32_t slot = m_slotOfNode[x * m_columns + y];
+  return slot == NONE ? BuildingId{} : BuildingId{slot, m_slots[slot].generation};
+}
+
+bool BuildingStore::isAlive(const BuildingId &id) const
+{
+  return id.index < m_slots.size() && m_slots[id.index].generation == id.generation && m_slots[id.index].index != NONE;
+}
+
+int BuildingStore::getIndex(const BuildingId &id) const
+{
+  return isAlive(id) ? static_cast<int>(m_slots[id.index].index) : -1;
+}
+
+void BuildingStore::save(ByteWriter &writer) const
+{
+  writer.writeVarint(m_origin.size());
+  for (size_t index = 0; index < m_origin.size(); ++index)
+  {
+    writer.writeVarint(static_cast<uint64_t>(m_origin[index]));
+    writer.writeVarint(m_age[index]);
+  }
+}
+
+void BuildingStore::load(ByteReader &reader)
+{
+  // read everything before changing any age, so malformed data leaves them untouched
+  std::vector<std::pair<uint32_t, uint32_t>> ages;
+  const uint64_t count = reader.readVarint();
+  for (uint64_t building = 0; building < count; ++building)
+  {
+    const uint64_t origin = reader.readVarint();
+    if (origin >= m_slotOfOrigin.size())
+    {
+      throw CytopiaError{TRACE_INFO "The origin of a building is outside of the map"};
+    }
+    ages.emplace_back(static_cast<uint32_t>(origin), static_cast<uint32_t>(reader.readVarint()));
+  }
+
+  for (const auto &[origin, age] : ages)
+  {
+    const uint32_t slot = m_slotOfOrigin[origin];
+    if (slot != NONE)
+    {
+      m_age[m_slots[slot].index] = age;
+    }
+  }
+}
@@ -0,0 +1,126 @@
+#ifndef BUILDINGSTORE_HXX_
+#define BUILDINGSTORE_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ByteReader;
+class ByteWriter;
+struct TileData;
+
+/** @brief Handle of a building in the BuildingStore.
+  * The generation is increased whenever a slot is reused, so handles of demolished buildings stay invalid.
+  */
+struct BuildingId
+{
+  uint32_t index = UINT32_MAX;
+  uint32_t generation = 0;
+
+  bool operator==(const BuildingId &other) const { return index == other.index && generation == other.generation; };
+  bool operator!=(const BuildingId &other) const { return !(*this == other); };
+  bool isValid() const { return index != UINT32_MAX; };
+};
+
+/** @brief Dense storage of all placed buildings and their simulation state.
+  * The state of the buildings is stored as structure of arrays, so systems can iterate over the buildings only instead
+  * of all map nodes. Every node keeps the building covering it, so buildings can be looked up by their nodes.
+  * Removing a building moves the last building into its place, so the dense index of a building can change;
+  * use the BuildingId to refer to a building over time.
+  */
+class BuildingStore
+{
+public:
+  BuildingStore(int columns, int rows);
+
+  /** @brief Check if a tile on the buildings layer is a building with simulation state.
+    * Power lines and decorations like trees are not.
+    */
+  static bool isBuilding(const TileData &tileData);
+
+  /** @brief Update the building covering a node.
+    * Buildings are created when their first node is set and destroyed when their last node is cleared.
+    * @param x the x coordinate of the node.
+    * @param y the y coordinate of the node.
+    * @param origin node index of the origin of the building.
+    * @param tileData the building, or nullptr if the node is not covered by a building anymore.
+    */
+  void setNode(int x, int y, int origin, const TileData *tileData);
+
+  /** @brief Get the building covering a node, or an invalid id.
+    */
+  BuildingId getBuildingAt(int x, int y) const;
+
+  bool isAlive(const BuildingId &id) const;
+
+  /** @brief Get the dense index of a building, which is valid until the next building is removed.
+    * @return the index or -1 if the building doesn't exist anymore.
+    */
+  int getIndex(const BuildingId &id) const;
+
+  BuildingId getId(int index) const { return BuildingId{m_slotOfIndex[index], m_slots[m_slotOfIndex[index]].generation}; };
+
+  size_t size() const { return m_origin.size(); };
+
+  /// node index of the origin of each building
+  const std::vector<int> &getOrigins() const { return m_origin; };
+  const std::vector<const TileData *> &getTileData() const { return m_tileData; };
+
+  /// @name Components, indexed by the dense index of the buildings
+  ///@{
+  std::vector<int> &getOccupancy() { return m_occupancy; };
+  std::vector<uint8_t> &getPowered() { return m_powered; };
+  std::vector<float> &getWaterServed() { return m_waterServed; };
+  std::vector<float> &getLandValue() { return m_landValue; };
+  /// age in days
+  std::vector<uint32_t> &getAge() { return m_age; };
+  ///@}
+
+  const std::vector<int> &getOccupancy() const { return m_occupancy; };
+  const std::vector<uint8_t> &getPowered() const { return m_powered; };
+  const std::vector<float> &getWaterServed() const { return m_waterServed; };
+  const std::vector<float> &getLandValue() const { return m_landValue; };
+  const std::vector<uint32_t> &getAge() const { return m_age; };
+
+  /** @brief Write the ages of the buildings by their origin, the rest of their state is rebuilt from the map.
+    */
+  void save(ByteWriter &writer) const;
+
+  /** @brief Restore the ages written by save() for the buildings that stand at the same origins.
+    * @throws CytopiaError if the data is malformed, the ages are left untouched then.
+    */
+  void load(ByteReader &reader);
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  struct Slot
+  {
+    uint32_t generation = 0;
+    uint32_t index = NONE;
+  };
+
+  int m_columns;
+  std::vector<Slot> m_slots;
+  std::vector<uint32_t> m_freeSlots;
+  /// slot of the building covering each node
+  std::vector<uint32_t> m_slotOfNode;
+  /// slot of the building whose origin is the node
+  std::vector<uint32_t> m_slotOfOrigin;
+
+  std::vector<uint32_t> m_slotOfIndex;
+  std::vector<int> m_origin;
+  std::vector<const TileData *> m_tileData;
+  std::vector<int> m_nodeCount;
+  std::vector<int> m_occupancy;
+  std::vector<uint8_t> m_powered;
+  std::vector<float> m_waterServed;
+  std::vector<float> m_landValue;
+  std::vector<uint32_t> m_age;
+
+  uint32_t create(int origin, const TileData *tileData);
+  void destroy(uint32_t slot);
+  void detach(int node);
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "CityStats.hxx"
+
+#include "Map.hxx"
+
+#include <algorithm>
+
+bool CityStats::isResidential(const TileData &tileData)
+{
+  return tileData.tileType == +TileType::RCI &&
+         std::find(tileData.zones.begin(), tileData.zones.end(), +Zones::RESIDENTIAL) != tileData.zones.end();
+}
+
+void CityStats::onNodeChanged(const MapNodeChange &change)
+{
+  if (change.oldTileData && change.isoCoordinates == change.oldOrigCornerPoint)
+  {
+    addTile(change.layer, *change.oldTileData, -1);
+  }
+  if (change.newTileData && change.isoCoordinates == change.newOrigCornerPoint)
+  {
+    addTile(change.layer, *change.newTileData, 1);
+  }
+}
+
+void CityStats::addTile(Layer layer, const TileData &tileData, int sign)
+{
+  // terrain and zones are not part of the city's infrastructure
+  if (layer == Layer::TERRAIN || layer == Layer::ZONE || layer == Layer::BLUEPRINT)
+  {
+    return;
+  }
+
+  m_upkeep += sign * tileData.upkeepCost;
+  m_powerProduction += sign * std::max(tileData.power, 0);
+  m_powerConsumption += sign * std::max(-tileData.power, 0);
+  m_waterProduction += sign * std::max(tileData.water, 0);
+  m_waterConsumption += sign * std::max(-tileData.water, 0);
+
+  if (layer != Layer::BUILDINGS || tileData.tileType == +TileType::AUTOTILE)
+  {
+    return;
+  }
+
+  if (isResidential(tileData))
+  {
+    m_population += sign * tileData.inhabitants;
+  }
+  else
+  {
+    m_jobs += sign * tileData.inhabitants;
+  }
+
+  m_buildings += sign;
+  m_buildingsPerCategory[tileData.category] += sign;
+}
+
+void CityStats::recount(const Map &map)
+{
+  *this = CityStats();
+
+  for (int x = 0; x < map.getRows(); x++)
+  {
+    for (int y = 0; y < map.getColumns(); y++)
+    {
+      const MapNode *node = map.getMapNode(Point{x, y, 0, 0});
+
+      for (unsigned int layer = 0; layer < LAYERS_COUNT; ++layer)
+      {
+        const MapNodeData &mapNodeData = node->getMapNodeDataForLayer(static_cast<Layer>(layer));
+
+        if (mapNodeData.tileData && node->getCoordinates() == mapNodeData.origCornerPoint)
+        {
+          addTile(static_cast<Layer>(layer), *mapNodeData.tileData, 1);
+        }
+      }
+    }
+  }
+}
+
+bool CityStats::operator==(const CityStats &other) const
+{
+  auto sameCategories = [](const std::unordered_map<std::string, int> &a, const std::unordered_map<std::string, int> &b) {
+    // categories whose buildings have all been demolished stay in the map with a count of 0
+    return std::all_of(a.begin(), a.end(), [&b](const std::pair<const std::string, int> &category) {
+      auto it = b.find(category.first);
+      return (it == b.end() ? 0 : it->second) == category.second;
+    });
+  };
+
+  return m_population == other.m_population && m_jobs == other.m_jobs && m_upkeep == other.m_upkeep &&
+         m_powerProduction == other.m_powerProduction && m_powerConsumption == other.m_powerConsumption &&
+         m_waterProduction == other.m_waterProduction && m_waterConsumption == other.m_waterConsumption &&
+         m_buildings == other.m_buildings && sameCategories(m_buildingsPerCategory, other.m_buildingsPerCategory) &&
+         sameCategories(other.m_buildingsPerCategory, m_buildingsPerCategory);
+}
+
+int CityStats::getBuildingCount(const std::string &category) const
+{
+  auto it = m_buildingsPerCategory.find(category);
+  return it == m_buildingsPerCategory.end() ? 0 : it->second;
+}
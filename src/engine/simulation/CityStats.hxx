@@ -0,0 +1,74 @@
+#ifndef CITYSTATS_HXX_
+#define CITYSTATS_HXX_
+
+#include <string>
+#include <unordered_map>
+
+#include "common/enums.hxx"
+
+class Map;
+struct MapNodeChange;
+struct TileData;
+
+/** @brief Totals of the whole city, like population, jobs and the power balance.
+  * The totals are kept up to date with the changes of the map, so reading them is O(1).
+  * Multi-node objects are counted once, on their origin node.
+  */
+class CityStats
+{
+public:
+  /** @brief Check if a building houses residents, otherwise its inhabitants are workers.
+    */
+  static bool isResidential(const TileData &tileData);
+
+  /** @brief Apply the difference between the old and the new tile of a changed node.
+    */
+  void onNodeChanged(const MapNodeChange &change);
+
+  /** @brief Add or remove a single tile.
+    * @param layer the layer the tile is placed on.
+    * @param tileData the tile.
+    * @param sign 1 to add the tile, -1 to remove it.
+    */
+  void addTile(Layer layer, const TileData &tileData, int sign);
+
+  /** @brief Reset the totals and count all tiles of the map.
+    * Used to cross-check the incremental totals in debug builds.
+    */
+  void recount(const Map &map);
+
+  bool operator==(const CityStats &other) const;
+  bool operator!=(const CityStats &other) const { return !(*this == other); };
+
+  /// Number of residents that live in residential buildings
+  int getPopulation() const { return m_population; };
+  /// Number of jobs in all other buildings
+  int getJobs() const { return m_jobs; };
+  /// Monthly upkeep of all tiles
+  int getUpkeep() const { return m_upkeep; };
+  int getPowerProduction() const { return m_powerProduction; };
+  int getPowerConsumption() const { return m_powerConsumption; };
+  int getWaterProduction() const { return m_waterProduction; };
+  int getWaterConsumption() const { return m_waterConsumption; };
+
+  /** @brief Get the number of buildings of a category, like "Residential" or "School".
+    */
+  int getBuildingCount(const std::string &category) const;
+
+  /** @brief Get the number of buildings of all categories.
+    */
+  int getBuildingCount() const { return m_buildings; };
+
+private:
+  int m_population = 0;
+  int m_jobs = 0;
+  int m_upkeep = 0;
+  int m_powerProduction = 0;
+  int m_powerConsumption = 0;
+  int m_waterProduction = 0;
+  int m_waterConsumption = 0;
+  int m_buildings = 0;
+  std::unordered_map<std::string, int> m_buildingsPerCategory;
+};
+
+#endif
@@ -0,0 +1,195 @@
+#include "CommandLog.hxx"
+
+#include "ByteStream.hxx"
+#include "Exception.hxx"
+#include "LOG.hxx"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+/// "CTCL", identifies command logs
+constexpr uint64_t COMMAND_LOG_MAGIC = 0x4C435443;
+constexpr uint64_t COMMAND_LOG_VERSION = 1;
+} // namespace
+
+void CommandLog::record(const MapCommand &command)
+{
+  if (!m_commands.empty() && command.tick < m_commands.back().tick)
+  {
+    throw CytopiaError{TRACE_INFO "Commands must be recorded in the order of their ticks"};
+  }
+  if (command.isView() && !m_commands.empty() && m_commands.back().type == command.type &&
+      m_commands.back().tick == command.tick)
+  {
+    m_commands.back() = command;
+    return;
+  }
+  m_commands.push_back(command);
+}
+
+size_t CommandLog::getCommandsAt(uint32_t tick, size_t &first) const
+{
+  auto byTick = [](const MapCommand &command, uint32_t value) { return command.tick < value; };
+  first = std::lower_bound(m_commands.begin(), m_commands.end(), tick, byTick) - m_commands.begin();
+  size_t last = first;
+  while (last < m_commands.size() && m_commands[last].tick == tick)
+  {
+    last++;
+  }
+  return last;
+}
+
+void CommandLog::save(std::vector<uint8_t> &buffer) const
+{
+  ByteWriter writer(buffer);
+  writer.writeVarint(COMMAND_LOG_MAGIC);
+  writer.writeVarint(COMMAND_LOG_VERSION);
+  writer.writeVarint(m_seed);
+  writer.writeString(m_start.saveGame);
+  writer.writeVarint(m_start.columns);
+  writer.writeVarint(m_start.rows);
+  writer.writeSignedVarint(m_start.terrainSeed);
+  writer.writeVarint(m_endTick);
+  writer.writeVarint(m_endHash);
+  writer.writeVarint(m_commands.size());
+
+  std::unordered_map<std::string, uint64_t> tileIDs;
+  uint32_t tick = 0;
+  for (const MapCommand &command : m_commands)
+  {
+    writer.writeVarint(command.tick - tick);
+    tick = command.tick;
+    writer.writeVarint(command.type);
+
+    switch (command.type)
+    {
+    case MapCommand::PLACE:
+    case MapCommand::PLACE_OBJECT:
+    {
+      // a new tileID is written after the index it gets
+      const auto [tileID, isNew] = tileIDs.emplace(command.tileID, tileIDs.size());
+      writer.writeVarint(tileID->second);
+      if (isNew)
+      {
+        writer.writeString(command.tileID);
+      }
+      break;
+    }
+    case MapCommand::DEMOLISH:
+      writer.writeVarint(command.layer);
+      writer.writeVarint(command.updateNeighbors);
+      break;
+    case MapCommand::CAMERA:
+      writer.writeSignedVarint(command.cameraX);
+      writer.writeSignedVarint(command.cameraY);
+      writer.writeFloat(command.value);
+      break;
+    case MapCommand::SPEED:
+    case MapCommand::ADD_LINE:
+      writer.writeFloat(command.value);
+      break;
+    case MapCommand::RAISE_TERRAIN:
+    case MapCommand::LOWER_TERRAIN:
+    case MapCommand::REMOVE_LINE:
+      break;
+    }
+
+    // edits mostly cover lines and rectangles, so the offsets to the previous node are small
+    writer.writeVarint(command.nodes.size());
+    Point previous{0, 0, 0, 0};
+    for (const Point &node : command.nodes)
+    {
+      writer.writeSignedVarint(node.x - previous.x);
+      writer.writeSignedVarint(node.y - previous.y);
+      previous = node;
+    }
+  }
+}
+
+void CommandLog::load(const std::vector<uint8_t> &buffer)
+{
+  ByteReader reader(buffer);
+  if (reader.readVarint() != COMMAND_LOG_MAGIC)
+  {
+    throw CytopiaError{TRACE_INFO "The data is not a command log"};
+  }
+  if (reader.readVarint() != COMMAND_LOG_VERSION)
+  {
+    throw CytopiaError{TRACE_INFO "Unsupported version of the command log"};
+  }
+
+  CommandLog log;
+  log.m_seed = reader.readVarint();
+  log.m_start.saveGame = reader.readString();
+  log.m_start.columns = static_cast<int>(reader.readVarint());
+  log.m_start.rows = static_cast<int>(reader.readVarint());
+  log.m_start.terrainSeed = static_cast<int>(reader.readSignedVarint());
+  log.m_endTick = static_cast<uint32_t>(reader.readVarint());
+  log.m_endHash = reader.readVarint();
+  const uint64_t commandCount = reader.readVarint();
+
+  std::vector<std::string> tileIDs;
+  uint32_t tick = 0;
+  for (uint64_t i = 0; i < commandCount; ++i)
+  {
+    MapCommand command;
+    tick += static_cast<uint32_t>(reader.readVarint());
+    command.tick = tick;
+    const uint64_t type = reader.readVarint();
+    if (type > MapCommand::REMOVE_LINE)
+    {
+      throw CytopiaError{TRACE_INFO "Invalid command type " + std::to_string(type)};
+    }
+    command.type = static_cast<MapCommand::Type>(type);
+
+    switch (command.type)
+    {
+    case MapCommand::PLACE:
+    case MapCommand::PLACE_OBJECT:
+    {
+      const uint64_t tileID = reader.readVarint();
+      if (tileID == tileIDs.size())
+      {
+        tileIDs.push_back(reader.readString());
+      }
+      else if (tileID > tileIDs.size())
+      {
+        throw CytopiaError{TRACE_INFO "Invalid tileID index " + std::to_string(tileID)};
+      }
+      command.tileID = tileIDs[tileID];
+      break;
+    }
+    case MapCommand::DEMOLISH:
+      command.layer = static_cast<Layer>(reader.readVarint());
+      command.updateNeighbors = reader.readVarint() != 0;
+      break;
+    case MapCommand::CAMERA:
+      command.cameraX = static_cast<int>(reader.readSignedVarint());
+      command.cameraY = static_cast<int>(reader.readSignedVarint());
+      command.value = reader.readFloat();
+      break;
+    case MapCommand::SPEED:
+    case MapCommand::ADD_LINE:
+      command.value = reader.readFloat();
+      break;
+    case MapCommand::RAISE_TERRAIN:
+    case MapCommand::LOWER_TERRAIN:
+    case MapCommand::REMOVE_LINE:
+      break;
+    }
+
+    const uint64_t nodeCount = reader.readVarint();
+    Point node{0, 0, 0, 0};
+    for (uint64_t n = 0; n < nodeCount; ++n)
+    {
+      node.x += static_cast<int>(reader.readSignedVarint());
+      node.y += static_cast<int>(reader.readSignedVarint());
+      command.nodes.push_back(node);
+    }
+    log.m_commands.push_back(std::move(command));
+  }
+
+  *this = std::move(log);
+}
@@ -0,0 +1,127 @@
+#ifndef COMMANDLOG_HXX_
+#define COMMANDLOG_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "basics/point.hxx"
+#include "common/enums.hxx"
+
+/** @brief An edit of the map by the player.
+  * Edits done by the simulation itself, like growing zones, are not commands, they follow from the commands, the seed
+  * and the number of ticks. Changes of the camera and the game speed are recorded as well, so a session can be watched
+  * again, but they don't change the state of the city.
+  */
+struct MapCommand
+{
+  enum Type : uint8_t
+  {
+    PLACE,          /// place tileID on every node
+    PLACE_OBJECT,   /// place a single object of tileID that covers all nodes, the first node is its origin
+    DEMOLISH,       /// demolish layer, or all layers for Layer::NONE, on every node
+    RAISE_TERRAIN,  /// raise the terrain of every node
+    LOWER_TERRAIN,  /// lower the terrain of every node
+    CAMERA,         /// move the camera to cameraX, cameraY with the zoom level in value
+    SPEED,          /// set the speed factor of the game clock to value
+    ADD_LINE,       /// add a transit line through the nodes with the number of vehicles in value
+    REMOVE_LINE     /// remove the transit line that stops at the first node
+  };
+
+  /// simulation tick after which the command has been executed
+  uint32_t tick = 0;
+  Type type = PLACE;
+  std::string tileID;
+  std::vector<Point> nodes;
+  Layer layer = Layer::NONE;
+  /// for DEMOLISH, whether the neighbors are updated as well
+  bool updateNeighbors = false;
+  /// for CAMERA, the offset of the camera in screen coordinates
+  int cameraX = 0;
+  int cameraY = 0;
+  /// for CAMERA the zoom level, for SPEED the speed factor, for ADD_LINE the number of vehicles
+  float value = 0;
+
+  /// whether the command only changes how the city is watched
+  bool isView() const { return type == CAMERA || type == SPEED; };
+};
+
+/** @brief The commands executed since the simulation has been seeded.
+  * Starting from the same map with the same seed, executing the commands after their ticks reproduces the same city.
+  */
+class CommandLog
+{
+public:
+  /** @brief The map a session started with, so it can be created again for a replay.
+    */
+  struct Start
+  {
+    /// the savegame the session has been loaded from, empty if the map has been generated
+    std::string saveGame;
+    int columns = 0;
+    int rows = 0;
+    int terrainSeed = 0;
+  };
+
+  /** @brief Start a new log for a simulation that has been seeded with the given seed.
+    */
+  void reset(uint64_t seed)
+  {
+    m_seed = seed;
+    m_start = Start();
+    m_endTick = 0;
+    m_endHash = 0;
+    m_commands.clear();
+  };
+
+  uint64_t getSeed() const { return m_seed; };
+
+  void setStart(const Start &start) { m_start = start; };
+  const Start &getStart() const { return m_start; };
+
+  /** @brief Set the tick the session ended with and the state hash after it, a replay runs the simulation until this
+    * tick and compares the hashes.
+    */
+  void setEnd(uint32_t tick, uint64_t stateHash)
+  {
+    m_endTick = tick;
+    m_endHash = stateHash;
+  };
+  uint32_t getEndTick() const { return m_endTick; };
+  uint64_t getEndHash() const { return m_endHash; };
+
+  /** @brief Append a command, the ticks of the commands must not decrease.
+    * A change of the camera or the speed replaces the previous command if it is of the same type and tick, only the last
+    * one of a tick is visible anyway.
+    */
+  void record(const MapCommand &command);
+
+  const std::vector<MapCommand> &getCommands() const { return m_commands; };
+
+  /** @brief Get the range of commands executed after the given tick.
+    * @param tick the tick.
+    * @param first receives the index of the first command.
+    * @return the index after the last command.
+    */
+  size_t getCommandsAt(uint32_t tick, size_t &first) const;
+
+  /** @brief Write the log in a compact binary format.
+    * Ticks and node coordinates are delta coded varints and every tileID is written only once.
+    */
+  void save(std::vector<uint8_t> &buffer) const;
+
+  /** @brief Replace the log by one written with save().
+    * @throws CytopiaError if the data is not a command log or is truncated.
+    */
+  void load(const std::vector<uint8_t> &buffer);
+
+private:
+  uint64_t m_seed = 0;
+  Start m_start;
+  uint32_t m_endTick = 0;
+  uint64_t m_endHash = 0;
+  std::vector<MapCommand> m_commands;
+};
+
+#endif
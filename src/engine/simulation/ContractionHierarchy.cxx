@@ -0,0 +1,263 @@
+#include "ContractionHierarchy.hxx"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+namespace
+{
+/// Number of vertices a witness search may settle before giving up and adding the shortcut
+constexpr int WITNESS_SETTLE_LIMIT = 500;
+
+using Adjacency = std::vector<std::unordered_map<int, int>>;
+using QueueItem = std::pair<int, int>;
+using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+
+/// Check if there is a path from source to target that avoids the excluded vertex and is not longer than limit
+bool hasWitness(const Adjacency &graph, const std::vector<bool> &contracted, int source, int target, int excluded, int limit,
+                std::unordered_map<int, int> &distance)
+{
+  distance.clear();
+  MinQueue queue;
+  queue.push({0, source});
+  distance[source] = 0;
+  int settled = 0;
+
+  while (!queue.empty() && settled < WITNESS_SETTLE_LIMIT)
+  {
+    const auto [dist, vertex] = queue.top();
+    queue.pop();
+
+    if (dist > distance[vertex])
+    {
+      continue;
+    }
+    if (dist > limit)
+    {
+      return false;
+    }
+    if (vertex == target)
+    {
+      return true;
+    }
+    settled++;
+
+    for (const auto &[neighbor, weight] : graph[vertex])
+    {
+      if (neighbor == excluded || contracted[neighbor])
+      {
+        continue;
+      }
+      auto it = distance.find(neighbor);
+      if (it == distance.end() || dist + weight < it->second)
+      {
+        distance[neighbor] = dist + weight;
+        queue.push({dist + weight, neighbor});
+      }
+    }
+  }
+  return false;
+}
+} // namespace
+
+void ContractionHierarchy::build(int vertexCount, const std::vector<Edge> &edges)
+{
+  Adjacency graph(vertexCount);
+  for (const Edge &edge : edges)
+  {
+    if (edge.from == edge.to)
+    {
+      continue;
+    }
+    for (auto [a, b] : {std::pair{edge.from, edge.to}, std::pair{edge.to, edge.from}})
+    {
+      auto it = graph[a].find(b);
+      if (it == graph[a].end() || edge.weight < it->second)
+      {
+        graph[a][b] = edge.weight;
+      }
+    }
+  }
+
+  std::vector<bool> contracted(vertexCount, false);
+  std::vector<int> contractedNeighbors(vertexCount, 0);
+  std::vector<int> rank(vertexCount, 0);
+  /// length of the longest chain of contracted vertices below each vertex
+  std::vector<int> level(vertexCount, 0);
+  std::vector<std::tuple<int, int, int>> shortcuts;
+  std::unordered_map<int, int> witnessDistance;
+  m_shortcutCount = 0;
+
+  // contract the vertex and return the number of shortcuts it needs, without changing the graph if simulate is set
+  auto contract = [&](int vertex, bool simulate) {
+    shortcuts.clear();
+    std::vector<std::pair<int, int>> neighbors;
+    for (const auto &[neighbor, weight] : graph[vertex])
+    {
+      if (!contracted[neighbor])
+      {
+        neighbors.emplace_back(neighbor, weight);
+      }
+    }
+    std::sort(neighbors.begin(), neighbors.end());
+
+    for (size_t i = 0; i < neighbors.size(); ++i)
+    {
+      for (size_t j = i + 1; j < neighbors.size(); ++j)
+      {
+        const int limit = neighbors[i].second + neighbors[j].second;
+        if (!hasWitness(graph, contracted, neighbors[i].first, neighbors[j].first, vertex, limit, witnessDistance))
+        {
+          shortcuts.emplace_back(neighbors[i].first, neighbors[j].first, limit);
+        }
+      }
+    }
+
+    if (!simulate)
+    {
+      for (const auto &[a, b, weight] : shortcuts)
+      {
+        auto it = graph[a].find(b);
+        if (it == graph[a].end() || weight < it->second)
+        {
+          graph[a][b] = weight;
+          graph[b][a] = weight;
+          m_shortcutCount++;
+        }
+      }
+      for (const auto &neighbor : neighbors)
+      {
+        contractedNeighbors[neighbor.first]++;
+        level[neighbor.first] = std::max(level[neighbor.first], level[vertex] + 1);
+      }
+    }
+    return static_cast<int>(shortcuts.size()) - static_cast<int>(neighbors.size());
+  };
+
+  // prefer vertices that need few shortcuts, and spread the contraction evenly over the graph
+  auto priority = [&](int vertex) { return 2 * contract(vertex, true) + contractedNeighbors[vertex] + level[vertex]; };
+
+  MinQueue queue;
+  for (int vertex = 0; vertex < vertexCount; ++vertex)
+  {
+    queue.push({priority(vertex), vertex});
+  }
+
+  int nextRank = 0;
+  while (!queue.empty())
+  {
+    const auto [oldPriority, vertex] = queue.top();
+    queue.pop();
+
+    if (contracted[vertex])
+    {
+      continue;
+    }
+
+    // lazy update: contract the vertex only if it is still the best candidate
+    const int newPriority = priority(vertex);
+    if (!queue.empty() && newPriority > queue.top().first)
+    {
+      queue.push({newPriority, vertex});
+      continue;
+    }
+
+    contract(vertex, false);
+    contracted[vertex] = true;
+    rank[vertex] = nextRank++;
+  }
+
+  // keep only the edges that lead to a higher ranked vertex
+  m_upOffsets.assign(vertexCount + 1, 0);
+  m_upTargets.clear();
+  m_upWeights.clear();
+  for (int vertex = 0; vertex < vertexCount; ++vertex)
+  {
+    for (const auto &[neighbor, weight] : graph[vertex])
+    {
+      if (rank[neighbor] > rank[vertex])
+      {
+        m_upTargets.push_back(neighbor);
+        m_upWeights.push_back(weight);
+      }
+    }
+    m_upOffsets[vertex + 1] = static_cast<int>(m_upTargets.size());
+  }
+
+  for (int direction = 0; direction < 2; ++direction)
+  {
+    m_distance[direction].assign(vertexCount, INFINITE_DISTANCE);
+    m_stamp[direction].assign(vertexCount, 0);
+  }
+  m_currentStamp = 0;
+}
+
+int ContractionHierarchy::query(const std::vector<std::pair<int, int>> &sources,
+                                const std::vector<std::pair<int, int>> &targets)
+{
+  if (!isBuilt())
+  {
+    return INFINITE_DISTANCE;
+  }
+
+  m_currentStamp++;
+  MinQueue queues[2];
+
+  auto relax = [this, &queues](int direction, int vertex, int distance) {
+    if (m_stamp[direction][vertex] != m_currentStamp || distance < m_distance[direction][vertex])
+    {
+      m_stamp[direction][vertex] = m_currentStamp;
+      m_distance[direction][vertex] = distance;
+      queues[direction].push({distance, vertex});
+    }
+  };
+  auto distanceOf = [this](int direction, int vertex) {
+    return m_stamp[direction][vertex] == m_currentStamp ? m_distance[direction][vertex] : INFINITE_DISTANCE;
+  };
+
+  for (const auto &[vertex, distance] : sources)
+  {
+    relax(0, vertex, distance);
+  }
+  for (const auto &[vertex, distance] : targets)
+  {
+    relax(1, vertex, distance);
+  }
+
+  int best = INFINITE_DISTANCE;
+  while (!queues[0].empty() || !queues[1].empty())
+  {
+    // both searches only go upwards, so they can stop once they can't improve the best meeting point
+    const int direction = queues[1].empty() || (!queues[0].empty() && queues[0].top().first <= queues[1].top().first) ? 0 : 1;
+    const auto [distance, vertex] = queues[direction].top();
+    queues[direction].pop();
+
+    if (distance >= best)
+    {
+      while (!queues[direction].empty())
+      {
+        queues[direction].pop();
+      }
+      continue;
+    }
+    if (distance > distanceOf(direction, vertex))
+    {
+      continue;
+    }
+
+    const int other = distanceOf(1 - direction, vertex);
+    if (other != INFINITE_DISTANCE)
+    {
+      best = std::min(best, distance + other);
+    }
+
+    for (int i = m_upOffsets[vertex]; i < m_upOffsets[vertex + 1]; ++i)
+    {
+      relax(direction, m_upTargets[i], distance + m_upWeights[i]);
+    }
+  }
+
+  return best;
+}
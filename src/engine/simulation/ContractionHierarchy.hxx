@@ -0,0 +1,58 @@
+#ifndef CONTRACTIONHIERARCHY_HXX_
+#define CONTRACTIONHIERARCHY_HXX_
+
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+/** @brief Contraction hierarchy for fast shortest path queries on a static, undirected graph.
+  * Vertices are contracted in the order of their edge difference, shortcuts are added whenever a local witness search
+  * can't find a path that is at least as short. Queries run a bidirectional Dijkstra on the upward graph only.
+  * The hierarchy has to be rebuilt after the graph changed.
+  */
+class ContractionHierarchy
+{
+public:
+  static constexpr int INFINITE_DISTANCE = std::numeric_limits<int>::max();
+
+  struct Edge
+  {
+    int from;
+    int to;
+    int weight;
+  };
+
+  /** @brief Build the hierarchy.
+    * @param vertexCount the number of vertices, vertices are numbered 0 to vertexCount - 1.
+    * @param edges all undirected edges of the graph.
+    */
+  void build(int vertexCount, const std::vector<Edge> &edges);
+
+  /** @brief Get the shortest distance between two sets of vertices.
+    * @param sources pairs of vertex and initial distance to start from.
+    * @param targets pairs of vertex and remaining distance to the target.
+    * @return the shortest distance, or INFINITE_DISTANCE if the targets can't be reached.
+    */
+  int query(const std::vector<std::pair<int, int>> &sources, const std::vector<std::pair<int, int>> &targets);
+
+  /** @brief Get the number of shortcuts added while building.
+    */
+  size_t getShortcutCount() const { return m_shortcutCount; };
+
+  bool isBuilt() const { return !m_upOffsets.empty(); };
+
+private:
+  /// upward graph in compressed sparse row format
+  std::vector<int> m_upOffsets;
+  std::vector<int> m_upTargets;
+  std::vector<int> m_upWeights;
+  size_t m_shortcutCount = 0;
+
+  /// scratch data for queries, indexed by direction (0 forward, 1 backward)
+  std::vector<int> m_distance[2];
+  std::vector<unsigned int> m_stamp[2];
+  unsigned int m_currentStamp = 0;
+};
+
+#endif
@@ -0,0 +1,208 @@
+#include "DataMapOverlay.hxx"
+
+#include "Map.hxx"
+#include "WindowManager.hxx"
+#include "basics/Camera.hxx"
+#include "basics/isoMath.hxx"
+
+#include <algorithm>
+
+namespace
+{
+/// Opacity of the colored nodes
+constexpr Uint8 OVERLAY_ALPHA = 150;
+
+struct ColorStop
+{
+  float value;
+  Uint8 r, g, b;
+};
+
+constexpr ColorStop HEAT_STOPS[] = {{0.f, 40, 70, 220}, {0.5f, 250, 220, 40}, {1.f, 220, 30, 30}};
+constexpr ColorStop GREEN_RED_STOPS[] = {{0.f, 40, 190, 40}, {0.5f, 230, 210, 40}, {1.f, 220, 40, 40}};
+constexpr ColorStop GRAYSCALE_STOPS[] = {{0.f, 0, 0, 0}, {1.f, 255, 255, 255}};
+
+template <size_t N> SDL_Color interpolate(const ColorStop (&stops)[N], float value)
+{
+  size_t stop = 1;
+  while (stop < N - 1 && stops[stop].value < value)
+  {
+    ++stop;
+  }
+
+  const ColorStop &low = stops[stop - 1];
+  const ColorStop &high = stops[stop];
+  const float t = (value - low.value) / (high.value - low.value);
+  auto lerp = [t](Uint8 a, Uint8 b) { return static_cast<Uint8>(a + (b - a) * t + 0.5f); };
+  return SDL_Color{lerp(low.r, high.r), lerp(low.g, high.g), lerp(low.b, high.b), OVERLAY_ALPHA};
+}
+} // namespace
+
+DataMapOverlay::DataMapOverlay(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_values(columns * rows, NO_DATA), m_colors(columns * rows, SDL_Color{0, 0, 0, 0})
+{
+}
+
+void DataMapOverlay::setDataMap(DataMap dataMap)
+{
+  if (dataMap != m_dataMap)
+  {
+    m_dataMap = dataMap;
+    // the values of the previous data map are meaningless now
+    std::fill(m_values.begin(), m_values.end(), NO_DATA);
+    updateColors();
+  }
+}
+
+void DataMapOverlay::setColorRamp(ColorRamp colorRamp)
+{
+  if (colorRamp != m_colorRamp)
+  {
+    m_colorRamp = colorRamp;
+    updateColors();
+  }
+}
+
+void DataMapOverlay::setValues(const std::vector<float> &values)
+{
+  if (values.size() != m_values.size() || values == m_values)
+  {
+    return;
+  }
+  m_values = values;
+  updateColors();
+}
+
+SDL_Color DataMapOverlay::getColor(ColorRamp colorRamp, float value)
+{
+  if (value < 0.f)
+  {
+    return SDL_Color{0, 0, 0, 0};
+  }
+  value = std::min(value, 1.f);
+
+  switch (colorRamp)
+  {
+  case GREEN_RED:
+    return interpolate(GREEN_RED_STOPS, value);
+  case GRAYSCALE:
+    return interpolate(GRAYSCALE_STOPS, value);
+  case HEAT:
+  default:
+    return interpolate(HEAT_STOPS, value);
+  }
+}
+
+void DataMapOverlay::updateColors()
+{
+  for (size_t node = 0; node < m_values.size(); ++node)
+  {
+    m_colors[node] = getColor(m_colorRamp, m_values[node]);
+  }
+}
+
+void DataMapOverlay::render(const Map &map)
+{
+  if (m_dataMap == NONE)
+  {
+    return;
+  }
+
+  SDL_Renderer *renderer = WindowManager::instance().getRenderer();
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  const double zoomLevel = Camera::instance().zoomLevel();
+  const SDL_Point &tileSize = Camera::instance().tileSize();
+  const float width = static_cast<float>(tileSize.x * zoomLevel);
+  const float height = static_cast<float>(tileSize.y * zoomLevel);
+
+  m_vertices.clear();
+  m_indices.clear();
+  for (int x = 0; x < m_rows; ++x)
+  {
+    for (int y = 0; y < m_columns; ++y)
+    {
+      const SDL_Color &color = m_colors[x * m_columns + y];
+      const Point coordinates{x, y, 0, 0};
+
+      if (color.a == 0 || !map.isNodeVisible(coordinates))
+      {
+        continue;
+      }
+
+      // the screen coordinates of a node are the bottom corner of its diamond, raised by its height
+      const SDL_Point screen = convertIsoToScreenCoordinates(map.getMapNode(coordinates)->getCoordinates());
+      const float bottomX = static_cast<float>(screen.x);
+      const float bottomY = static_cast<float>(screen.y);
+      const int first = static_cast<int>(m_vertices.size());
+      m_vertices.push_back(SDL_Vertex{SDL_FPoint{bottomX, bottomY}, color, SDL_FPoint{0.f, 0.f}});
+      m_vertices.push_back(SDL_Vertex{SDL_FPoint{bottomX - width / 2, bottomY - height / 2}, color, SDL_FPoint{0.f, 0.f}});
+      m_vertices.push_back(SDL_Vertex{SDL_FPoint{bottomX, bottomY - height}, color, SDL_FPoint{0.f, 0.f}});
+      m_vertices.push_back(SDL_Vertex{SDL_FPoint{bottomX + width / 2, bottomY - height / 2}, color, SDL_FPoint{0.f, 0.f}});
+      for (int corner : {0, 1, 2, 0, 2, 3})
+      {
+        m_indices.push_back(first + corner);
+      }
+    }
+  }
+
+  if (!m_vertices.empty())
+  {
+    SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+    SDL_RenderGeometry(renderer, nullptr, m_vertices.data(), static_cast<int>(m_vertices.size()), m_indices.data(),
+                       static_cast<int>(m_indices.size()));
+  }
+#else
+  renderNodes(map, renderer);
+#endif
+}
+
+void DataMapOverlay::renderNodes(const Map &map, SDL_Renderer *renderer)
+{
+  const double zoomLevel = Camera::instance().zoomLevel();
+  const SDL_Point &tileSize = Camera::instance().tileSize();
+  const int width = std::max(1, static_cast<int>(tileSize.x * zoomLevel / 2));
+  const int height = std::max(1, static_cast<int>(tileSize.y * zoomLevel / 2));
+
+  m_coloredRects.clear();
+  for (int x = 0; x < m_rows; ++x)
+  {
+    for (int y = 0; y < m_columns; ++y)
+    {
+      const SDL_Color &color = m_colors[x * m_columns + y];
+      const Point coordinates{x, y, 0, 0};
+
+      if (color.a == 0 || !map.isNodeVisible(coordinates))
+      {
+        continue;
+      }
+
+      // the inner rectangle of the node's diamond, the screen coordinates are its bottom corner
+      const SDL_Point screen = convertIsoToScreenCoordinates(map.getMapNode(coordinates)->getCoordinates());
+      const SDL_Rect rect{screen.x - width / 2, screen.y - height - height / 2, width, height};
+      const uint32_t packedColor = static_cast<uint32_t>(color.r) << 24 | static_cast<uint32_t>(color.g) << 16 |
+                                   static_cast<uint32_t>(color.b) << 8 | color.a;
+      m_coloredRects.emplace_back(packedColor, rect);
+    }
+  }
+
+  std::sort(m_coloredRects.begin(), m_coloredRects.end(),
+            [](const std::pair<uint32_t, SDL_Rect> &a, const std::pair<uint32_t, SDL_Rect> &b) { return a.first < b.first; });
+
+  SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+  for (size_t begin = 0; begin < m_coloredRects.size();)
+  {
+    const uint32_t packedColor = m_coloredRects[begin].first;
+    m_rects.clear();
+    size_t end = begin;
+    for (; end < m_coloredRects.size() && m_coloredRects[end].first == packedColor; ++end)
+    {
+      m_rects.push_back(m_coloredRects[end].second);
+    }
+
+    SDL_SetRenderDrawColor(renderer, static_cast<Uint8>(packedColor >> 24), static_cast<Uint8>(packedColor >> 16),
+                           static_cast<Uint8>(packedColor >> 8), static_cast<Uint8>(packedColor));
+    SDL_RenderFillRects(renderer, m_rects.data(), static_cast<int>(m_rects.size()));
+    begin = end;
+  }
+}
@@ -0,0 +1,106 @@
+#ifndef DATAMAPOVERLAY_HXX_
+#define DATAMAPOVERLAY_HXX_
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <SDL.h>
+
+class Map;
+
+/** @brief Colored overlay that visualizes a simulation value for every node of the map.
+  * The values are converted with a color ramp into one color per node when they change. Every visible node is drawn as
+  * a diamond at its own height, so the overlay follows the terrain, and all diamonds are sent in a single batch.
+  */
+class DataMapOverlay
+{
+public:
+  /// The data that can be shown by the overlay
+  enum DataMap : unsigned int
+  {
+    NONE,
+    POWER,
+    WATER,
+    POLLUTION,
+    CRIME,
+    FIRE_HAZARD,
+    HAPPINESS,
+    EDUCATION,
+    POLICE_COVERAGE,
+    FIRE_COVERAGE,
+    EDUCATION_COVERAGE,
+    HEALTH_COVERAGE,
+    LAND_VALUE,
+    DATA_MAPS_COUNT
+  };
+
+  /// Color ramps that map a value between 0 and 1 to a color
+  enum ColorRamp : unsigned int
+  {
+    HEAT,      /// transparent blue over yellow to red
+    GREEN_RED, /// green for low values, red for high values
+    GRAYSCALE, /// black to white
+    COLOR_RAMPS_COUNT
+  };
+
+  /// Value of nodes that have no data, these nodes are not colored
+  static constexpr float NO_DATA = -1.f;
+
+  DataMapOverlay(int columns, int rows);
+
+  DataMap getDataMap() const { return m_dataMap; };
+  void setDataMap(DataMap dataMap);
+
+  /** @brief Switch to the next data map, NONE follows after the last one.
+    */
+  void nextDataMap() { setDataMap(static_cast<DataMap>((m_dataMap + 1) % DATA_MAPS_COUNT)); };
+
+  ColorRamp getColorRamp() const { return m_colorRamp; };
+  void setColorRamp(ColorRamp colorRamp);
+
+  /** @brief Set the values of all nodes.
+    * @param values values between 0 and 1 or NO_DATA, indexed like the map nodes.
+    */
+  void setValues(const std::vector<float> &values);
+
+  /** @brief Get the color the node is drawn with, transparent for nodes without data.
+    */
+  const SDL_Color &getNodeColor(int x, int y) const { return m_colors[x * m_columns + y]; };
+
+  /** @brief Get the color of a value.
+    * @param colorRamp the color ramp to use.
+    * @param value the value between 0 and 1, values outside are clamped. NO_DATA returns a transparent color.
+    */
+  static SDL_Color getColor(ColorRamp colorRamp, float value);
+
+  /** @brief Draw the overlay over the visible part of the map.
+    */
+  void render(const Map &map);
+
+private:
+  int m_columns;
+  int m_rows;
+  DataMap m_dataMap = NONE;
+  ColorRamp m_colorRamp = HEAT;
+  std::vector<float> m_values;
+  /// color of each node, indexed like the map nodes
+  std::vector<SDL_Color> m_colors;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  /// scratch buffers of the diamonds of the visible nodes
+  std::vector<SDL_Vertex> m_vertices;
+  std::vector<int> m_indices;
+#endif
+  /// scratch buffers of the fallback renderer, the packed color and rectangle of each visible node
+  std::vector<std::pair<uint32_t, SDL_Rect>> m_coloredRects;
+  std::vector<SDL_Rect> m_rects;
+
+  void updateColors();
+
+  /** @brief Draw the visible nodes as rectangles, for renderers without geometry support.
+    * The rectangles are grouped by their color, so every color is drawn with a single call.
+    */
+  void renderNodes(const Map &map, SDL_Renderer *renderer);
+};
+
+#endif
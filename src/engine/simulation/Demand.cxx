@@ -0,0 +1,125 @@
+#include "Demand.hxx"
+
+#include "CityStats.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+Demand::Demand(int columns, int rows)
+    : m_chunkColumns((columns + ReachChunkSize - 1) / ReachChunkSize),
+      m_chunkRows((rows + ReachChunkSize - 1) / ReachChunkSize), m_residents(m_chunkColumns * m_chunkRows, 0), m_shopsInReach(m_chunkColumns * m_chunkRows, 0)
+{
+}
+
+Demand::Zone Demand::getZone(const TileData &tileData)
+{
+  if (tileData.tileType != +TileType::RCI)
+  {
+    return ZONES_COUNT;
+  }
+  if (CityStats::isResidential(tileData))
+  {
+    return RESIDENTIAL;
+  }
+  if (std::find(tileData.zones.begin(), tileData.zones.end(), +Zones::COMMERCIAL) != tileData.zones.end())
+  {
+    return COMMERCIAL;
+  }
+  return INDUSTRIAL;
+}
+
+void Demand::addBuilding(int x, int y, const TileData &tileData, int sign)
+{
+  const int chunk = chunkIdx(x / ReachChunkSize, y / ReachChunkSize);
+
+  switch (getZone(tileData))
+  {
+  case RESIDENTIAL:
+    m_housing += sign * tileData.inhabitants;
+    m_residents[chunk] += sign * tileData.inhabitants;
+    if (m_shopsInReach[chunk] > 0)
+    {
+      m_customersInReach += sign * tileData.inhabitants;
+    }
+    break;
+  case COMMERCIAL:
+    m_jobs[COMMERCIAL] += sign * tileData.inhabitants;
+    addShop(x, y, sign);
+    break;
+  case INDUSTRIAL:
+    m_jobs[INDUSTRIAL] += sign * tileData.inhabitants;
+    break;
+  case ZONES_COUNT:
+    m_serviceJobs += sign * tileData.inhabitants;
+    break;
+  }
+}
+
+void Demand::addShop(int x, int y, int sign)
+{
+  const int chunkX = x / ReachChunkSize;
+  const int chunkY = y / ReachChunkSize;
+
+  for (int neighborX = std::max(0, chunkX - 1); neighborX <= std::min(m_chunkRows - 1, chunkX + 1); ++neighborX)
+  {
+    for (int neighborY = std::max(0, chunkY - 1); neighborY <= std::min(m_chunkColumns - 1, chunkY + 1); ++neighborY)
+    {
+      const int chunk = chunkIdx(neighborX, neighborY);
+      // the residents of a chunk are customers as long as one shop reaches them
+      if (m_shopsInReach[chunk] == 0 && sign > 0)
+      {
+        m_customersInReach += m_residents[chunk];
+      }
+      m_shopsInReach[chunk] += sign;
+      if (m_shopsInReach[chunk] == 0)
+      {
+        m_customersInReach -= m_residents[chunk];
+      }
+    }
+  }
+}
+
+float Demand::getInstantDemand(Zone zone) const
+{
+  const int residents = m_housing;
+  const int jobs = getJobs();
+  const float employmentRate = residents > 0 ? static_cast<float>(m_employed) / residents : 1.f;
+  // shops need residents to shop, but they are needed most where no shop reaches the residents yet
+  const int commercialTarget = (residents + m_customersInReach) / (2 * CustomersPerJob);
+
+  float raw = 0;
+  switch (zone)
+  {
+  case RESIDENTIAL:
+    // free jobs attract residents, new residents keep coming as long as they find work
+    raw = static_cast<float>(jobs - residents) + BaseResidentialDemand * employmentRate;
+    break;
+  case COMMERCIAL:
+    raw = static_cast<float>(commercialTarget - m_jobs[COMMERCIAL]);
+    break;
+  case INDUSTRIAL:
+  default:
+    // the industry employs everyone who doesn't work in shops or services
+    raw = static_cast<float>(residents - commercialTarget - m_serviceJobs - m_jobs[INDUSTRIAL] + BaseIndustrialDemand);
+    break;
+  }
+
+  const float halfSaturation = static_cast<float>(std::max(MinHalfSaturation, (residents + jobs) / 8));
+  return raw / (std::abs(raw) + halfSaturation);
+}
+
+void Demand::updateDay()
+{
+  for (unsigned int zone = 0; zone < ZONES_COUNT; ++zone)
+  {
+    m_demand[zone] += DailySmoothing * (getInstantDemand(static_cast<Zone>(zone)) - m_demand[zone]);
+  }
+}
+
+void Demand::resetAverage()
+{
+  for (unsigned int zone = 0; zone < ZONES_COUNT; ++zone)
+  {
+    m_demand[zone] = getInstantDemand(static_cast<Zone>(zone));
+  }
+}
@@ -0,0 +1,101 @@
+#ifndef DEMAND_HXX_
+#define DEMAND_HXX_
+
+#include <array>
+#include <vector>
+
+#include "basics/tileData.hxx"
+
+/** @brief Residential, commercial and industrial demand of the city.
+  * The demand follows from counters of the housing capacity, the jobs per zone type, the employed residents and the
+  * residents that have shops in reach. The counters are updated in O(1) whenever a building changes, so computing the
+  * demand never walks the buildings. The demand is smoothed with an exponential moving average once per game day.
+  */
+class Demand
+{
+public:
+  enum Zone : unsigned int
+  {
+    RESIDENTIAL,
+    COMMERCIAL,
+    /// industrial and agricultural
+    INDUSTRIAL,
+    ZONES_COUNT
+  };
+
+  /// Shops reach the residents of their own chunk and the 8 chunks around it
+  static constexpr int ReachChunkSize = 16;
+  /// Number of residents one commercial job serves
+  static constexpr int CustomersPerJob = 4;
+  /// Demand of a city without buildings, in residents or jobs
+  static constexpr int BaseResidentialDemand = 40;
+  static constexpr int BaseIndustrialDemand = 20;
+  /// Smallest difference between supply and demand that results in half of the maximum demand
+  static constexpr int MinHalfSaturation = 20;
+  /// Weight of the demand of the current day in the moving average
+  static constexpr float DailySmoothing = 0.2f;
+
+  Demand(int columns, int rows);
+
+  /** @brief Get the zone a building grows in, or ZONES_COUNT for buildings that don't grow in zones.
+    */
+  static Zone getZone(const TileData &tileData);
+
+  /** @brief Add or remove a building with its origin at (x, y).
+    * @param sign 1 to add the building, -1 to remove it.
+    */
+  void addBuilding(int x, int y, const TileData &tileData, int sign);
+
+  /** @brief Set the number of residents that have a job.
+    */
+  void setEmployed(int employed) { m_employed = employed; };
+
+  /** @brief Compute the demand of today and add it to the moving average.
+    */
+  void updateDay();
+
+  /** @brief Start the moving average at the demand of today, e.g. after a map has been loaded.
+    */
+  void resetAverage();
+
+  /** @brief Get the smoothed demand of a zone, between -1 (oversupplied) and 1 (everything sells).
+    */
+  float getDemand(Zone zone) const { return m_demand[zone]; };
+
+  /** @brief Get the demand of a zone without smoothing, between -1 and 1.
+    */
+  float getInstantDemand(Zone zone) const;
+
+  /** @brief Get the chance that a building spawns on an empty node of a zone, between 0 and 1.
+    */
+  float getSpawnWeight(Zone zone) const { return m_demand[zone] > 0.f ? m_demand[zone] : 0.f; };
+
+  int getHousing() const { return m_housing; };
+  /// Jobs of the commercial or industrial zone
+  int getJobs(Zone zone) const { return m_jobs[zone]; };
+  /// Jobs of all buildings, including those outside of zones like schools
+  int getJobs() const { return m_jobs[COMMERCIAL] + m_jobs[INDUSTRIAL] + m_serviceJobs; };
+  int getEmployed() const { return m_employed; };
+  int getCustomersInReach() const { return m_customersInReach; };
+
+private:
+  int m_chunkColumns;
+  int m_chunkRows;
+  int m_housing = 0;
+  /// jobs of the commercial and industrial zone, the residential zone has none
+  std::array<int, ZONES_COUNT> m_jobs{};
+  /// jobs of the buildings outside of zones
+  int m_serviceJobs = 0;
+  int m_employed = 0;
+  int m_customersInReach = 0;
+  /// housing capacity per chunk
+  std::vector<int> m_residents;
+  /// number of commercial buildings in each chunk and the chunks around it
+  std::vector<int> m_shopsInReach;
+  std::array<float, ZONES_COUNT> m_demand{};
+
+  int chunkIdx(int chunkX, int chunkY) const { return chunkX * m_chunkColumns + chunkY; };
+  void addShop(int x, int y, int sign);
+};
+
+#endif
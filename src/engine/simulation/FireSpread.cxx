@@ -0,0 +1,189 @@
+#include "FireSpread.hxx"
+
+#include "tileData.hxx"
+
+#include <algorithm>
+
+namespace
+{
+/// Spreading uses 17 bit random numbers, so a single fully flammable burning neighbor ignites a node half of the time
+constexpr int SPREAD_RANDOM_SHIFT = 15;
+/// Sparks use 20 bit random numbers, a fully flammable node catches fire from a spark with a chance of about 6%
+constexpr uint32_t SPARK_RANDOM_MASK = 0xFFFFF;
+
+/// Integer hash with good avalanche behavior, used as counter based random number generator
+inline uint32_t mix(uint32_t hash)
+{
+  hash ^= hash >> 16;
+  hash *= 0x7FEB352Du;
+  hash ^= hash >> 15;
+  hash *= 0x846CA68Bu;
+  hash ^= hash >> 16;
+  return hash;
+}
+} // namespace
+
+FireSpread::FireSpread(int columns, int rows, uint32_t seed)
+    : m_columns(columns), m_rows(rows), m_stride(columns + 2), m_chunkColumns((columns + ChunkSize - 1) / ChunkSize),
+      m_chunkRows((rows + ChunkSize - 1) / ChunkSize), m_seed(seed)
+{
+  const size_t paddedSize = static_cast<size_t>(m_stride) * (rows + 2);
+  m_flammability.assign(paddedSize, 0);
+  m_suppression.assign(paddedSize, 0);
+  m_state[0].assign(paddedSize, 0);
+  m_state[1].assign(paddedSize, 0);
+  m_active.assign(m_chunkColumns * m_chunkRows, 0);
+  m_previousActive.assign(m_chunkColumns * m_chunkRows, 0);
+}
+
+uint8_t FireSpread::getFlammability(const TileData &tileData)
+{
+  // roads, power lines and ground decoration don't burn
+  if (tileData.tileType != +TileType::DEFAULT && tileData.tileType != +TileType::RCI)
+  {
+    return 0;
+  }
+  return static_cast<uint8_t>(std::max(0, std::min(255, 64 + 16 * tileData.fireHazardLevel)));
+}
+
+void FireSpread::ignite(int x, int y)
+{
+  const int node = paddedIdx(x, y);
+
+  if (m_flammability[node] != 0 && m_state[m_current][node] == 0)
+  {
+    m_state[m_current][node] = BurnDuration;
+    m_active[chunkIdx(x, y)] = 1;
+  }
+}
+
+bool FireSpread::trySpark()
+{
+  ++m_sparks;
+  const uint32_t position = mix(m_seed ^ mix(m_sparks * 2));
+  const uint32_t chance = mix(m_seed ^ mix(m_sparks * 2 + 1)) & SPARK_RANDOM_MASK;
+  const int x = static_cast<int>(position % static_cast<uint32_t>(m_rows));
+  const int y = static_cast<int>((position / static_cast<uint32_t>(m_rows)) % static_cast<uint32_t>(m_columns));
+  const int node = paddedIdx(x, y);
+
+  if (chance < static_cast<uint32_t>(m_flammability[node]) * (255u - m_suppression[node]) &&
+      m_state[m_current][node] == 0)
+  {
+    ignite(x, y);
+    return true;
+  }
+  return false;
+}
+
+bool FireSpread::shouldProcess(int chunkX, int chunkY) const
+{
+  const int chunk = chunkX * m_chunkColumns + chunkY;
+
+  // the chunks that burned in the previous state still hold that state in the buffer that is written now
+  return m_active[chunk] || m_previousActive[chunk] || (chunkX > 0 && m_active[chunk - m_chunkColumns]) ||
+         (chunkX < m_chunkRows - 1 && m_active[chunk + m_chunkColumns]) || (chunkY > 0 && m_active[chunk - 1]) ||
+         (chunkY < m_chunkColumns - 1 && m_active[chunk + 1]);
+}
+
+void FireSpread::step()
+{
+  std::vector<int> chunks;
+  for (int chunkX = 0; chunkX < m_chunkRows; ++chunkX)
+  {
+    for (int chunkY = 0; chunkY < m_chunkColumns; ++chunkY)
+    {
+      if (shouldProcess(chunkX, chunkY))
+      {
+        chunks.push_back(chunkX * m_chunkColumns + chunkY);
+      }
+    }
+  }
+
+  // the flags of the previous state are not needed anymore, reuse them for the next state
+  std::fill(m_previousActive.begin(), m_previousActive.end(), 0);
+  for (int chunk : chunks)
+  {
+    m_previousActive[chunk] = stepChunk(chunk / m_chunkColumns, chunk % m_chunkColumns);
+  }
+
+  std::swap(m_active, m_previousActive);
+  m_current = 1 - m_current;
+  m_processedChunks = chunks.size();
+  ++m_step;
+}
+
+bool FireSpread::stepChunk(int chunkX, int chunkY)
+{
+  const uint8_t *current = m_state[m_current].data();
+  uint8_t *next = m_state[1 - m_current].data();
+  const uint8_t *flammability = m_flammability.data();
+  const uint8_t *suppression = m_suppression.data();
+  const uint32_t stepSeed = mix(m_seed ^ mix(m_step));
+  const int stride = m_stride;
+  const int firstY = chunkY * ChunkSize;
+  const int width = std::min(ChunkSize, m_columns - firstY);
+  uint8_t anyBurning = 0;
+
+  for (int x = chunkX * ChunkSize; x < std::min((chunkX + 1) * ChunkSize, m_rows); ++x)
+  {
+    const int begin = paddedIdx(x, firstY);
+    const int end = begin + width;
+    uint8_t anyBurntOut = 0;
+
+    // branch free kernel, so the compiler can vectorize it
+    for (int i = begin; i < end; ++i)
+    {
+      const uint32_t neighbors =
+          (current[i - stride] != 0) + (current[i + stride] != 0) + (current[i - 1] != 0) + (current[i + 1] != 0);
+      const uint32_t chance = neighbors * flammability[i] * (255u - suppression[i]);
+      const uint32_t random = mix(static_cast<uint32_t>(i) * 0x9E3779B1u ^ stepSeed) >> SPREAD_RANDOM_SHIFT;
+      const uint8_t burning = current[i] != 0;
+      const uint8_t ignite = static_cast<uint8_t>((burning ^ 1) & (random < chance));
+      const uint8_t state = static_cast<uint8_t>(current[i] - burning + ignite * BurnDuration);
+      next[i] = state;
+      anyBurning |= state;
+      anyBurntOut |= static_cast<uint8_t>(current[i] == 1);
+    }
+
+    if (anyBurntOut)
+    {
+      for (int i = begin; i < end; ++i)
+      {
+        if (current[i] == 1)
+        {
+          m_flammability[i] = 0;
+          m_burntOut.push_back(Point{x, firstY + (i - begin), 0, 0});
+        }
+      }
+    }
+  }
+
+  return anyBurning != 0;
+}
+
+void FireSpread::getBurningNodes(std::vector<Point> &nodes) const
+{
+  nodes.clear();
+  const std::vector<uint8_t> &state = m_state[m_current];
+
+  for (int chunk = 0; chunk < static_cast<int>(m_active.size()); ++chunk)
+  {
+    if (!m_active[chunk])
+    {
+      continue;
+    }
+
+    const int firstX = (chunk / m_chunkColumns) * ChunkSize;
+    const int firstY = (chunk % m_chunkColumns) * ChunkSize;
+    for (int x = firstX; x < std::min(firstX + ChunkSize, m_rows); ++x)
+    {
+      for (int y = firstY; y < std::min(firstY + ChunkSize, m_columns); ++y)
+      {
+        if (state[paddedIdx(x, y)] != 0)
+        {
+          nodes.push_back(Point{x, y, 0, 0});
+        }
+      }
+    }
+  }
+}
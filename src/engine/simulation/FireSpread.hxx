@@ -0,0 +1,95 @@
+#ifndef FIRESPREAD_HXX_
+#define FIRESPREAD_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "basics/point.hxx"
+
+struct TileData;
+
+/** @brief Cellular automaton that spreads fires between buildings.
+  * Every node has a flammability, a fire suppression from nearby fire stations and a burn state, stored in byte grids
+  * with a border of one node, so the neighbor kernel needs no bounds checks. The burn state is double buffered.
+  * Only chunks that are burning, their neighbors and the chunks that burned in the previous step are processed.
+  * Random numbers are derived from the seed, the step and the node, so the automaton is deterministic.
+  */
+class FireSpread
+{
+public:
+  /// Number of steps a node burns before it is burnt out
+  static constexpr uint8_t BurnDuration = 8;
+  /// Width and height of the chunks that are processed as a whole
+  static constexpr int ChunkSize = 16;
+
+  FireSpread(int columns, int rows, uint32_t seed = 0);
+
+  void setSeed(uint32_t seed) { m_seed = seed; };
+
+  /** @brief Get the flammability of a tile, between 0 and 255.
+    */
+  static uint8_t getFlammability(const TileData &tileData);
+
+  void setFlammability(int x, int y, uint8_t flammability) { m_flammability[paddedIdx(x, y)] = flammability; };
+
+  /** @brief Set how well fires are suppressed at a node, 255 prevents the spread of fires completely.
+    */
+  void setSuppression(int x, int y, uint8_t suppression) { m_suppression[paddedIdx(x, y)] = suppression; };
+
+  /** @brief Set a node on fire, if it is flammable.
+    */
+  void ignite(int x, int y);
+
+  /** @brief Try to start a fire at a random node.
+    * The chance depends on the flammability and suppression of the node.
+    * @return whether a fire has been started.
+    */
+  bool trySpark();
+
+  /** @brief Advance all fires by one step.
+    */
+  void step();
+
+  bool isBurning(int x, int y) const { return m_state[m_current][paddedIdx(x, y)] != 0; };
+
+  /** @brief Get the coordinates of all burning nodes.
+    */
+  void getBurningNodes(std::vector<Point> &nodes) const;
+
+  /** @brief Get the nodes that burnt out since the last call to clearBurntOutNodes().
+    */
+  const std::vector<Point> &getBurntOutNodes() const { return m_burntOut; };
+  void clearBurntOutNodes() { m_burntOut.clear(); };
+
+  /** @brief Get the number of chunks that have been processed in the last step, for profiling.
+    */
+  size_t getProcessedChunkCount() const { return m_processedChunks; };
+
+private:
+  int m_columns;
+  int m_rows;
+  int m_stride;
+  int m_chunkColumns;
+  int m_chunkRows;
+  uint32_t m_seed;
+  uint32_t m_step = 0;
+  uint32_t m_sparks = 0;
+  std::vector<uint8_t> m_flammability;
+  std::vector<uint8_t> m_suppression;
+  /// remaining burn time of each node, 0 if it doesn't burn
+  std::vector<uint8_t> m_state[2];
+  int m_current = 0;
+  /// chunks with burning nodes in the current and the previous state
+  std::vector<uint8_t> m_active;
+  std::vector<uint8_t> m_previousActive;
+  std::vector<Point> m_burntOut;
+  size_t m_processedChunks = 0;
+
+  int paddedIdx(int x, int y) const { return (x + 1) * m_stride + y + 1; };
+  int chunkIdx(int x, int y) const { return (x / ChunkSize) * m_chunkColumns + y / ChunkSize; };
+  bool shouldProcess(int chunkX, int chunkY) const;
+  bool stepChunk(int chunkX, int chunkY);
+};
+
+#endif
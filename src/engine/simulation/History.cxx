@@ -0,0 +1,41 @@
+#include "History.hxx"
+
+#include "ByteStream.hxx"
+#include "CityStats.hxx"
+
+void History::record(const CityStats &stats)
+{
+  m_series[POPULATION].push(stats.getPopulation());
+  m_series[JOBS].push(stats.getJobs());
+  m_series[UPKEEP].push(stats.getUpkeep());
+  m_series[POWER_PRODUCTION].push(stats.getPowerProduction());
+  m_series[POWER_CONSUMPTION].push(stats.getPowerConsumption());
+  m_series[WATER_PRODUCTION].push(stats.getWaterProduction());
+  m_series[WATER_CONSUMPTION].push(stats.getWaterConsumption());
+  m_series[BUILDINGS].push(stats.getBuildingCount());
+}
+
+void History::save(ByteWriter &writer) const
+{
+  writer.writeVarint(METRICS_COUNT);
+
+  for (const TimeSeries &series : m_series)
+  {
+    series.save(writer);
+  }
+}
+
+void History::load(ByteReader &reader)
+{
+  const uint64_t metrics = reader.readVarint();
+  if (metrics > METRICS_COUNT)
+  {
+    throw CytopiaError{TRACE_INFO "Unknown metrics in history"};
+  }
+
+  // metrics that have been added after the data has been saved stay empty
+  for (uint64_t metric = 0; metric < metrics; ++metric)
+  {
+    m_series[metric].load(reader);
+  }
+}
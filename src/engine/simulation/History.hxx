@@ -0,0 +1,50 @@
+#ifndef HISTORY_HXX_
+#define HISTORY_HXX_
+
+#include <array>
+
+#include "TimeSeries.hxx"
+
+class ByteReader;
+class ByteWriter;
+class CityStats;
+
+/** @brief Daily history of the city statistics, used for graphs.
+  * Every metric is stored in a TimeSeries, so the memory usage stays bounded no matter how long the game is played.
+  */
+class History
+{
+public:
+  enum Metric : unsigned int
+  {
+    POPULATION,
+    JOBS,
+    UPKEEP,
+    POWER_PRODUCTION,
+    POWER_CONSUMPTION,
+    WATER_PRODUCTION,
+    WATER_CONSUMPTION,
+    BUILDINGS,
+    METRICS_COUNT
+  };
+
+  /** @brief Record the statistics of one day.
+    */
+  void record(const CityStats &stats);
+
+  const TimeSeries &getSeries(Metric metric) const { return m_series[metric]; };
+
+  /** @brief Write the compressed history.
+    */
+  void save(ByteWriter &writer) const;
+
+  /** @brief Restore the history written by save().
+    * @throws CytopiaError if the data is malformed.
+    */
+  void load(ByteReader &reader);
+
+private:
+  std::array<TimeSeries, METRICS_COUNT> m_series;
+};
+
+#endif
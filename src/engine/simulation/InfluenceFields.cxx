@@ -0,0 +1,168 @@
+#include "InfluenceFields.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+InfluenceFields::InfluenceFields(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_tileColumns((columns + TileSize - 1) / TileSize),
+      m_tileRows((rows + TileSize - 1) / TileSize)
+{
+  for (unsigned int field = 0; field < FIELDS_COUNT; ++field)
+  {
+    m_sources[field].assign(columns * rows, 0);
+    m_fields[field].assign(columns * rows, 0);
+    m_dirtyTiles[field].assign(m_tileColumns * m_tileRows, false);
+
+    // blur a single impulse to find the peak of the kernel
+    const int radius = getRadius(static_cast<Field>(field));
+    const int size = 2 * BlurPasses * radius + 1;
+    std::vector<double> impulse(size * size, 0.0);
+    impulse[(size / 2) * size + size / 2] = 1.0;
+    blur(impulse, size, size, radius);
+    m_gain[field] = 1.0 / impulse[(size / 2) * size + size / 2];
+  }
+}
+
+int InfluenceFields::getRadius(Field field)
+{
+  switch (field)
+  {
+  case POLLUTION:
+    return 4;
+  case CRIME:
+    return 3;
+  case FIRE_HAZARD:
+    return 2;
+  case HAPPINESS:
+    return 3;
+  case EDUCATION:
+    return 5;
+  default:
+    return 1;
+  }
+}
+
+void InfluenceFields::addSource(int x, int y, Field field, int level)
+{
+  if (level == 0)
+  {
+    return;
+  }
+
+  m_sources[field][nodeIdx(x, y)] += level;
+
+  // mark all tiles within reach of the source
+  const int reach = BlurPasses * getRadius(field);
+  const int firstTileX = std::max(0, x - reach) / TileSize;
+  const int lastTileX = std::min(m_rows - 1, x + reach) / TileSize;
+  const int firstTileY = std::max(0, y - reach) / TileSize;
+  const int lastTileY = std::min(m_columns - 1, y + reach) / TileSize;
+
+  for (int tileX = firstTileX; tileX <= lastTileX; ++tileX)
+  {
+    for (int tileY = firstTileY; tileY <= lastTileY; ++tileY)
+    {
+      m_dirtyTiles[field][tileX * m_tileColumns + tileY] = true;
+    }
+  }
+}
+
+void InfluenceFields::update()
+{
+  m_updatedTiles.clear();
+
+  for (int tileX = 0; tileX < m_tileRows; ++tileX)
+  {
+    for (int tileY = 0; tileY < m_tileColumns; ++tileY)
+    {
+      const int tile = tileX * m_tileColumns + tileY;
+      bool updated = false;
+
+      for (unsigned int field = 0; field < FIELDS_COUNT; ++field)
+      {
+        if (m_dirtyTiles[field][tile])
+        {
+          blurTile(static_cast<Field>(field), tileX, tileY);
+          m_dirtyTiles[field][tile] = false;
+          updated = true;
+        }
+      }
+
+      if (updated)
+      {
+        m_updatedTiles.push_back(tile);
+      }
+    }
+  }
+}
+
+void InfluenceFields::blur(std::vector<double> &window, int width, int height, int radius)
+{
+  const int stride = height + 1;
+  const double area = static_cast<double>((2 * radius + 1) * (2 * radius + 1));
+  m_sums.assign((width + 1) * stride, 0.0);
+
+  for (int pass = 0; pass < BlurPasses; ++pass)
+  {
+    // summed area table, m_sums[(i + 1) * stride + (j + 1)] holds the sum of all values up to (i, j)
+    for (int i = 0; i < width; ++i)
+    {
+      double rowSum = 0.0;
+      for (int j = 0; j < height; ++j)
+      {
+        rowSum += window[i * height + j];
+        m_sums[(i + 1) * stride + j + 1] = m_sums[i * stride + j + 1] + rowSum;
+      }
+    }
+
+    // everything outside of the window counts as zero
+    for (int i = 0; i < width; ++i)
+    {
+      const int i0 = std::max(0, i - radius);
+      const int i1 = std::min(width, i + radius + 1);
+      for (int j = 0; j < height; ++j)
+      {
+        const int j0 = std::max(0, j - radius);
+        const int j1 = std::min(height, j + radius + 1);
+        const double sum = m_sums[i1 * stride + j1] - m_sums[i0 * stride + j1] - m_sums[i1 * stride + j0] + m_sums[i0 * stride + j0];
+        window[i * height + j] = sum / area;
+      }
+    }
+  }
+}
+
+void InfluenceFields::blurTile(Field field, int tileX, int tileY)
+{
+  // the tile depends on all sources within the reach of the blurs
+  const int reach = BlurPasses * getRadius(field);
+  const int x0 = tileX * TileSize - reach;
+  const int y0 = tileY * TileSize - reach;
+  const int x1 = std::min(m_rows, (tileX + 1) * TileSize) + reach;
+  const int y1 = std::min(m_columns, (tileY + 1) * TileSize) + reach;
+  const int width = x1 - x0;
+  const int height = y1 - y0;
+
+  m_window.assign(width * height, 0.0);
+  for (int x = std::max(0, x0); x < std::min(m_rows, x1); ++x)
+  {
+    for (int y = std::max(0, y0); y < std::min(m_columns, y1); ++y)
+    {
+      m_window[(x - x0) * height + (y - y0)] = m_sources[field][nodeIdx(x, y)];
+    }
+  }
+
+  blur(m_window, width, height, getRadius(field));
+
+  const double scale = m_gain[field] * (1 << FixedPointShift);
+  for (int x = tileX * TileSize; x < std::min(m_rows, (tileX + 1) * TileSize); ++x)
+  {
+    for (int y = tileY * TileSize; y < std::min(m_columns, (tileY + 1) * TileSize); ++y)
+    {
+      const double value = std::round(m_window[(x - x0) * height + (y - y0)] * scale);
+      m_fields[field][nodeIdx(x, y)] = static_cast<int16_t>(std::clamp(
+          value, static_cast<double>(std::numeric_limits<int16_t>::min()), static_cast<double>(std::numeric_limits<int16_t>::max())));
+    }
+  }
+  m_blurredTileCount++;
+}
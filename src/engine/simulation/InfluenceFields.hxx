@@ -0,0 +1,95 @@
+#ifndef INFLUENCEFIELDS_HXX_
+#define INFLUENCEFIELDS_HXX_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @brief Scalar fields of the influence buildings have on their surroundings.
+  * Every building adds its level of pollution, crime, ... to its origin node. The fields are the result of repeated
+  * box blurs of these sources, which approximate a smooth, radius limited falloff around each building. Each box blur
+  * is evaluated with a summed area table.
+  * The fields are split into tiles and only the tiles within reach of a changed source are blurred again.
+  * Results are stored in fixed point with FixedPointShift fractional bits.
+  */
+class InfluenceFields
+{
+public:
+  enum Field : unsigned int
+  {
+    POLLUTION,
+    CRIME,
+    FIRE_HAZARD,
+    HAPPINESS,
+    EDUCATION,
+    FIELDS_COUNT
+  };
+
+  static constexpr int FixedPointShift = 4;
+  static constexpr int TileSize = 16;
+  static constexpr int BlurPasses = 3;
+
+  InfluenceFields(int columns, int rows);
+
+  /** @brief Add to the source level of a node.
+    * @param x the x coordinate of the node.
+    * @param y the y coordinate of the node.
+    * @param field the affected field.
+    * @param level the level to add, negative to remove a building.
+    */
+  void addSource(int x, int y, Field field, int level);
+
+  /** @brief Blur all tiles that are affected by changed sources.
+    */
+  void update();
+
+  /** @brief Get the value of a field at a node.
+    * A building's own node has roughly the building's level, it falls off to zero at BlurPasses * radius.
+    */
+  float getValue(Field field, int x, int y) const
+  {
+    return static_cast<float>(m_fields[field][nodeIdx(x, y)]) / (1 << FixedPointShift);
+  };
+
+  /** @brief Get the fixed point values of a field, indexed like the map nodes.
+    */
+  const std::vector<int16_t> &getField(Field field) const { return m_fields[field]; };
+
+  /** @brief Get the tiles that have been blurred by the last update, as tileX * tile columns + tileY.
+    * Tile tileX, tileY covers the nodes from tileX * TileSize, tileY * TileSize on.
+    */
+  const std::vector<int> &getUpdatedTiles() const { return m_updatedTiles; };
+  int getTileColumns() const { return m_tileColumns; };
+
+  /** @brief Get the radius of a single box blur for a field.
+    */
+  static int getRadius(Field field);
+
+  /** @brief Get the number of tiles blurred since the construction, for profiling.
+    */
+  size_t getBlurredTileCount() const { return m_blurredTileCount; };
+
+private:
+  int m_columns;
+  int m_rows;
+  int m_tileColumns;
+  int m_tileRows;
+  std::array<std::vector<int32_t>, FIELDS_COUNT> m_sources;
+  std::array<std::vector<int16_t>, FIELDS_COUNT> m_fields;
+  std::array<std::vector<bool>, FIELDS_COUNT> m_dirtyTiles;
+  /// factor that scales the peak of the blurred kernel to 1
+  std::array<double, FIELDS_COUNT> m_gain;
+  size_t m_blurredTileCount = 0;
+  std::vector<int> m_updatedTiles;
+
+  /// scratch buffers for blurring a tile
+  std::vector<double> m_window;
+  std::vector<double> m_sums;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  void blur(std::vector<double> &window, int width, int height, int radius);
+  void blurTile(Field field, int tileX, int tileY);
+};
+
+#endif
@@ -0,0 +1,299 @@
+#include "JobMarket.hxx"
+
+#include <algorithm>
+#include <cstdlib>
+
+JobMarket::JobMarket(int columns, int rows)
+    : m_columns(columns), m_chunkColumns((columns + ChunkSize - 1) / ChunkSize),
+      m_chunkRows((rows + ChunkSize - 1) / ChunkSize), m_buckets(m_chunkColumns * m_chunkRows * EducationTiers)
+{
+}
+
+int JobMarket::getTier(int educationLevel) { return std::clamp(educationLevel, 0, EducationTiers - 1); }
+
+int JobMarket::getCommute(const Point &from, const Point &to) const
+{
+  if (m_commute)
+  {
+    return m_commute(from, to);
+  }
+  return std::abs(from.x - to.x) + std::abs(from.y - to.y);
+}
+
+void JobMarket::addHousing(int x, int y, int residents, int educationLevel)
+{
+  const Point origin{x, y, 0, 0};
+  const int node = nodeIdx(origin);
+  removeHousing(x, y);
+
+  m_housing.emplace(node, Housing{origin, residents, getTier(educationLevel)});
+  m_residents += residents;
+  if (residents > 0)
+  {
+    m_pending.push_back(node);
+  }
+}
+
+void JobMarket::removeHousing(int x, int y)
+{
+  const int node = nodeIdx({x, y, 0, 0});
+  auto it = m_housing.find(node);
+
+  if (it == m_housing.end())
+  {
+    return;
+  }
+
+  for (const Match &job : it->second.jobs)
+  {
+    Workplace &workplace = m_workplaces.at(job.node);
+    int count;
+    int commute;
+    removeMatch(workplace.workers, node, count, commute);
+    workplace.filled -= count;
+    addToBucket(job.node, workplace);
+    m_employed -= count;
+    m_totalCommute -= static_cast<long long>(count) * commute;
+    m_openedWorkplaces.push_back(job.node);
+  }
+
+  m_residents -= it->second.residents;
+  m_housing.erase(it);
+}
+
+void JobMarket::addWorkplace(int x, int y, int jobs, int educationLevel)
+{
+  const Point origin{x, y, 0, 0};
+  const int node = nodeIdx(origin);
+  removeWorkplace(x, y);
+
+  Workplace &workplace = m_workplaces.emplace(node, Workplace{origin, jobs, getTier(educationLevel)}).first->second;
+  m_jobs += jobs;
+  if (jobs > 0)
+  {
+    addToBucket(node, workplace);
+    m_openedWorkplaces.push_back(node);
+  }
+}
+
+void JobMarket::removeWorkplace(int x, int y)
+{
+  const int node = nodeIdx({x, y, 0, 0});
+  auto it = m_workplaces.find(node);
+
+  if (it == m_workplaces.end())
+  {
+    return;
+  }
+
+  for (const Match &worker : it->second.workers)
+  {
+    Housing &housing = m_housing.at(worker.node);
+    int count;
+    int commute;
+    removeMatch(housing.jobs, node, count, commute);
+    housing.employed -= count;
+    m_employed -= count;
+    m_totalCommute -= static_cast<long long>(count) * commute;
+    m_pending.push_back(worker.node);
+  }
+
+  removeFromBucket(node, it->second);
+  m_jobs -= it->second.jobs;
+  m_workplaces.erase(it);
+}
+
+void JobMarket::update()
+{
+  // match in a fixed order, so the result doesn't depend on the order of the hash maps
+  std::sort(m_pending.begin(), m_pending.end());
+  m_pending.erase(std::unique(m_pending.begin(), m_pending.end()), m_pending.end());
+
+  for (int node : m_pending)
+  {
+    auto it = m_housing.find(node);
+    if (it != m_housing.end() && it->second.employed < it->second.residents)
+    {
+      findJobs(node, it->second);
+    }
+  }
+
+  // the new jobs can be in reach of any unemployed resident, the pending ones have seen them already
+  m_openedWorkplaces.erase(std::remove_if(m_openedWorkplaces.begin(), m_openedWorkplaces.end(),
+                                          [this](int node) {
+                                            auto it = m_workplaces.find(node);
+                                            return it == m_workplaces.end() || it->second.filled == it->second.jobs;
+                                          }),
+                           m_openedWorkplaces.end());
+  if (!m_openedWorkplaces.empty())
+  {
+    std::sort(m_openedWorkplaces.begin(), m_openedWorkplaces.end());
+    m_openedWorkplaces.erase(std::unique(m_openedWorkplaces.begin(), m_openedWorkplaces.end()), m_openedWorkplaces.end());
+
+    std::vector<int> unemployed;
+    for (const auto &[node, housing] : m_housing)
+    {
+      if (housing.employed < housing.residents && !std::binary_search(m_pending.begin(), m_pending.end(), node))
+      {
+        unemployed.push_back(node);
+      }
+    }
+    std::sort(unemployed.begin(), unemployed.end());
+    for (int node : unemployed)
+    {
+      findOpenedJobs(node, m_housing.at(node));
+    }
+  }
+
+  m_pending.clear();
+  m_openedWorkplaces.clear();
+}
+
+void JobMarket::findJobs(int node, Housing &housing)
+{
+  const int chunkX = housing.origin.x / ChunkSize;
+  const int chunkY = housing.origin.y / ChunkSize;
+  const int maxRing = std::max(m_chunkRows, m_chunkColumns);
+
+  for (int ring = 0; ring <= maxRing && housing.employed < housing.residents; ++ring)
+  {
+    m_candidates.clear();
+
+    for (int x = chunkX - ring; x <= chunkX + ring; ++x)
+    {
+      if (x < 0 || x >= m_chunkRows)
+      {
+        continue;
+      }
+
+      // inner rows of the ring only have a chunk on the left and on the right
+      const int stepY = (std::abs(x - chunkX) == ring || ring == 0) ? 1 : 2 * ring;
+      for (int y = chunkY - ring; y <= chunkY + ring; y += stepY)
+      {
+        if (y < 0 || y >= m_chunkColumns)
+        {
+          continue;
+        }
+
+        const Point chunkOrigin{x * ChunkSize, y * ChunkSize, 0, 0};
+        for (int tier = 0; tier <= housing.tier; ++tier)
+        {
+          for (int workplaceNode : m_buckets[bucketIdx(chunkOrigin, tier)])
+          {
+            const int commute = getCommute(housing.origin, m_workplaces.at(workplaceNode).origin);
+            if (commute != UNREACHABLE)
+            {
+              m_candidates.emplace_back(commute, workplaceNode);
+            }
+          }
+        }
+      }
+    }
+
+    std::sort(m_candidates.begin(), m_candidates.end());
+    takeJobs(node, housing, m_candidates);
+  }
+}
+
+void JobMarket::findOpenedJobs(int node, Housing &housing)
+{
+  m_candidates.clear();
+  for (int workplaceNode : m_openedWorkplaces)
+  {
+    const Workplace &workplace = m_workplaces.at(workplaceNode);
+    if (workplace.tier > housing.tier || workplace.filled == workplace.jobs)
+    {
+      continue;
+    }
+    const int commute = getCommute(housing.origin, workplace.origin);
+    if (commute != UNREACHABLE)
+    {
+      m_candidates.emplace_back(commute, workplaceNode);
+    }
+  }
+
+  std::sort(m_candidates.begin(), m_candidates.end());
+  takeJobs(node, housing, m_candidates);
+}
+
+void JobMarket::takeJobs(int node, Housing &housing, const std::vector<std::pair<int, int>> &candidates)
+{
+  for (const auto &[commute, workplaceNode] : candidates)
+  {
+    if (housing.employed == housing.residents)
+    {
+      break;
+    }
+    Workplace &workplace = m_workplaces.at(workplaceNode);
+    const int count = std::min(housing.residents - housing.employed, workplace.jobs - workplace.filled);
+    if (count == 0)
+    {
+      continue;
+    }
+
+    auto matchesNode = [](int other) { return [other](const Match &match) { return match.node == other; }; };
+    auto job = std::find_if(housing.jobs.begin(), housing.jobs.end(), matchesNode(workplaceNode));
+    if (job == housing.jobs.end())
+    {
+      housing.jobs.push_back({workplaceNode, count, commute});
+      workplace.workers.push_back({node, count, commute});
+    }
+    else
+    {
+      job->count += count;
+      std::find_if(workplace.workers.begin(), workplace.workers.end(), matchesNode(node))->count += count;
+    }
+
+    housing.employed += count;
+    workplace.filled += count;
+    m_employed += count;
+    m_totalCommute += static_cast<long long>(count) * commute;
+
+    if (workplace.filled == workplace.jobs)
+    {
+      removeFromBucket(workplaceNode, workplace);
+    }
+  }
+}
+
+void JobMarket::addToBucket(int node, Workplace &workplace)
+{
+  if (!workplace.inBucket && workplace.filled < workplace.jobs)
+  {
+    m_buckets[bucketIdx(workplace.origin, workplace.tier)].push_back(node);
+    workplace.inBucket = true;
+  }
+}
+
+void JobMarket::removeFromBucket(int node, Workplace &workplace)
+{
+  if (workplace.inBucket)
+  {
+    std::vector<int> &bucket = m_buckets[bucketIdx(workplace.origin, workplace.tier)];
+    auto it = std::find(bucket.begin(), bucket.end(), node);
+    *it = bucket.back();
+    bucket.pop_back();
+    workplace.inBucket = false;
+  }
+}
+
+void JobMarket::removeMatch(std::vector<Match> &matches, int node, int &count, int &commute)
+{
+  auto it = std::find_if(matches.begin(), matches.end(), [node](const Match &match) { return match.node == node; });
+  count = it->count;
+  commute = it->commute;
+  *it = matches.back();
+  matches.pop_back();
+}
+
+int JobMarket::getEmployed(int x, int y) const
+{
+  auto it = m_housing.find(nodeIdx({x, y, 0, 0}));
+  return it == m_housing.end() ? 0 : it->second.employed;
+}
+
+int JobMarket::getFilledJobs(int x, int y) const
+{
+  auto it = m_workplaces.find(nodeIdx({x, y, 0, 0}));
+  return it == m_workplaces.end() ? 0 : it->second.filled;
+}
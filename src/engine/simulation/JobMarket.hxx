@@ -0,0 +1,144 @@
+#ifndef JOBMARKET_HXX_
+#define JOBMARKET_HXX_
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "basics/point.hxx"
+
+/** @brief Assigns the residents of the city to the jobs of the workplaces.
+  * Workplaces with free jobs are kept in buckets per chunk and education tier. Unemployed residents look for jobs in the
+  * buckets of their own chunk first and then in rings of chunks further away, preferring the shortest commute within
+  * each ring. Residents can take jobs that require at most their own education.
+  * Matches are kept until the housing or the workplace is removed, only the residents that lost their job or moved in
+  * since the last update are matched again. The other unemployed residents already know that no free job is in reach,
+  * so they only look at the workplaces that got free jobs since the last update.
+  */
+class JobMarket
+{
+public:
+  static constexpr int UNREACHABLE = -1;
+  /// Width and height of the chunks the workplaces are bucketed by
+  static constexpr int ChunkSize = 16;
+  static constexpr int EducationTiers = 4;
+
+  /** @brief Function that returns the commute length between two buildings, or UNREACHABLE.
+    */
+  using CommuteFunction = std::function<int(const Point &from, const Point &to)>;
+
+  JobMarket(int columns, int rows);
+
+  /** @brief Set the function used to measure commutes, for example along the roads.
+    * Without a function, the Manhattan distance is used.
+    */
+  void setCommuteFunction(CommuteFunction commute) { m_commute = std::move(commute); };
+
+  /** @brief Add a residential building with its origin at (x, y).
+    * @param residents number of residents looking for jobs.
+    * @param educationLevel education of the residents.
+    */
+  void addHousing(int x, int y, int residents, int educationLevel);
+  void removeHousing(int x, int y);
+
+  /** @brief Add a workplace with its origin at (x, y).
+    * @param jobs number of jobs the workplace provides.
+    * @param educationLevel education the jobs require.
+    */
+  void addWorkplace(int x, int y, int jobs, int educationLevel);
+  void removeWorkplace(int x, int y);
+
+  /** @brief Find jobs for the residents that are unemployed since the last update.
+    */
+  void update();
+
+  int getResidents() const { return m_residents; };
+  int getJobs() const { return m_jobs; };
+  int getEmployed() const { return m_employed; };
+
+  /** @brief Get the number of employed residents of the housing at (x, y).
+    */
+  int getEmployed(int x, int y) const;
+
+  /** @brief Get the number of occupied jobs of the workplace at (x, y).
+    */
+  int getFilledJobs(int x, int y) const;
+
+  /** @brief Get the fraction of residents with a job, between 0 and 1.
+    */
+  float getEmploymentRate() const { return m_residents > 0 ? static_cast<float>(m_employed) / m_residents : 0.f; };
+
+  /** @brief Get the average commute length of the employed residents.
+    */
+  float getAverageCommute() const { return m_employed > 0 ? static_cast<float>(m_totalCommute) / m_employed : 0.f; };
+
+private:
+  struct Match
+  {
+    int node;    /// node index of the origin of the other building
+    int count;   /// number of residents working there
+    int commute; /// commute length
+  };
+
+  struct Housing
+  {
+    Point origin;
+    int residents;
+    int tier;
+    int employed = 0;
+    std::vector<Match> jobs;
+  };
+
+  struct Workplace
+  {
+    Point origin;
+    int jobs;
+    int tier;
+    int filled = 0;
+    bool inBucket = false;
+    std::vector<Match> workers;
+  };
+
+  int m_columns;
+  int m_chunkColumns;
+  int m_chunkRows;
+  CommuteFunction m_commute;
+  std::unordered_map<int, Housing> m_housing;
+  std::unordered_map<int, Workplace> m_workplaces;
+  /// workplaces with free jobs per chunk and education tier
+  std::vector<std::vector<int>> m_buckets;
+  /// housing with unemployed residents that has to be matched in the next update
+  std::vector<int> m_pending;
+  /// workplaces that got free jobs since the last update, the only ones unemployed residents have to look at again
+  std::vector<int> m_openedWorkplaces;
+  /// scratch list of commutes and workplace nodes
+  std::vector<std::pair<int, int>> m_candidates;
+  int m_residents = 0;
+  int m_jobs = 0;
+  int m_employed = 0;
+  long long m_totalCommute = 0;
+
+  int nodeIdx(const Point &point) const { return point.x * m_columns + point.y; };
+  int bucketIdx(const Point &point, int tier) const
+  {
+    return ((point.x / ChunkSize) * m_chunkColumns + point.y / ChunkSize) * EducationTiers + tier;
+  };
+  static int getTier(int educationLevel);
+  int getCommute(const Point &from, const Point &to) const;
+  void addToBucket(int node, Workplace &workplace);
+  void removeFromBucket(int node, Workplace &workplace);
+  void findJobs(int node, Housing &housing);
+
+  /** @brief Look for jobs only in the workplaces that got free jobs since the last update.
+    */
+  void findOpenedJobs(int node, Housing &housing);
+
+  /** @brief Employ residents of the housing in the candidates, sorted by their commute, until all have a job.
+    */
+  void takeJobs(int node, Housing &housing, const std::vector<std::pair<int, int>> &candidates);
+  static void removeMatch(std::vector<Match> &matches, int node, int &count, int &commute);
+};
+
+#endif
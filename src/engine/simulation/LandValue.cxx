@@ -0,0 +1,218 @@
+#include "LandValue.hxx"
+
+#include "InfluenceFields.hxx"
+#include "ServiceCoverage.hxx"
+
+#include <algorithm>
+
+namespace
+{
+/// full strength of a factor
+constexpr int ONE = 1 << LandValue::FactorShift;
+/// fixed point influence field value of the full strength of a factor
+constexpr int FIELD_RANGE = LandValue::FieldRange << InfluenceFields::FixedPointShift;
+} // namespace
+
+LandValue::LandValue(const InfluenceFields &fields, const ServiceCoverage &coverage, int columns, int rows)
+    : m_fields(fields), m_coverage(coverage), m_columns(columns), m_rows(rows),
+      m_chunkColumns((columns + ChunkSize - 1) / ChunkSize), m_chunkRows((rows + ChunkSize - 1) / ChunkSize),
+      m_values(columns * rows, BaseValue), m_water(columns * rows, false), m_waterDistance(columns * rows, WaterRange),
+      m_height(columns * rows, 0), m_dirtyChunks(m_chunkColumns * m_chunkRows, true)
+{
+  m_weights[POLLUTION] = -96;
+  m_weights[CRIME] = -64;
+  m_weights[HAPPINESS] = 48;
+  m_weights[SERVICES] = 64;
+  m_weights[WATER] = 40;
+  m_weights[HEIGHT] = 24;
+}
+
+void LandValue::setWeight(Factor factor, int weight)
+{
+  if (m_weights[factor] != weight)
+  {
+    m_weights[factor] = weight;
+    markAllDirty();
+  }
+}
+
+void LandValue::setWater(int x, int y, bool water)
+{
+  const int node = nodeIdx(x, y);
+  if (m_water[node] != water)
+  {
+    m_water[node] = water;
+    m_waterDirty = true;
+  }
+}
+
+void LandValue::setHeight(int x, int y, int height)
+{
+  const int node = nodeIdx(x, y);
+  if (m_height[node] != height)
+  {
+    m_height[node] = static_cast<int16_t>(height);
+    markDirty(x, y, x, y);
+  }
+}
+
+void LandValue::markDirty(int minX, int minY, int maxX, int maxY)
+{
+  const int firstChunkX = std::max(0, minX) / ChunkSize;
+  const int lastChunkX = std::min(m_rows - 1, maxX) / ChunkSize;
+  const int firstChunkY = std::max(0, minY) / ChunkSize;
+  const int lastChunkY = std::min(m_columns - 1, maxY) / ChunkSize;
+
+  for (int chunkX = firstChunkX; chunkX <= lastChunkX; ++chunkX)
+  {
+    for (int chunkY = firstChunkY; chunkY <= lastChunkY; ++chunkY)
+    {
+      m_dirtyChunks[chunkX * m_chunkColumns + chunkY] = true;
+    }
+  }
+}
+
+void LandValue::update()
+{
+  m_updatedChunks.clear();
+
+  if (m_waterDirty)
+  {
+    updateWaterDistance();
+    m_waterDirty = false;
+  }
+
+  for (int chunk = 0; chunk < m_chunkColumns * m_chunkRows; ++chunk)
+  {
+    if (m_dirtyChunks[chunk])
+    {
+      computeChunk(chunk);
+      m_dirtyChunks[chunk] = false;
+      m_updatedChunks.push_back(chunk);
+    }
+  }
+}
+
+void LandValue::getChunkBounds(int chunk, int &minX, int &minY, int &maxX, int &maxY) const
+{
+  minX = (chunk / m_chunkColumns) * ChunkSize;
+  minY = (chunk % m_chunkColumns) * ChunkSize;
+  maxX = std::min(m_rows, minX + ChunkSize);
+  maxY = std::min(m_columns, minY + ChunkSize);
+}
+
+Wealth LandValue::getWealth(uint8_t value)
+{
+  if (value < MediumWealthValue)
+  {
+    return Wealth::LOW;
+  }
+  return value < HighWealthValue ? Wealth::MEDIUM : Wealth::HIGH;
+}
+
+void LandValue::updateWaterDistance()
+{
+  std::vector<uint8_t> distance(m_waterDistance.size());
+  auto relax = [&distance](int node, int neighbor) {
+    distance[node] = std::min(distance[node], static_cast<uint8_t>(distance[neighbor] + 1));
+  };
+
+  // two pass distance transform, forward from the top left and backward from the bottom right
+  for (int x = 0; x < m_rows; ++x)
+  {
+    for (int y = 0; y < m_columns; ++y)
+    {
+      const int node = nodeIdx(x, y);
+      distance[node] = m_water[node] ? 0 : WaterRange;
+      if (x > 0)
+      {
+        relax(node, node - m_columns);
+      }
+      if (y > 0)
+      {
+        relax(node, node - 1);
+      }
+    }
+  }
+  for (int x = m_rows - 1; x >= 0; --x)
+  {
+    for (int y = m_columns - 1; y >= 0; --y)
+    {
+      const int node = nodeIdx(x, y);
+      if (x < m_rows - 1)
+      {
+        relax(node, node + m_columns);
+      }
+      if (y < m_columns - 1)
+      {
+        relax(node, node + 1);
+      }
+      if (distance[node] != m_waterDistance[node])
+      {
+        m_dirtyChunks[(x / ChunkSize) * m_chunkColumns + y / ChunkSize] = true;
+      }
+    }
+  }
+
+  m_waterDistance.swap(distance);
+}
+
+void LandValue::computeChunk(int chunk)
+{
+  constexpr int serviceCount = ServiceCoverage::SERVICES_COUNT;
+
+  int minX, minY, maxX, maxY;
+  getChunkBounds(chunk, minX, minY, maxX, maxY);
+  const int width = maxY - minY;
+
+  // fixed point factor of the distance to the stations, so the loop doesn't need a division
+  std::array<int, serviceCount> serviceRange;
+  std::array<int, serviceCount> serviceScale;
+  for (int service = 0; service < serviceCount; ++service)
+  {
+    serviceRange[service] = ServiceCoverage::getRange(static_cast<ServiceCoverage::Service>(service));
+    serviceScale[service] = ONE * ONE / serviceRange[service];
+  }
+
+  const int pollutionWeight = m_weights[POLLUTION];
+  const int crimeWeight = m_weights[CRIME];
+  const int happinessWeight = m_weights[HAPPINESS];
+  const int servicesWeight = m_weights[SERVICES];
+  const int waterWeight = m_weights[WATER];
+  const int heightWeight = m_weights[HEIGHT];
+
+  for (int x = minX; x < maxX; ++x)
+  {
+    const int rowStart = nodeIdx(x, minY);
+    const int16_t *pollution = m_fields.getField(InfluenceFields::POLLUTION).data() + rowStart;
+    const int16_t *crime = m_fields.getField(InfluenceFields::CRIME).data() + rowStart;
+    const int16_t *happiness = m_fields.getField(InfluenceFields::HAPPINESS).data() + rowStart;
+    const int *police = m_coverage.getDistances(ServiceCoverage::POLICE).data() + rowStart;
+    const int *fire = m_coverage.getDistances(ServiceCoverage::FIRE).data() + rowStart;
+    const int *education = m_coverage.getDistances(ServiceCoverage::EDUCATION).data() + rowStart;
+    const int *health = m_coverage.getDistances(ServiceCoverage::HEALTH).data() + rowStart;
+    const uint8_t *waterDistance = m_waterDistance.data() + rowStart;
+    const int16_t *height = m_height.data() + rowStart;
+    uint8_t *values = m_values.data() + rowStart;
+
+    auto field = [](int value) { return std::clamp(value, 0, FIELD_RANGE) * ONE / FIELD_RANGE; };
+    auto coverage = [&serviceRange, &serviceScale](int service, int distance) {
+      return distance < 0 ? 0 : (std::max(0, serviceRange[service] - distance) * serviceScale[service]) >> FactorShift;
+    };
+
+    for (int y = 0; y < width; ++y)
+    {
+      const int services = coverage(ServiceCoverage::POLICE, police[y]) + coverage(ServiceCoverage::FIRE, fire[y]) +
+                           coverage(ServiceCoverage::EDUCATION, education[y]) +
+                           coverage(ServiceCoverage::HEALTH, health[y]);
+
+      int value = (BaseValue << FactorShift) + pollutionWeight * field(pollution[y]) + crimeWeight * field(crime[y]) +
+                  happinessWeight * field(happiness[y]) + servicesWeight * services / serviceCount +
+                  waterWeight * (WaterRange - waterDistance[y]) * ONE / WaterRange +
+                  heightWeight * std::clamp<int>(height[y], 0, HeightRange) * ONE / HeightRange;
+      values[y] = static_cast<uint8_t>(std::clamp(value, 0, 255 << FactorShift) >> FactorShift);
+    }
+  }
+
+  m_computedChunkCount++;
+}
@@ -0,0 +1,127 @@
+#ifndef LANDVALUE_HXX_
+#define LANDVALUE_HXX_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "basics/tileData.hxx"
+
+class InfluenceFields;
+class ServiceCoverage;
+
+/** @brief Land value of every node, combined from the factors that make a place attractive to live in.
+  * The value starts at BaseValue and every factor adds its weight times its strength at the node, which is normalized
+  * to fixed point between 0 and 1 with FactorShift fractional bits. All factors of a node are combined in a single
+  * pass over the rows of a chunk, reading the factor grids side by side.
+  * The map is split into chunks and only chunks whose inputs have been marked dirty are recomputed.
+  * Values are quantized to 0 - 255.
+  */
+class LandValue
+{
+public:
+  enum Factor : unsigned int
+  {
+    POLLUTION,
+    CRIME,
+    HAPPINESS,
+    SERVICES,
+    WATER,
+    HEIGHT,
+    FACTORS_COUNT
+  };
+
+  static constexpr int ChunkSize = 16;
+  static constexpr int FactorShift = 8;
+  static constexpr int BaseValue = 128;
+  /// Influence field value that counts as the full strength of a factor
+  static constexpr int FieldRange = 10;
+  /// Distance to water from which on water no longer adds to the land value
+  static constexpr int WaterRange = 8;
+  /// Terrain height that counts as the full strength of a factor
+  static constexpr int HeightRange = 32;
+  /// Land values below are low wealth, values from HighWealthValue on are high wealth
+  static constexpr int MediumWealthValue = 96;
+  static constexpr int HighWealthValue = 160;
+
+  LandValue(const InfluenceFields &fields, const ServiceCoverage &coverage, int columns, int rows);
+
+  /** @brief Get the land value at the full strength of a factor, relative to BaseValue.
+    */
+  int getWeight(Factor factor) const { return m_weights[factor]; };
+
+  /** @brief Set the land value at the full strength of a factor, negative for factors that lower the value.
+    */
+  void setWeight(Factor factor, int weight);
+
+  /** @brief Set whether a node has water.
+    */
+  void setWater(int x, int y, bool water);
+
+  /** @brief Set the terrain height of a node.
+    */
+  void setHeight(int x, int y, int height);
+
+  /** @brief Mark all chunks that overlap the given rectangle of nodes for recomputation.
+    */
+  void markDirty(int minX, int minY, int maxX, int maxY);
+
+  /** @brief Mark all chunks for recomputation.
+    */
+  void markAllDirty() { m_dirtyChunks.assign(m_dirtyChunks.size(), true); };
+
+  /** @brief Recompute all dirty chunks.
+    */
+  void update();
+
+  /** @brief Get the chunks that have been recomputed by the last update, as chunkX * chunk columns + chunkY.
+    */
+  const std::vector<int> &getUpdatedChunks() const { return m_updatedChunks; };
+
+  /** @brief Get the nodes covered by a chunk, the maxima are exclusive.
+    */
+  void getChunkBounds(int chunk, int &minX, int &minY, int &maxX, int &maxY) const;
+
+  uint8_t getValue(int x, int y) const { return m_values[nodeIdx(x, y)]; };
+
+  /** @brief Get the land values, indexed like the map nodes.
+    */
+  const std::vector<uint8_t> &getValues() const { return m_values; };
+
+  /** @brief Get the wealth of the buildings that spawn on a node with the given land value.
+    */
+  static Wealth getWealth(uint8_t value);
+
+  /** @brief Get the number of chunks recomputed since the construction, for profiling.
+    */
+  size_t getComputedChunkCount() const { return m_computedChunkCount; };
+
+private:
+  const InfluenceFields &m_fields;
+  const ServiceCoverage &m_coverage;
+  int m_columns;
+  int m_rows;
+  int m_chunkColumns;
+  int m_chunkRows;
+  std::array<int, FACTORS_COUNT> m_weights;
+  std::vector<uint8_t> m_values;
+  std::vector<bool> m_water;
+  /// Manhattan distance to the nearest water node, capped at WaterRange
+  std::vector<uint8_t> m_waterDistance;
+  std::vector<int16_t> m_height;
+  bool m_waterDirty = false;
+  std::vector<bool> m_dirtyChunks;
+  std::vector<int> m_updatedChunks;
+  size_t m_computedChunkCount = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+
+  /** @brief Recompute the water distances and mark the chunks where they changed.
+    */
+  void updateWaterDistance();
+
+  void computeChunk(int chunk);
+};
+
+#endif
@@ -0,0 +1,155 @@
+#include "Lifecycle.hxx"
+
+#include "Map.hxx"
+#include "TileManager.hxx"
+#include "ZoneGrowth.hxx"
+#include "Hash.hxx"
+
+#include <algorithm>
+
+namespace
+{
+/// Share of the water demand that must be served for a building to count as supplied
+constexpr float MIN_WATER_SERVED = 0.5f;
+
+/** @brief Hash a building and a day, so the jitter and the choice of variants are the same in every replay.
+  */
+uint64_t hashBuilding(const BuildingId &building, uint32_t day)
+{
+  const uint32_t values[] = {building.index, building.generation, day};
+  return xxHash64(values, sizeof(values));
+}
+
+/** @brief Get the highest wealth level a building is meant for.
+  */
+int getMaxWealth(const TileData &tileData)
+{
+  int maxWealth = 0;
+  for (const Wealth &wealth : tileData.wealth)
+  {
+    maxWealth = std::max(maxWealth, static_cast<int>(wealth._to_index()));
+  }
+  return maxWealth;
+}
+} // namespace
+
+Lifecycle::Lifecycle(Map &map, BuildingStore &buildings, ZoneGrowth &zoneGrowth)
+    : m_map(map), m_buildings(buildings), m_zoneGrowth(zoneGrowth)
+{
+}
+
+void Lifecycle::add(const BuildingId &building, uint32_t today)
+{
+  const int index = m_buildings.getIndex(building);
+  if (index < 0 || m_buildings.getTileData()[index]->tileType != +TileType::RCI)
+  {
+    return;
+  }
+  schedule(Entry{building, 0}, today + ReviewInterval);
+}
+
+void Lifecycle::reset(uint32_t today)
+{
+  m_queue.reset(today);
+  for (size_t index = 0; index < m_buildings.size(); ++index)
+  {
+    add(m_buildings.getId(static_cast<int>(index)), today);
+  }
+}
+
+void Lifecycle::schedule(const Entry &entry, uint32_t day)
+{
+  m_queue.schedule(day + static_cast<uint32_t>(hashBuilding(entry.building, day) % Jitter), entry);
+}
+
+void Lifecycle::tick(uint32_t today)
+{
+  m_evaluated = 0;
+  Entry entry;
+  // buildings that are left over are due on the next tick, the queue keeps returning the oldest days first
+  while (m_evaluated < MaxEvaluationsPerTick && m_queue.popDue(today, entry))
+  {
+    if (m_buildings.isAlive(entry.building))
+    {
+      evaluate(entry, today);
+      m_evaluated++;
+    }
+  }
+}
+
+void Lifecycle::evaluate(Entry entry, uint32_t today)
+{
+  const int index = m_buildings.getIndex(entry.building);
+  const uint32_t age = m_buildings.getAge()[index];
+  const TileData *tileData = m_buildings.getTileData()[index];
+  // buildings that don't consume power or water never lack it
+  const bool powered = tileData->power >= 0 || m_buildings.getPowered()[index];
+  const bool watered = tileData->water >= 0 || m_buildings.getWaterServed()[index] >= MIN_WATER_SERVED;
+  const bool supplied = powered && watered;
+
+  if (!supplied && age >= MinAbandonAge)
+  {
+    if (++entry.neglect >= AbandonAfter)
+    {
+      const int origin = m_buildings.getOrigins()[index];
+      const Point originCoords{origin / m_map.getColumns(), origin % m_map.getColumns(), 0, 0};
+      m_map.demolishNode(m_map.getObjectCoords(originCoords, tileData->id), false, Layer::BUILDINGS);
+      return;
+    }
+    schedule(entry, today + NeglectInterval);
+    return;
+  }
+
+  entry.neglect = 0;
+  if (age >= MinUpgradeAge && upgrade(index))
+  {
+    // the new building starts its own lifecycle when it is placed
+    return;
+  }
+  schedule(entry, today + ReviewInterval);
+}
+
+bool Lifecycle::upgrade(int index)
+{
+  const TileData &tileData = *m_buildings.getTileData()[index];
+  const int origin = m_buildings.getOrigins()[index];
+  const Point originCoords{origin / m_map.getColumns(), origin % m_map.getColumns(), 0, 0};
+  const Wealth wealth = m_zoneGrowth.getNodeWealth(originCoords);
+
+  if (static_cast<int>(wealth._to_index()) <= getMaxWealth(tileData))
+  {
+    return false;
+  }
+
+  // the variant must have the same footprint, so it fits exactly where the old building stands
+  const TileManager &tileManager = TileManager::instance();
+  const std::vector<std::string> *tileIDs = nullptr;
+  for (const Zones &zone : tileData.zones)
+  {
+    const std::vector<RequiredTilesData> &footprints = tileManager.getRCISpawnFootprints(zone, wealth, m_zoneGrowth.getStyle());
+    for (size_t footprint = 0; footprint < footprints.size() && !tileIDs; ++footprint)
+    {
+      if (footprints[footprint].width == tileData.RequiredTiles.width &&
+          footprints[footprint].height == tileData.RequiredTiles.height)
+      {
+        tileIDs = &tileManager.getRCISpawnCandidates(zone, wealth, m_zoneGrowth.getStyle(), footprint);
+      }
+    }
+    if (tileIDs)
+    {
+      break;
+    }
+  }
+  if (!tileIDs || tileIDs->empty())
+  {
+    return false;
+  }
+
+  const std::string tileID = (*tileIDs)[hashBuilding(m_buildings.getId(index), origin) % tileIDs->size()];
+  const std::vector<Point> coords = m_map.getObjectCoords(originCoords, tileID);
+
+  // single node buildings aren't demolished by setTileIDOfNode, so clear the old building first
+  m_map.demolishNode(m_map.getObjectCoords(originCoords, tileData.id), false, Layer::BUILDINGS);
+  m_map.setTileIDOfNode(coords.begin(), coords.end(), tileID, coords.size() == 1);
+  return true;
+}
@@ -0,0 +1,88 @@
+#ifndef LIFECYCLE_HXX_
+#define LIFECYCLE_HXX_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "BuildingStore.hxx"
+#include "CalendarQueue.hxx"
+
+class Map;
+class ZoneGrowth;
+
+/** @brief Ages the RCI buildings: they are replaced by wealthier variants when the land value rises and abandoned when
+  * they lack power or water for too long.
+  * Every building schedules its next evaluation in a calendar queue keyed by game day, so a day only costs work for the
+  * buildings that are due, not for all buildings. The due buildings are evaluated in bounded batches per tick.
+  */
+class Lifecycle
+{
+public:
+  /// Maximum number of buildings evaluated per tick
+  static constexpr size_t MaxEvaluationsPerTick = 16;
+  /// Days between the evaluations of a building that is doing well
+  static constexpr uint32_t ReviewInterval = 30;
+  /// Days between the evaluations of a building without power or water
+  static constexpr uint32_t NeglectInterval = 7;
+  /// Evaluations are spread over this many days, so buildings placed together aren't due together
+  static constexpr uint32_t Jitter = 8;
+  /// Days a building must stand before it can upgrade
+  static constexpr uint32_t MinUpgradeAge = 60;
+  /// Days a new building gets to be connected to power and water
+  static constexpr uint32_t MinAbandonAge = 30;
+  /// Number of evaluations in a row without power or water after which a building is abandoned
+  static constexpr uint8_t AbandonAfter = 4;
+  /// Number of days the calendar queue covers
+  static constexpr uint32_t Horizon = 64;
+
+  Lifecycle(Map &map, BuildingStore &buildings, ZoneGrowth &zoneGrowth);
+
+  /** @brief Start the lifecycle of a new building.
+    * Buildings that are demolished are dropped from the queue when they are due.
+    */
+  void add(const BuildingId &building, uint32_t today);
+
+  /** @brief Schedule all RCI buildings again as if they had just been placed, e.g. after a saved game has been loaded.
+    * Their ages are kept, the number of evaluations without power or water starts over.
+    */
+  void reset(uint32_t today);
+
+  /** @brief Evaluate the next batch of buildings that are due.
+    */
+  void tick(uint32_t today);
+
+  /** @brief Get the number of buildings waiting for their next evaluation.
+    */
+  size_t getScheduledCount() const { return m_queue.size(); };
+
+  /** @brief Get the number of buildings that have been evaluated in the last tick, for profiling.
+    */
+  size_t getEvaluatedCount() const { return m_evaluated; };
+
+private:
+  struct Entry
+  {
+    BuildingId building;
+    /// number of evaluations in a row without power or water
+    uint8_t neglect = 0;
+  };
+
+  Map &m_map;
+  BuildingStore &m_buildings;
+  ZoneGrowth &m_zoneGrowth;
+  CalendarQueue<Entry> m_queue{Horizon};
+  size_t m_evaluated = 0;
+
+  void schedule(const Entry &entry, uint32_t day);
+
+  /** @brief Evaluate a building and schedule its next evaluation, unless it has been replaced or abandoned.
+    */
+  void evaluate(Entry entry, uint32_t today);
+
+  /** @brief Replace a building by a variant with the same footprint and a higher wealth level.
+    * @return whether the building has been replaced.
+    */
+  bool upgrade(int index);
+};
+
+#endif
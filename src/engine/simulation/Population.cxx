@@ -0,0 +1,242 @@
+#include "Population.hxx"
+
+#include "ByteStream.hxx"
+#include "JobMarket.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+static_assert(Population::EducationTiers == JobMarket::EducationTiers, "Residents need a tier for every job");
+
+namespace
+{
+constexpr float MONTHS_PER_YEAR = 12.f;
+
+/** @brief Build a table with one value per cohort from one value per age band and tier.
+  */
+template <typename Function> Population::Cohorts perCohort(Function value)
+{
+  Population::Cohorts table{};
+  for (unsigned int band = 0; band < Population::AGE_BANDS_COUNT; ++band)
+  {
+    for (unsigned int tier = 0; tier < Population::EducationTiers; ++tier)
+    {
+      table[Population::getCohort(static_cast<Population::AgeBand>(band), tier)] =
+          value(static_cast<Population::AgeBand>(band), tier);
+    }
+  }
+  return table;
+}
+
+/// Share of each cohort that moves on to the next age band per month, seniors leave the city
+const Population::Cohorts AGING = perCohort([](Population::AgeBand band, unsigned int) {
+  constexpr std::array<float, Population::AGE_BANDS_COUNT> years = {6.f, 12.f, 12.f, 15.f, 20.f, 15.f};
+  return 1.f / (years[band] * MONTHS_PER_YEAR);
+});
+
+/// Share of each cohort that reaches the next education tier per month, with full school coverage
+const Population::Cohorts EDUCATION = perCohort([](Population::AgeBand band, unsigned int tier) {
+  if (band == Population::PUPILS && tier == 0)
+  {
+    return 1.f / (6.f * MONTHS_PER_YEAR);
+  }
+  if (band == Population::YOUNG_ADULTS && tier == 1)
+  {
+    return 1.f / (6.f * MONTHS_PER_YEAR);
+  }
+  if (band == Population::YOUNG_ADULTS && tier == 2)
+  {
+    return 1.f / (12.f * MONTHS_PER_YEAR);
+  }
+  return 0.f;
+});
+
+/// Share of the newcomers in each cohort, mostly young working adults
+const Population::Cohorts NEWCOMERS = perCohort([](Population::AgeBand band, unsigned int tier) {
+  constexpr float shares[Population::AGE_BANDS_COUNT][Population::EducationTiers] = {{0.08f, 0.f, 0.f, 0.f},
+                                                                                     {0.07f, 0.05f, 0.f, 0.f},
+                                                                                     {0.f, 0.15f, 0.12f, 0.05f},
+                                                                                     {0.f, 0.12f, 0.1f, 0.06f},
+                                                                                     {0.f, 0.08f, 0.06f, 0.02f},
+                                                                                     {0.f, 0.04f, 0.f, 0.f}};
+  return shares[band][tier];
+});
+} // namespace
+
+Population::Population(int columns, int rows)
+    : m_chunkColumns((columns + ChunkSize - 1) / ChunkSize), m_chunkRows((rows + ChunkSize - 1) / ChunkSize),
+      m_capacity(m_chunkColumns * m_chunkRows, 0), m_education(m_chunkColumns * m_chunkRows, 0.f),
+      m_cohorts(m_chunkColumns * m_chunkRows * CohortsCount, 0.f)
+{
+}
+
+void Population::addHousing(int x, int y, int capacity, int sign)
+{
+  m_capacity[chunkIdx(x / ChunkSize, y / ChunkSize)] += sign * capacity;
+  m_totalCapacity += sign * capacity;
+}
+
+void Population::immigrate(Cohorts &delta, float residents) const
+{
+  for (unsigned int cohort = 0; cohort < CohortsCount; ++cohort)
+  {
+    delta[cohort] += residents * NEWCOMERS[cohort];
+  }
+}
+
+void Population::settle()
+{
+  for (size_t chunk = 0; chunk < m_capacity.size(); ++chunk)
+  {
+    float *cohorts = &m_cohorts[chunk * CohortsCount];
+    const float residents = std::accumulate(cohorts, cohorts + CohortsCount, 0.f);
+    if (residents >= static_cast<float>(m_capacity[chunk]))
+    {
+      continue;
+    }
+
+    Cohorts delta{};
+    immigrate(delta, static_cast<float>(m_capacity[chunk]) - residents);
+    for (unsigned int cohort = 0; cohort < CohortsCount; ++cohort)
+    {
+      cohorts[cohort] += delta[cohort];
+      m_totals[cohort] += delta[cohort];
+    }
+  }
+}
+
+void Population::updateMonth()
+{
+  constexpr unsigned int NEXT_BAND = EducationTiers;
+  const unsigned int firstParents = getCohort(YOUNG_ADULTS, 0);
+  const unsigned int lastParents = getCohort(ADULTS, EducationTiers - 1);
+
+  for (size_t chunk = 0; chunk < m_capacity.size(); ++chunk)
+  {
+    float *cohorts = &m_cohorts[chunk * CohortsCount];
+    const float capacity = static_cast<float>(m_capacity[chunk]);
+    float residents = std::accumulate(cohorts, cohorts + CohortsCount, 0.f);
+    if (residents == 0.f && capacity == 0.f)
+    {
+      continue;
+    }
+
+    Cohorts delta{};
+
+    // aging, the flow out of the seniors are the deaths
+    for (unsigned int cohort = 0; cohort < CohortsCount; ++cohort)
+    {
+      delta[cohort] -= cohorts[cohort] * AGING[cohort];
+    }
+    for (unsigned int cohort = 0; cohort + NEXT_BAND < CohortsCount; ++cohort)
+    {
+      delta[cohort + NEXT_BAND] += cohorts[cohort] * AGING[cohort];
+    }
+
+    // education, the next tier is the next cohort
+    const float education = BaseEducation + (1.f - BaseEducation) * m_education[chunk];
+    for (unsigned int cohort = 0; cohort + 1 < CohortsCount; ++cohort)
+    {
+      const float educated = cohorts[cohort] * EDUCATION[cohort] * education;
+      delta[cohort] -= educated;
+      delta[cohort + 1] += educated;
+    }
+
+    // births
+    const float parents = std::accumulate(cohorts + firstParents, cohorts + lastParents + 1, 0.f);
+    delta[getCohort(INFANTS, 0)] += parents * BirthRate;
+
+    // migration, residents without housing leave first
+    residents += std::accumulate(delta.begin(), delta.end(), 0.f);
+    float keep = 1.f;
+    if (residents > capacity)
+    {
+      keep = capacity / residents;
+    }
+    else if (m_attractiveness < 0.f)
+    {
+      keep = 1.f + m_attractiveness * EmigrationRate;
+    }
+    else if (m_attractiveness > 0.f)
+    {
+      immigrate(delta, (capacity - residents) * m_attractiveness * ImmigrationRate);
+    }
+    if (keep < 1.f)
+    {
+      for (unsigned int cohort = 0; cohort < CohortsCount; ++cohort)
+      {
+        delta[cohort] -= (cohorts[cohort] + delta[cohort]) * (1.f - keep);
+      }
+    }
+
+    for (unsigned int cohort = 0; cohort < CohortsCount; ++cohort)
+    {
+      const float updated = std::max(0.f, cohorts[cohort] + delta[cohort]);
+      m_totals[cohort] += updated - cohorts[cohort];
+      cohorts[cohort] = updated;
+    }
+  }
+}
+
+int Population::getResidents() const
+{
+  return static_cast<int>(std::lround(std::accumulate(m_totals.begin(), m_totals.end(), 0.0)));
+}
+
+int Population::getResidents(AgeBand ageBand) const
+{
+  const auto begin = m_totals.begin() + getCohort(ageBand, 0);
+  return static_cast<int>(std::lround(std::accumulate(begin, begin + EducationTiers, 0.0)));
+}
+
+int Population::getEducated(unsigned int tier) const
+{
+  double residents = 0;
+  for (unsigned int band = 0; band < AGE_BANDS_COUNT; ++band)
+  {
+    residents += m_totals[getCohort(static_cast<AgeBand>(band), tier)];
+  }
+  return static_cast<int>(std::lround(residents));
+}
+
+int Population::getWorkforce() const
+{
+  const auto begin = m_totals.begin() + getCohort(YOUNG_ADULTS, 0);
+  const auto end = m_totals.begin() + getCohort(SENIORS, 0);
+  return static_cast<int>(std::lround(std::accumulate(begin, end, 0.0)));
+}
+
+void Population::save(ByteWriter &writer) const
+{
+  writer.writeVarint(m_capacity.size());
+  writer.writeVarint(CohortsCount);
+  for (float residents : m_cohorts)
+  {
+    writer.writeFloat(residents);
+  }
+}
+
+void Population::load(ByteReader &reader)
+{
+  const uint64_t chunks = reader.readVarint();
+  const uint64_t cohorts = reader.readVarint();
+  if (chunks != m_capacity.size() || cohorts != CohortsCount)
+  {
+    throw CytopiaError{TRACE_INFO "The population belongs to a map of a different size"};
+  }
+
+  // read everything before replacing the residents, so malformed data leaves them untouched
+  std::vector<float> residents(m_cohorts.size());
+  for (float &cohort : residents)
+  {
+    cohort = reader.readFloat();
+  }
+
+  m_cohorts.swap(residents);
+  m_totals.fill(0);
+  for (size_t index = 0; index < m_cohorts.size(); ++index)
+  {
+    m_totals[index % CohortsCount] += m_cohorts[index];
+  }
+}
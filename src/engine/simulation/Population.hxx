@@ -0,0 +1,129 @@
+#ifndef POPULATION_HXX_
+#define POPULATION_HXX_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class ByteReader;
+class ByteWriter;
+
+/** @brief Residents of the city by age and education, without simulating single citizens.
+  * Every chunk of the map keeps a small fixed-size array of cohorts, one per age band and education tier. Births, aging,
+  * education and migration are applied to all cohorts once per game month as flat array updates, so a month costs the
+  * same no matter how many residents live in a chunk. The totals per cohort are updated with the same deltas, so the
+  * summary statistics never walk the chunks.
+  */
+class Population
+{
+public:
+  enum AgeBand : unsigned int
+  {
+    /// 0 - 5 years
+    INFANTS,
+    /// 6 - 17 years, they go to school
+    PUPILS,
+    /// 18 - 29 years, they go to university and start to work
+    YOUNG_ADULTS,
+    /// 30 - 44 years
+    ADULTS,
+    /// 45 - 64 years
+    MIDDLE_AGED,
+    /// 65 years and older
+    SENIORS,
+    AGE_BANDS_COUNT
+  };
+
+  /// Same tiers as the education levels of the job market
+  static constexpr unsigned int EducationTiers = 4;
+  static constexpr unsigned int CohortsCount = AGE_BANDS_COUNT * EducationTiers;
+  /// Width and height of the chunks the residents are grouped by
+  static constexpr int ChunkSize = 16;
+  /// Births per month and adult between 18 and 44
+  static constexpr float BirthRate = 0.004f;
+  /// Share of the free housing that is filled per month at full attractiveness
+  static constexpr float ImmigrationRate = 0.3f;
+  /// Share of the residents that leaves per month at the lowest attractiveness
+  static constexpr float EmigrationRate = 0.02f;
+  /// Share of the education progress that happens without schools nearby
+  static constexpr float BaseEducation = 0.2f;
+
+  using Cohorts = std::array<float, CohortsCount>;
+
+  Population(int columns, int rows);
+
+  static unsigned int getCohort(AgeBand ageBand, unsigned int tier) { return ageBand * EducationTiers + tier; };
+
+  /** @brief Add or remove the housing of a residential building with its origin at (x, y).
+    * The residents move in or out with the next monthly update.
+    * @param sign 1 to add the housing, -1 to remove it.
+    */
+  void addHousing(int x, int y, int capacity, int sign);
+
+  /** @brief Set how well the residents of a chunk are served by schools, between 0 and 1.
+    */
+  void setEducation(int chunkX, int chunkY, float coverage) { m_education[chunkIdx(chunkX, chunkY)] = coverage; };
+
+  /** @brief Set how much the city attracts new residents, between -1 (residents move away) and 1.
+    */
+  void setAttractiveness(float attractiveness) { m_attractiveness = attractiveness; };
+
+  /** @brief Move residents into all housing at once, e.g. for a city that has been loaded without population data.
+    */
+  void settle();
+
+  /** @brief Apply the births, aging, education and migration of one month.
+    */
+  void updateMonth();
+
+  int getChunkColumns() const { return m_chunkColumns; };
+  int getChunkRows() const { return m_chunkRows; };
+
+  /** @brief Get the residents of one cohort in a chunk.
+    */
+  float getResidents(int chunkX, int chunkY, AgeBand ageBand, unsigned int tier) const
+  {
+    return m_cohorts[chunkIdx(chunkX, chunkY) * CohortsCount + getCohort(ageBand, tier)];
+  };
+
+  /** @brief Get the residents of all chunks per cohort.
+    */
+  const std::array<double, CohortsCount> &getTotals() const { return m_totals; };
+
+  int getResidents() const;
+  int getResidents(AgeBand ageBand) const;
+  int getEducated(unsigned int tier) const;
+  /// residents between 18 and 64
+  int getWorkforce() const;
+  int getCapacity() const { return m_totalCapacity; };
+
+  /** @brief Write the cohorts of all chunks.
+    */
+  void save(ByteWriter &writer) const;
+
+  /** @brief Restore the cohorts written by save().
+    * @throws CytopiaError if the data is malformed or belongs to a map of a different size.
+    */
+  void load(ByteReader &reader);
+
+private:
+  int m_chunkColumns;
+  int m_chunkRows;
+  /// housing capacity per chunk
+  std::vector<int> m_capacity;
+  /// education coverage per chunk
+  std::vector<float> m_education;
+  /// CohortsCount residents per chunk
+  std::vector<float> m_cohorts;
+  std::array<double, CohortsCount> m_totals{};
+  int m_totalCapacity = 0;
+  float m_attractiveness = 0.f;
+
+  int chunkIdx(int chunkX, int chunkY) const { return chunkX * m_chunkColumns + chunkY; };
+
+  /** @brief Add residents with the profile of newcomers to the changes of a chunk.
+    */
+  void immigrate(Cohorts &delta, float residents) const;
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "PowerGrid.hxx"
+
+#include <algorithm>
+
+#include "basics/tileData.hxx"
+
+PowerGrid::PowerGrid(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_sets(columns * rows), m_conductor(columns * rows, false), m_power(columns * rows, 0),
+      m_components(columns * rows), m_powered(columns * rows, false)
+{
+}
+
+bool PowerGrid::isConductor(const TileData &tileData)
+{
+  if (tileData.tileType == +TileType::AUTOTILE)
+  {
+    return tileData.category == "Power";
+  }
+  return tileData.tileType == +TileType::RCI || tileData.power != 0;
+}
+
+void PowerGrid::addPower(Component &component, int power, int sign)
+{
+  if (power > 0)
+  {
+    component.supply += sign * power;
+  }
+  else
+  {
+    component.demand -= sign * power;
+  }
+}
+
+void PowerGrid::setNode(int x, int y, bool conductor, int power)
+{
+  const int node = nodeIdx(x, y);
+
+  if (!m_conductor[node] && !conductor)
+  {
+    return;
+  }
+
+  if (m_conductor[node] && conductor)
+  {
+    // only the power changed, e.g. a building has been replaced
+    Component &component = m_components[m_sets.find(node)];
+    addPower(component, m_power[node], -1);
+    addPower(component, power, 1);
+    m_power[node] = power;
+    m_dirty.push_back(node);
+  }
+  else if (conductor)
+  {
+    // a removed node stays part of its old component until that has been rebuilt
+    const int oldRoot = m_sets.find(node);
+    if (!m_components[oldRoot].members.empty())
+    {
+      rebuild(oldRoot);
+    }
+
+    m_conductor[node] = true;
+    m_power[node] = power;
+    m_sets.reset(node);
+    Component &component = m_components[node];
+    component = Component{};
+    component.members.push_back(node);
+    addPower(component, power, 1);
+    connectNeighbors(node);
+    m_dirty.push_back(node);
+  }
+  else
+  {
+    // the component might split up, so it is rebuilt in the next update
+    addPower(m_components[m_sets.find(node)], m_power[node], -1);
+    m_conductor[node] = false;
+    m_power[node] = 0;
+    m_removed.push_back(node);
+  }
+}
+
+void PowerGrid::join(int a, int b)
+{
+  const int rootA = m_sets.find(a);
+  const int rootB = m_sets.find(b);
+
+  if (rootA == rootB)
+  {
+    return;
+  }
+
+  const int root = m_sets.unite(rootA, rootB);
+  Component &merged = m_components[root];
+  Component &other = m_components[root == rootA ? rootB : rootA];
+
+  merged.supply += other.supply;
+  merged.demand += other.demand;
+  merged.members.insert(merged.members.end(), other.members.begin(), other.members.end());
+  other = Component{};
+}
+
+void PowerGrid::connectNeighbors(int node)
+{
+  const int x = node / m_columns;
+  const int y = node % m_columns;
+
+  if (x > 0 && m_conductor[node - m_columns])
+  {
+    join(node, node - m_columns);
+  }
+  if (x < m_rows - 1 && m_conductor[node + m_columns])
+  {
+    join(node, node + m_columns);
+  }
+  if (y > 0 && m_conductor[node - 1])
+  {
+    join(node, node - 1);
+  }
+  if (y < m_columns - 1 && m_conductor[node + 1])
+  {
+    join(node, node + 1);
+  }
+}
+
+void PowerGrid::rebuild(int root)
+{
+  std::vector<int> members = std::move(m_components[root].members);
+  m_components[root] = Component{};
+
+  // split the component into single nodes and connect them again
+  for (int member : members)
+  {
+    m_sets.reset(member);
+  }
+
+  for (int member : members)
+  {
+    if (m_conductor[member])
+    {
+      Component &component = m_components[member];
+      component.members.push_back(member);
+      addPower(component, m_power[member], 1);
+    }
+    else
+    {
+      m_powered[member] = false;
+    }
+  }
+
+  for (int member : members)
+  {
+    if (m_conductor[member])
+    {
+      connectNeighbors(member);
+      m_dirty.push_back(member);
+    }
+  }
+}
+
+void PowerGrid::update()
+{
+  if (m_removed.empty() && m_dirty.empty())
+  {
+    return;
+  }
+  ++m_version;
+
+  for (int node : m_removed)
+  {
+    // rebuilding a component once resets all its nodes, so the other removed nodes of it become single nodes
+    if (!m_components[m_sets.find(node)].members.empty())
+    {
+      rebuild(m_sets.find(node));
+    }
+  }
+  m_removed.clear();
+
+  for (int &node : m_dirty)
+  {
+    node = m_sets.find(node);
+  }
+  std::sort(m_dirty.begin(), m_dirty.end());
+  m_dirty.erase(std::unique(m_dirty.begin(), m_dirty.end()), m_dirty.end());
+
+  for (int root : m_dirty)
+  {
+    const Component &component = m_components[root];
+    const bool powered = component.supply > 0 && component.supply >= component.demand;
+
+    for (int member : component.members)
+    {
+      m_powered[member] = powered;
+    }
+  }
+  m_dirty.clear();
+}
+
+int PowerGrid::getSupply(int x, int y) const
+{
+  const int node = nodeIdx(x, y);
+  return m_conductor[node] ? m_components[m_sets.find(node)].supply : 0;
+}
+
+int PowerGrid::getDemand(int x, int y) const
+{
+  const int node = nodeIdx(x, y);
+  return m_conductor[node] ? m_components[m_sets.find(node)].demand : 0;
+}
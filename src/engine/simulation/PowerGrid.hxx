@@ -0,0 +1,93 @@
+#ifndef POWERGRID_HXX_
+#define POWERGRID_HXX_
+
+#include <vector>
+
+#include "UnionFind.hxx"
+
+struct TileData;
+
+/** @brief Connectivity and supply of the power network.
+  * Every power conducting node (power lines and buildings) is part of a component of 4-connected conducting nodes.
+  * The components are kept in a union-find structure, so placing a conductor only merges the adjacent components.
+  * Removing a conductor rebuilds only the component it belonged to, the next time update() is called.
+  */
+class PowerGrid
+{
+public:
+  PowerGrid(int columns, int rows);
+
+  /** @brief Check if a tile conducts power.
+    * Power lines (AUTOTILE tiles of the category "Power"), RCI buildings and buildings that produce or consume power
+    * are conductors.
+    */
+  static bool isConductor(const TileData &tileData);
+
+  /** @brief Update a node of the power network.
+    * @param x the x coordinate of the node.
+    * @param y the y coordinate of the node.
+    * @param conductor whether the node conducts power.
+    * @param power power production of the node, negative for consumption. Multi-node buildings only set their power
+    * on their origin node.
+    */
+  void setNode(int x, int y, bool conductor, int power);
+
+  /** @brief Rebuild split components and update the powered status of all changed components.
+    */
+  void update();
+
+  /** @brief Get a counter that changes whenever update() changed the network or the powered nodes.
+    */
+  unsigned int getVersion() const { return m_version; };
+
+  /** @brief Check if the node is connected to a component that produces enough power for all its consumers.
+    * @note only valid after update() has been called.
+    */
+  bool isPowered(int x, int y) const { return m_powered[nodeIdx(x, y)]; };
+
+  /** @brief Check if the node is part of the power network.
+    */
+  bool hasConductor(int x, int y) const { return m_conductor[nodeIdx(x, y)]; };
+
+  /** @brief Get the powered status of all nodes, indexed like the map nodes.
+    */
+  const std::vector<bool> &getPoweredNodes() const { return m_powered; };
+
+  /** @brief Get the power production of the component the node belongs to.
+    */
+  int getSupply(int x, int y) const;
+
+  /** @brief Get the power consumption of the component the node belongs to.
+    */
+  int getDemand(int x, int y) const;
+
+private:
+  struct Component
+  {
+    int supply = 0;
+    int demand = 0;
+    std::vector<int> members;
+  };
+
+  int m_columns;
+  int m_rows;
+  mutable UnionFind m_sets;
+  std::vector<bool> m_conductor;
+  std::vector<int> m_power;
+  /// component data, only valid for the representative node of each component
+  std::vector<Component> m_components;
+  std::vector<bool> m_powered;
+  /// nodes whose component changed since the last update
+  std::vector<int> m_dirty;
+  /// removed nodes whose component needs to be rebuilt
+  std::vector<int> m_removed;
+  unsigned int m_version = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  void addPower(Component &component, int power, int sign);
+  void join(int a, int b);
+  void connectNeighbors(int node);
+  void rebuild(int root);
+};
+
+#endif
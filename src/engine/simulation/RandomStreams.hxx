@@ -0,0 +1,46 @@
+#ifndef RANDOMSTREAMS_HXX_
+#define RANDOMSTREAMS_HXX_
+
+#include <cstdint>
+
+/** @brief Seeds of the random number streams of the simulation, all derived from a single seed.
+  * Every system that draws random numbers has its own stream, so a system drawing more or fewer numbers doesn't shift
+  * the numbers of the others. Together with the command log this makes the simulation reproducible.
+  */
+class RandomStreams
+{
+public:
+  enum Stream : uint32_t
+  {
+    ZONE_GROWTH,
+    TRAFFIC,
+    FIRE,
+    MAP_EDITS,
+    STREAMS_COUNT
+  };
+
+  explicit RandomStreams(uint64_t seed = 0) : m_seed(seed) {}
+
+  uint64_t getSeed() const { return m_seed; };
+  void setSeed(uint64_t seed) { m_seed = seed; };
+
+  /** @brief Get the seed of a stream.
+    */
+  uint32_t getSeed(Stream stream) const
+  {
+    return static_cast<uint32_t>(splitMix(m_seed + (static_cast<uint64_t>(stream) + 1) * 0x9E3779B97F4A7C15ULL) >> 32);
+  };
+
+private:
+  uint64_t m_seed;
+
+  /// finalizer of the SplitMix64 generator, spreads nearby seeds over the whole range
+  static uint64_t splitMix(uint64_t value)
+  {
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+  };
+};
+
+#endif
@@ -0,0 +1,512 @@
+#include "RoadNetwork.hxx"
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <queue>
+
+namespace
+{
+using QueueItem = std::pair<int, int>;
+using MinQueue = std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>>;
+} // namespace
+
+RoadNetwork::RoadNetwork(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_road(columns * rows, false), m_vertexOfNode(columns * rows, NONE),
+      m_edgeOfNode(columns * rows, NONE), m_offsetInEdge(columns * rows, 0)
+{
+}
+
+int RoadNetwork::neighbor(int node, int direction) const
+{
+  const int x = node / m_columns;
+  const int y = node % m_columns;
+
+  switch (direction)
+  {
+  case 0:
+    return x > 0 ? node - m_columns : NONE;
+  case 1:
+    return x < m_rows - 1 ? node + m_columns : NONE;
+  case 2:
+    return y > 0 ? node - 1 : NONE;
+  default:
+    return y < m_columns - 1 ? node + 1 : NONE;
+  }
+}
+
+int RoadNetwork::degree(int node) const
+{
+  int count = 0;
+  for (int direction = 0; direction < 4; ++direction)
+  {
+    const int n = neighbor(node, direction);
+    count += (n != NONE && m_road[n]) ? 1 : 0;
+  }
+  return count;
+}
+
+void RoadNetwork::setRoad(int x, int y, bool road)
+{
+  const int node = nodeIdx(x, y);
+
+  if (m_road[node] != road)
+  {
+    m_road[node] = road;
+    m_dirtyNodes.push_back(node);
+  }
+}
+
+int RoadNetwork::ensureVertex(int node)
+{
+  if (m_vertexOfNode[node] != NONE)
+  {
+    return m_vertexOfNode[node];
+  }
+
+  int vertex;
+  if (!m_freeVertices.empty())
+  {
+    vertex = m_freeVertices.back();
+    m_freeVertices.pop_back();
+  }
+  else
+  {
+    vertex = static_cast<int>(m_vertices.size());
+    m_vertices.emplace_back();
+  }
+
+  m_vertices[vertex] = Vertex{node, {NONE, NONE, NONE, NONE}, true};
+  m_vertexOfNode[node] = vertex;
+  m_traceQueue.push_back(vertex);
+  return vertex;
+}
+
+void RoadNetwork::removeEdge(int edge, std::vector<int> &seeds)
+{
+  Edge &removed = m_edges[edge];
+
+  for (int node : removed.nodes)
+  {
+    m_edgeOfNode[node] = NONE;
+    seeds.push_back(node);
+  }
+  for (int vertex : {removed.from, removed.to})
+  {
+    for (int &vertexEdge : m_vertices[vertex].edges)
+    {
+      if (vertexEdge == edge)
+      {
+        vertexEdge = NONE;
+      }
+    }
+    // the remaining vertices need to find their new neighbors
+    m_traceQueue.push_back(vertex);
+  }
+
+  removed = Edge{};
+  m_freeEdges.push_back(edge);
+}
+
+void RoadNetwork::removeVertex(int vertex, std::vector<int> &seeds)
+{
+  for (int direction = 0; direction < 4; ++direction)
+  {
+    if (m_vertices[vertex].edges[direction] != NONE)
+    {
+      removeEdge(m_vertices[vertex].edges[direction], seeds);
+    }
+  }
+
+  m_vertexOfNode[m_vertices[vertex].node] = NONE;
+  seeds.push_back(m_vertices[vertex].node);
+  m_vertices[vertex].alive = false;
+  m_freeVertices.push_back(vertex);
+}
+
+void RoadNetwork::trace(int vertex, int direction)
+{
+  std::vector<int> nodes;
+  int currentDirection = direction;
+  int node = neighbor(m_vertices[vertex].node, direction);
+  int length = 1;
+
+  // follow the road until it reaches an intersection, a dead end or another vertex
+  while (m_vertexOfNode[node] == NONE && degree(node) == 2)
+  {
+    nodes.push_back(node);
+    for (int next = 0; next < 4; ++next)
+    {
+      const int n = neighbor(node, next);
+      if (next != (currentDirection ^ 1) && n != NONE && m_road[n])
+      {
+        currentDirection = next;
+        break;
+      }
+    }
+    node = neighbor(node, currentDirection);
+    length++;
+  }
+
+  const int end = ensureVertex(node);
+
+  int edge;
+  if (!m_freeEdges.empty())
+  {
+    edge = m_freeEdges.back();
+    m_freeEdges.pop_back();
+  }
+  else
+  {
+    edge = static_cast<int>(m_edges.size());
+    m_edges.emplace_back();
+  }
+
+  for (size_t i = 0; i < nodes.size(); ++i)
+  {
+    m_edgeOfNode[nodes[i]] = edge;
+    m_offsetInEdge[nodes[i]] = static_cast<int>(i) + 1;
+  }
+  m_edges[edge] = Edge{vertex, end, length, std::move(nodes), true};
+  m_vertices[vertex].edges[direction] = edge;
+  m_vertices[end].edges[currentDirection ^ 1] = edge;
+}
+
+void RoadNetwork::processTraceQueue()
+{
+  while (!m_traceQueue.empty())
+  {
+    const int vertex = m_traceQueue.back();
+    m_traceQueue.pop_back();
+
+    if (!m_vertices[vertex].alive)
+    {
+      continue;
+    }
+
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int n = neighbor(m_vertices[vertex].node, direction);
+      if (n != NONE && m_road[n] && m_vertices[vertex].edges[direction] == NONE)
+      {
+        trace(vertex, direction);
+      }
+    }
+  }
+}
+
+void RoadNetwork::update()
+{
+  if (m_dirtyNodes.empty())
+  {
+    return;
+  }
+
+  // remove everything around the changed nodes, the remaining graph stays untouched
+  std::vector<int> seeds;
+  for (int node : m_dirtyNodes)
+  {
+    for (int direction = -1; direction < 4; ++direction)
+    {
+      const int affected = direction < 0 ? node : neighbor(node, direction);
+      if (affected == NONE)
+      {
+        continue;
+      }
+
+      seeds.push_back(affected);
+      if (m_edgeOfNode[affected] != NONE)
+      {
+        removeEdge(m_edgeOfNode[affected], seeds);
+      }
+      if (m_vertexOfNode[affected] != NONE)
+      {
+        removeVertex(m_vertexOfNode[affected], seeds);
+      }
+    }
+  }
+  m_dirtyNodes.clear();
+
+  for (int seed : seeds)
+  {
+    if (m_road[seed] && m_vertexOfNode[seed] == NONE && m_edgeOfNode[seed] == NONE && degree(seed) != 2)
+    {
+      ensureVertex(seed);
+    }
+  }
+  processTraceQueue();
+
+  // roads that form a loop without any intersection need a vertex, too
+  for (int seed : seeds)
+  {
+    if (m_road[seed] && m_vertexOfNode[seed] == NONE && m_edgeOfNode[seed] == NONE)
+    {
+      ensureVertex(seed);
+      processTraceQueue();
+    }
+  }
+
+  m_graphVersion++;
+}
+
+std::vector<std::pair<int, int>> RoadNetwork::getEntryVertices(int node) const
+{
+  if (m_vertexOfNode[node] != NONE)
+  {
+    return {{m_vertexOfNode[node], 0}};
+  }
+  if (m_edgeOfNode[node] != NONE)
+  {
+    const Edge &edge = m_edges[m_edgeOfNode[node]];
+    const int offset = m_offsetInEdge[node];
+    return {{edge.from, offset}, {edge.to, edge.weight - offset}};
+  }
+  return {};
+}
+
+void RoadNetwork::dijkstra(const std::vector<std::pair<int, int>> &sources, std::vector<int> &distance) const
+{
+  distance.assign(m_vertices.size(), INFINITE_DISTANCE);
+  MinQueue queue;
+
+  for (const auto &[vertex, initial] : sources)
+  {
+    distance[vertex] = initial;
+    queue.push({initial, vertex});
+  }
+
+  while (!queue.empty())
+  {
+    const auto [dist, vertex] = queue.top();
+    queue.pop();
+
+    if (dist > distance[vertex])
+    {
+      continue;
+    }
+
+    for (int edge : m_vertices[vertex].edges)
+    {
+      if (edge == NONE)
+      {
+        continue;
+      }
+      const Edge &e = m_edges[edge];
+      const int other = e.from == vertex ? e.to : e.from;
+      if (dist + e.weight < distance[other])
+      {
+        distance[other] = dist + e.weight;
+        queue.push({distance[other], other});
+      }
+    }
+  }
+}
+
+void RoadNetwork::updateLandmarks()
+{
+  if (m_landmarkVersion == m_graphVersion)
+  {
+    return;
+  }
+
+  m_landmarkDistances.clear();
+  m_landmarkVersion = m_graphVersion;
+
+  // farthest point selection, vertices of unreached components are the farthest
+  std::vector<int> closest(m_vertices.size(), INFINITE_DISTANCE);
+  for (int i = 0; i < LandmarkCount; ++i)
+  {
+    int landmark = NONE;
+    for (int vertex = 0; vertex < static_cast<int>(m_vertices.size()); ++vertex)
+    {
+      if (m_vertices[vertex].alive && closest[vertex] > 0 && (landmark == NONE || closest[vertex] > closest[landmark]))
+      {
+        landmark = vertex;
+      }
+    }
+    if (landmark == NONE)
+    {
+      break;
+    }
+
+    m_landmarkDistances.emplace_back();
+    dijkstra({{landmark, 0}}, m_landmarkDistances.back());
+    for (size_t vertex = 0; vertex < closest.size(); ++vertex)
+    {
+      closest[vertex] = std::min(closest[vertex], m_landmarkDistances.back()[vertex]);
+    }
+  }
+}
+
+int RoadNetwork::heuristic(int vertex, const std::vector<std::pair<int, int>> &targets) const
+{
+  int best = INFINITE_DISTANCE;
+
+  for (const auto &[target, remaining] : targets)
+  {
+    int bound = 0;
+    for (const std::vector<int> &distance : m_landmarkDistances)
+    {
+      const bool vertexReached = distance[vertex] != INFINITE_DISTANCE;
+      const bool targetReached = distance[target] != INFINITE_DISTANCE;
+
+      if (vertexReached != targetReached)
+      {
+        // the landmark's component contains only one of them
+        bound = INFINITE_DISTANCE;
+        break;
+      }
+      if (vertexReached)
+      {
+        bound = std::max(bound, std::abs(distance[target] - distance[vertex]));
+      }
+    }
+    if (bound != INFINITE_DISTANCE)
+    {
+      best = std::min(best, bound + remaining);
+    }
+  }
+  return best;
+}
+
+int RoadNetwork::findDistance(int fromNode, int toNode)
+{
+  if (!m_road[fromNode] || !m_road[toNode])
+  {
+    return UNREACHABLE;
+  }
+  if (fromNode == toNode)
+  {
+    return 0;
+  }
+
+  const std::vector<std::pair<int, int>> sources = getEntryVertices(fromNode);
+  const std::vector<std::pair<int, int>> targets = getEntryVertices(toNode);
+
+  int best = INFINITE_DISTANCE;
+  if (m_edgeOfNode[fromNode] != NONE && m_edgeOfNode[fromNode] == m_edgeOfNode[toNode])
+  {
+    best = std::abs(m_offsetInEdge[fromNode] - m_offsetInEdge[toNode]);
+  }
+
+  if (hasContractionHierarchy())
+  {
+    std::vector<std::pair<int, int>> hierarchySources, hierarchyTargets;
+    for (const auto &[vertex, distance] : sources)
+    {
+      hierarchySources.emplace_back(m_hierarchyIndex[vertex], distance);
+    }
+    for (const auto &[vertex, distance] : targets)
+    {
+      hierarchyTargets.emplace_back(m_hierarchyIndex[vertex], distance);
+    }
+    best = std::min(best, m_hierarchy.query(hierarchySources, hierarchyTargets));
+    return best == INFINITE_DISTANCE ? UNREACHABLE : best;
+  }
+
+  updateLandmarks();
+  if (m_distance.size() < m_vertices.size())
+  {
+    m_distance.resize(m_vertices.size(), INFINITE_DISTANCE);
+    m_stamp.resize(m_vertices.size(), 0);
+  }
+  m_currentStamp++;
+
+  MinQueue queue;
+  auto relax = [&](int vertex, int distance) {
+    if (m_stamp[vertex] == m_currentStamp && m_distance[vertex] <= distance)
+    {
+      return;
+    }
+    const int estimate = heuristic(vertex, targets);
+    if (estimate == INFINITE_DISTANCE)
+    {
+      return;
+    }
+    m_stamp[vertex] = m_currentStamp;
+    m_distance[vertex] = distance;
+    queue.push({distance + estimate, vertex});
+  };
+
+  for (const auto &[vertex, distance] : sources)
+  {
+    relax(vertex, distance);
+  }
+
+  while (!queue.empty())
+  {
+    const auto [estimate, vertex] = queue.top();
+    queue.pop();
+
+    if (estimate >= best)
+    {
+      break;
+    }
+
+    const int distance = m_distance[vertex];
+    for (const auto &[target, remaining] : targets)
+    {
+      if (target == vertex)
+      {
+        best = std::min(best, distance + remaining);
+      }
+    }
+
+    for (int edge : m_vertices[vertex].edges)
+    {
+      if (edge != NONE)
+      {
+        const Edge &e = m_edges[edge];
+        relax(e.from == vertex ? e.to : e.from, distance + e.weight);
+      }
+    }
+  }
+
+  return best == INFINITE_DISTANCE ? UNREACHABLE : best;
+}
+
+int RoadNetwork::getDistance(const Point &from, const Point &to)
+{
+  update();
+  return findDistance(nodeIdx(from.x, from.y), nodeIdx(to.x, to.y));
+}
+
+std::vector<int> RoadNetwork::getDistances(const std::vector<std::pair<Point, Point>> &queries)
+{
+  update();
+
+  std::vector<int> distances;
+  distances.reserve(queries.size());
+  for (const auto &[from, to] : queries)
+  {
+    distances.push_back(findDistance(nodeIdx(from.x, from.y), nodeIdx(to.x, to.y)));
+  }
+  return distances;
+}
+
+void RoadNetwork::buildContractionHierarchy()
+{
+  update();
+
+  m_hierarchyIndex.assign(m_vertices.size(), NONE);
+  int vertexCount = 0;
+  for (size_t vertex = 0; vertex < m_vertices.size(); ++vertex)
+  {
+    if (m_vertices[vertex].alive)
+    {
+      m_hierarchyIndex[vertex] = vertexCount++;
+    }
+  }
+
+  std::vector<ContractionHierarchy::Edge> edges;
+  for (const Edge &edge : m_edges)
+  {
+    if (edge.alive)
+    {
+      edges.push_back({m_hierarchyIndex[edge.from], m_hierarchyIndex[edge.to], edge.weight});
+    }
+  }
+
+  m_hierarchy.build(vertexCount, edges);
+  m_hierarchyVersion = m_graphVersion;
+}
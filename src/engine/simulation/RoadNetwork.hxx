@@ -0,0 +1,139 @@
+#ifndef ROADNETWORK_HXX_
+#define ROADNETWORK_HXX_
+
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "basics/point.hxx"
+#include "ContractionHierarchy.hxx"
+
+/** @brief Graph of the road network.
+  * Intersections and dead ends are the vertices of the graph, the road segments between them are edges weighted by
+  * their length. The graph is patched locally when roads are placed or demolished.
+  * Distances are answered with A* using landmark lower bounds (ALT). For big networks that don't change anymore, a
+  * contraction hierarchy can be built, which is used until the next change.
+  */
+class RoadNetwork
+{
+public:
+  static constexpr int UNREACHABLE = -1;
+  /// Number of landmarks used for the A* heuristic
+  static constexpr int LandmarkCount = 8;
+
+  struct Vertex
+  {
+    int node = -1;                               /// node index of the intersection
+    std::array<int, 4> edges = {-1, -1, -1, -1}; /// edge leaving the vertex in each direction
+    bool alive = false;
+  };
+
+  struct Edge
+  {
+    int from = -1;          /// vertex index of the start
+    int to = -1;            /// vertex index of the end
+    int weight = 0;         /// length of the segment
+    std::vector<int> nodes; /// nodes between both vertices, ordered from start to end
+    bool alive = false;
+  };
+
+  RoadNetwork(int columns, int rows);
+
+  /** @brief Place or remove a road.
+    * The graph is patched on the next call to update().
+    */
+  void setRoad(int x, int y, bool road);
+
+  bool isRoad(int x, int y) const { return m_road[nodeIdx(x, y)]; };
+
+  /** @brief Get the coordinates of a node index used by the vertices and edges.
+    */
+  Point getNodeCoordinates(int node) const { return {node / m_columns, node % m_columns, 0, 0}; };
+
+  /** @brief Patch the graph around all changed roads.
+    */
+  void update();
+
+  /** @brief Get the distance along the roads between two road nodes.
+    * @return the number of road segments between both nodes, or UNREACHABLE.
+    */
+  int getDistance(const Point &from, const Point &to);
+
+  /** @brief Get the distances for a batch of queries.
+    * @param queries pairs of start and target node.
+    * @return the distance for each query, or UNREACHABLE.
+    */
+  std::vector<int> getDistances(const std::vector<std::pair<Point, Point>> &queries);
+
+  /** @brief Build a contraction hierarchy for the current network.
+    * Speeds up queries on big networks, until the network is changed the next time.
+    */
+  void buildContractionHierarchy();
+
+  /** @brief Check if queries are answered by the contraction hierarchy.
+    */
+  bool hasContractionHierarchy() const { return m_hierarchyVersion == m_graphVersion; };
+
+  /** @brief Get the vertex at the node, or -1 if the node is not an intersection or dead end.
+    */
+  int getVertex(int x, int y) const { return m_vertexOfNode[nodeIdx(x, y)]; };
+
+  const std::vector<Vertex> &getVertices() const { return m_vertices; };
+  const std::vector<Edge> &getEdges() const { return m_edges; };
+  size_t getVertexCount() const { return m_vertices.size() - m_freeVertices.size(); };
+  size_t getEdgeCount() const { return m_edges.size() - m_freeEdges.size(); };
+
+  /** @brief Get the version of the graph, which changes every time the graph is patched.
+    */
+  unsigned int getGraphVersion() const { return m_graphVersion; };
+
+private:
+  static constexpr int NONE = -1;
+  static constexpr int INFINITE_DISTANCE = std::numeric_limits<int>::max();
+
+  int m_columns;
+  int m_rows;
+  std::vector<bool> m_road;
+  std::vector<int> m_vertexOfNode;
+  /// edge of each node between two vertices, and its distance to the start of the edge
+  std::vector<int> m_edgeOfNode;
+  std::vector<int> m_offsetInEdge;
+  std::vector<Vertex> m_vertices;
+  std::vector<Edge> m_edges;
+  std::vector<int> m_freeVertices;
+  std::vector<int> m_freeEdges;
+  std::vector<int> m_dirtyNodes;
+  std::vector<int> m_traceQueue;
+  unsigned int m_graphVersion = 0;
+
+  /// distances from each landmark to every vertex
+  std::vector<std::vector<int>> m_landmarkDistances;
+  unsigned int m_landmarkVersion = std::numeric_limits<unsigned int>::max();
+
+  ContractionHierarchy m_hierarchy;
+  std::vector<int> m_hierarchyIndex;
+  unsigned int m_hierarchyVersion = std::numeric_limits<unsigned int>::max();
+
+  /// scratch data for A*
+  std::vector<int> m_distance;
+  std::vector<unsigned int> m_stamp;
+  unsigned int m_currentStamp = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  int neighbor(int node, int direction) const;
+  int degree(int node) const;
+  int ensureVertex(int node);
+  void removeVertex(int vertex, std::vector<int> &seeds);
+  void removeEdge(int edge, std::vector<int> &seeds);
+  void trace(int vertex, int direction);
+  void processTraceQueue();
+  std::vector<std::pair<int, int>> getEntryVertices(int node) const;
+  void dijkstra(const std::vector<std::pair<int, int>> &sources, std::vector<int> &distance) const;
+  void updateLandmarks();
+  int heuristic(int vertex, const std::vector<std::pair<int, int>> &targets) const;
+  int findDistance(int fromNode, int toNode);
+};
+
+#endif
@@ -0,0 +1,213 @@
+#include "ServiceCoverage.hxx"
+
+#include "RoadNetwork.hxx"
+#include "tileData.hxx"
+
+#include <algorithm>
+
+ServiceCoverage::ServiceCoverage(const RoadNetwork &roads, int columns, int rows)
+    : m_roads(roads), m_columns(columns), m_rows(rows)
+{
+  for (auto &distances : m_distances)
+  {
+    distances.assign(columns * rows, UNCOVERED);
+  }
+  m_dirty.fill(false);
+}
+
+ServiceCoverage::Service ServiceCoverage::getService(const TileData &tileData)
+{
+  if (tileData.category == "Police")
+  {
+    return POLICE;
+  }
+  if (tileData.category == "Fire")
+  {
+    return FIRE;
+  }
+  if (tileData.category == "School")
+  {
+    return EDUCATION;
+  }
+  if (tileData.category == "Medical")
+  {
+    return HEALTH;
+  }
+  return SERVICES_COUNT;
+}
+
+int ServiceCoverage::getRange(Service service)
+{
+  switch (service)
+  {
+  case POLICE:
+    return 24;
+  case FIRE:
+    return 20;
+  case EDUCATION:
+    return 30;
+  case HEALTH:
+  default:
+    return 32;
+  }
+}
+
+int ServiceCoverage::neighbor(int node, int direction) const
+{
+  const int x = node / m_columns;
+  const int y = node % m_columns;
+
+  switch (direction)
+  {
+  case 0:
+    return x > 0 ? node - m_columns : -1;
+  case 1:
+    return x < m_rows - 1 ? node + m_columns : -1;
+  case 2:
+    return y > 0 ? node - 1 : -1;
+  default:
+    return y < m_columns - 1 ? node + 1 : -1;
+  }
+}
+
+void ServiceCoverage::setStation(int x, int y, Service service, bool station)
+{
+  std::vector<int> &stations = m_stations[service];
+  const int node = nodeIdx(x, y);
+  auto it = std::find(stations.begin(), stations.end(), node);
+
+  if (station && it == stations.end())
+  {
+    stations.push_back(node);
+    m_dirty[service] = true;
+  }
+  else if (!station && it != stations.end())
+  {
+    *it = stations.back();
+    stations.pop_back();
+    m_dirty[service] = true;
+  }
+}
+
+void ServiceCoverage::onRoadChanged(int x, int y)
+{
+  for (unsigned int service = 0; service < SERVICES_COUNT; ++service)
+  {
+    // the bounds include the ring of nodes around the covered area, where a new road can extend the coverage
+    if (m_bounds[service].contains(x, y))
+    {
+      m_dirty[service] = true;
+    }
+  }
+}
+
+void ServiceCoverage::update()
+{
+  m_changedBounds.clear();
+  for (unsigned int service = 0; service < SERVICES_COUNT; ++service)
+  {
+    if (m_dirty[service])
+    {
+      recompute(static_cast<Service>(service));
+      m_dirty[service] = false;
+    }
+  }
+}
+
+float ServiceCoverage::getCoverage(Service service, int x, int y) const
+{
+  const int distance = getDistance(service, x, y);
+  if (distance == UNCOVERED)
+  {
+    return 0.f;
+  }
+  return 1.f - static_cast<float>(distance) / static_cast<float>(getRange(service) + 1);
+}
+
+void ServiceCoverage::recompute(Service service)
+{
+  std::vector<int> &distances = m_distances[service];
+  std::fill(distances.begin(), distances.end(), UNCOVERED);
+  const int range = getRange(service);
+  Bounds &bounds = m_bounds[service];
+  if (!bounds.isEmpty())
+  {
+    m_changedBounds.push_back(bounds);
+  }
+  bounds = Bounds{m_rows, m_columns, -1, -1};
+  ++m_recomputeCount;
+
+  auto isRoad = [this](int node) { return m_roads.isRoad(node / m_columns, node % m_columns); };
+  auto reach = [this, &distances, &bounds](int node, int distance) {
+    distances[node] = distance;
+    const int x = node / m_columns;
+    const int y = node % m_columns;
+    bounds.minX = std::min(bounds.minX, x - 1);
+    bounds.minY = std::min(bounds.minY, y - 1);
+    bounds.maxX = std::max(bounds.maxX, x + 1);
+    bounds.maxY = std::max(bounds.maxY, y + 1);
+  };
+
+  // the station nodes and the roads they touch are the sources
+  m_queue.clear();
+  for (int station : m_stations[service])
+  {
+    reach(station, 0);
+  }
+  for (int station : m_stations[service])
+  {
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int next = neighbor(station, direction);
+      if (next != -1 && distances[next] == UNCOVERED && isRoad(next))
+      {
+        reach(next, 0);
+        m_queue.push_back(next);
+      }
+    }
+  }
+
+  // all road segments have the same length, so a breadth-first search visits the nodes in order of their distance
+  for (size_t head = 0; head < m_queue.size(); ++head)
+  {
+    const int node = m_queue[head];
+    const int distance = distances[node] + 1;
+    if (distance > range)
+    {
+      continue;
+    }
+
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int next = neighbor(node, direction);
+      if (next != -1 && distances[next] == UNCOVERED && isRoad(next))
+      {
+        reach(next, distance);
+        m_queue.push_back(next);
+      }
+    }
+  }
+
+  // project the reached roads onto the nodes next to them
+  for (int node : m_queue)
+  {
+    const int distance = distances[node] + 1;
+    if (distance > range)
+    {
+      continue;
+    }
+
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int next = neighbor(node, direction);
+      if (next != -1 && !isRoad(next) && (distances[next] == UNCOVERED || distances[next] > distance))
+      {
+        distances[next] = distance;
+      }
+    }
+  }
+  if (!bounds.isEmpty())
+  {
+    m_changedBounds.push_back(bounds);
+  }
+}
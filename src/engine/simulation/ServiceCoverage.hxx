@@ -0,0 +1,111 @@
+#ifndef SERVICECOVERAGE_HXX_
+#define SERVICECOVERAGE_HXX_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+class RoadNetwork;
+struct TileData;
+
+/** @brief Coverage of service buildings like police stations, fire stations, schools and hospitals.
+  * The coverage of a service is the distance along the roads to its nearest station. It is computed with a bounded
+  * breadth-first search over the road nodes that starts from all stations of the service at once, and then projected
+  * onto the nodes next to the reached roads.
+  * A service is only recomputed if one of its stations changed or a road inside its covered area changed.
+  */
+class ServiceCoverage
+{
+public:
+  enum Service : unsigned int
+  {
+    POLICE,
+    FIRE,
+    EDUCATION,
+    HEALTH,
+    SERVICES_COUNT
+  };
+
+  static constexpr int UNCOVERED = -1;
+
+  /// Rectangle of nodes, the maxima are inclusive
+  struct Bounds
+  {
+    int minX = 0;
+    int minY = 0;
+    int maxX = -1;
+    int maxY = -1;
+
+    bool contains(int x, int y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; };
+    bool isEmpty() const { return maxX < minX || maxY < minY; };
+  };
+
+  ServiceCoverage(const RoadNetwork &roads, int columns, int rows);
+
+  /** @brief Get the service a building provides.
+    * @return the service, or SERVICES_COUNT if the building doesn't provide any.
+    */
+  static Service getService(const TileData &tileData);
+
+  /** @brief Get the maximum road distance a service covers.
+    */
+  static int getRange(Service service);
+
+  /** @brief Add or remove a node of a station.
+    * Multi-node buildings add all their nodes.
+    */
+  void setStation(int x, int y, Service service, bool station);
+
+  /** @brief Notify the coverage about a placed or removed road.
+    * Must be called after the road has been set in the road network.
+    */
+  void onRoadChanged(int x, int y);
+
+  /** @brief Recompute the coverage of all changed services.
+    */
+  void update();
+
+  /** @brief Get the distance from a node to the nearest station of a service.
+    * @return the distance, or UNCOVERED if no station is in range.
+    */
+  int getDistance(Service service, int x, int y) const { return m_distances[service][nodeIdx(x, y)]; };
+
+  /** @brief Get the coverage of a node by a service.
+    * @return 1 next to a station, falling off to 0 at the range of the service.
+    */
+  float getCoverage(Service service, int x, int y) const;
+
+  /** @brief Get the distances of a service, indexed like the map nodes.
+    */
+  const std::vector<int> &getDistances(Service service) const { return m_distances[service]; };
+
+  /** @brief Get the number of times a service has been recomputed, for profiling.
+    */
+  size_t getRecomputeCount() const { return m_recomputeCount; };
+
+  /** @brief Get the areas where the coverage may have changed by the last update().
+    * These are the old and the new covered area of every recomputed service.
+    */
+  const std::vector<Bounds> &getChangedBounds() const { return m_changedBounds; };
+
+private:
+  const RoadNetwork &m_roads;
+  int m_columns;
+  int m_rows;
+  /// station nodes of each service
+  std::array<std::vector<int>, SERVICES_COUNT> m_stations;
+  std::array<std::vector<int>, SERVICES_COUNT> m_distances;
+  /// nodes whose changes can affect each service
+  std::array<Bounds, SERVICES_COUNT> m_bounds;
+  std::vector<Bounds> m_changedBounds;
+  std::array<bool, SERVICES_COUNT> m_dirty;
+  size_t m_recomputeCount = 0;
+  /// scratch queue of the search
+  std::vector<int> m_queue;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  int neighbor(int node, int direction) const;
+  void recompute(Service service);
+};
+
+#endif
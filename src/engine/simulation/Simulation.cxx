@@ -0,0 +1,760 @@
+#include "Simulation.hxx"
+
+#include "Map.hxx"
+#include "WindowManager.hxx"
+#include "basics/Camera.hxx"
+#include "basics/isoMath.hxx"
+#include "map/MapLayers.hxx"
+#include "LOG.hxx"
+#include "ByteStream.hxx"
+#include "Hash.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+namespace
+{
+/// Average number of cars per road node
+constexpr float TRAFFIC_DENSITY = 0.25f;
+/// Influence field value that is shown with the color at the end of the color ramp
+constexpr float DATA_MAP_FIELD_RANGE = 10.f;
+/// Number of ticks between two cross-checks of the city statistics in debug builds
+constexpr unsigned int CITY_STATS_CHECK_INTERVAL = 60;
+/// One tick is one game minute
+constexpr unsigned int TICKS_PER_DAY = 24 * 60;
+/// The budget is closed every 30 game days
+constexpr unsigned int TICKS_PER_MONTH = 30 * TICKS_PER_DAY;
+/// A random fire may break out once per game hour
+constexpr unsigned int TICKS_PER_SPARK = 60;
+/// Version of the saved simulation state, increase it when the format changes
+constexpr uint64_t SIMULATION_DATA_VERSION = 6;
+/// Maximum distance between the origin of a building and the road it is connected to
+constexpr int ROAD_ACCESS_DISTANCE = 3;
+} // namespace
+
+Simulation::Simulation(Map &map, uint64_t seed)
+    : m_map(map), m_stateHash(map.getColumns(), map.getRows()), m_buildings(map.getColumns(), map.getRows()),
+      m_zoneGrowth(map), m_lifecycle(map, m_buildings, m_zoneGrowth),
+      m_powerGrid(map.getColumns(), map.getRows()), m_waterNetwork(map.getColumns(), map.getRows()),
+      m_roadNetwork(map.getColumns(), map.getRows()),
+      m_traffic(m_roadNetwork), m_transitLines(map.getColumns(), map.getRows()), m_influenceFields(map.getColumns(), map.getRows()),
+      m_serviceCoverage(m_roadNetwork, map.getColumns(), map.getRows()),
+      m_landValue(m_influenceFields, m_serviceCoverage, map.getColumns(), map.getRows()),
+      m_fireSpread(map.getColumns(), map.getRows()), m_spatialIndex(map.getColumns(), map.getRows()),
+      m_jobMarket(map.getColumns(), map.getRows()), m_demand(map.getColumns(), map.getRows()),
+      m_population(map.getColumns(), map.getRows()),
+      m_dataMapOverlay(map.getColumns(), map.getRows())
+{
+  setSeed(seed);
+  m_traffic.setDensity(TRAFFIC_DENSITY);
+  m_jobMarket.setCommuteFunction([this](const Point &from, const Point &to) { return getCommute(from, to); });
+  m_nodeChangedConnection = m_map.signalNodeChanged.connect([this](const MapNodeChange &change) { onNodeChanged(change); });
+}
+
+Simulation::~Simulation() { m_map.signalNodeChanged.disconnect(m_nodeChangedConnection); }
+
+void Simulation::rebuild()
+{
+  for (int x = 0; x < m_map.getRows(); x++)
+  {
+    for (int y = 0; y < m_map.getColumns(); y++)
+    {
+      const MapNode *node = m_map.getMapNode(Point{x, y, 0, 0});
+
+      for (unsigned int layer = 0; layer < LAYERS_COUNT; ++layer)
+      {
+        const MapNodeData &mapNodeData = node->getMapNodeDataForLayer(static_cast<Layer>(layer));
+
+        if (mapNodeData.tileData)
+        {
+          onNodeChanged(MapNodeChange{node->getCoordinates(), static_cast<Layer>(layer), nullptr, mapNodeData.tileData,
+                                      Point::INVALID(), mapNodeData.origCornerPoint});
+        }
+      }
+    }
+  }
+
+  // a city without population data starts with its housing fully occupied, load() replaces the residents if it has some
+  m_population.settle();
+  m_powerGrid.update();
+  m_waterNetwork.update();
+  m_roadNetwork.update();
+  m_transitLines.update(m_roadNetwork);
+  m_influenceFields.update();
+  m_serviceCoverage.update();
+  updateLandValue();
+  m_jobMarket.update();
+  m_demand.setEmployed(m_jobMarket.getEmployed());
+  m_demand.resetAverage();
+  updateDemand(false);
+  updateBuildings();
+  updateFires();
+  updateDataMap();
+  m_stateHash.update();
+}
+
+void Simulation::setSeed(uint64_t seed)
+{
+  m_randomStreams.setSeed(seed);
+  m_zoneGrowth.setSeed(m_randomStreams.getSeed(RandomStreams::ZONE_GROWTH));
+  m_traffic.setSeed(m_randomStreams.getSeed(RandomStreams::TRAFFIC));
+  m_fireSpread.setSeed(m_randomStreams.getSeed(RandomStreams::FIRE));
+  m_map.setRandomSeed(m_randomStreams.getSeed(RandomStreams::MAP_EDITS));
+  m_commandLog.reset(seed);
+}
+
+void Simulation::save(std::vector<uint8_t> &buffer) const
+{
+  ByteWriter writer(buffer);
+  writer.writeVarint(SIMULATION_DATA_VERSION);
+  writer.writeVarint(m_tickCount);
+  m_history.save(writer);
+  writer.writeVarint(m_randomStreams.getSeed());
+  writer.writeSignedVarint(m_budget.getFunds());
+  for (unsigned int category = Budget::RESIDENTIAL_TAX; category <= Budget::INDUSTRIAL_TAX; ++category)
+  {
+    writer.writeVarint(m_budget.getTaxRate(static_cast<Budget::Category>(category)));
+  }
+  m_population.save(writer);
+  m_transitLines.save(writer);
+  m_buildings.save(writer);
+}
+
+void Simulation::load(const std::vector<uint8_t> &buffer)
+{
+  if (buffer.empty())
+  {
+    return;
+  }
+
+  // parse everything into copies first, so malformed data leaves the simulation as rebuild() left it
+  History history;
+  uint64_t seed = m_randomStreams.getSeed();
+  Budget budget = m_budget;
+  Population population = m_population;
+  TransitLines transitLines = m_transitLines;
+  BuildingStore buildings = m_buildings;
+  unsigned int tickCount = m_tickCount;
+  try
+  {
+    ByteReader reader(buffer);
+    const uint64_t version = reader.readVarint();
+    if (version == 0 || version > SIMULATION_DATA_VERSION)
+    {
+      throw CytopiaError{TRACE_INFO "Unsupported version of the simulation data"};
+    }
+    tickCount = static_cast<unsigned int>(reader.readVarint());
+    history.load(reader);
+    // version 1 had no seed, the simulation keeps the one it has been created with
+    if (version >= 2)
+    {
+      seed = reader.readVarint();
+    }
+    // version 2 had no budget, the city starts with the default funds
+    if (version >= 3)
+    {
+      budget.setFunds(reader.readSignedVarint());
+      for (unsigned int category = Budget::RESIDENTIAL_TAX; category <= Budget::INDUSTRIAL_TAX; ++category)
+      {
+        budget.setTaxRate(static_cast<Budget::Category>(category), static_cast<int>(reader.readVarint()));
+      }
+    }
+    // version 3 had no population, the housing stays occupied like rebuild() left it
+    if (version >= 4)
+    {
+      population.load(reader);
+    }
+    // version 4 had no transit lines
+    if (version >= 5)
+    {
+      transitLines.load(reader);
+    }
+    // version 5 had no ages, the buildings are as old as if they had just been placed
+    if (version >= 6)
+    {
+      buildings.load(reader);
+    }
+  }
+  catch (const CytopiaError &e)
+  {
+    LOG(LOG_ERROR) << "Could not load the simulation state: " << e.what();
+    return;
+  }
+
+  m_tickCount = tickCount;
+  m_history = std::move(history);
+  setSeed(seed);
+  m_budget = std::move(budget);
+  m_population = std::move(population);
+  m_transitLines = std::move(transitLines);
+  m_buildings = std::move(buildings);
+  // the buildings have been scheduled by rebuild() on the first day
+  m_lifecycle.reset(m_tickCount / TICKS_PER_DAY);
+}
+
+void Simulation::applyCommand(const MapCommand &command)
+{
+  if (command.type == MapCommand::ADD_LINE)
+  {
+    // the range check comes first, casting a float that doesn't fit into an int is undefined
+    const bool validVehicles = command.value >= 1.f && command.value <= TransitLines::MaxVehicles;
+    if (!validVehicles || !m_transitLines.addLine(command.nodes, static_cast<int>(command.value)))
+    {
+      LOG(LOG_INFO) << "A transit line needs at least two stops and between 1 and " << TransitLines::MaxVehicles
+                    << " vehicles";
+    }
+    return;
+  }
+  if (command.type == MapCommand::REMOVE_LINE)
+  {
+    if (!command.nodes.empty())
+    {
+      m_transitLines.removeLineAt(command.nodes.front());
+    }
+    return;
+  }
+
+  m_budget.beginEdit();
+  m_map.applyCommand(command);
+  m_budget.endEdit(m_tickCount);
+}
+
+void Simulation::tick()
+{
+  ++m_tickCount;
+  m_zoneGrowth.tick();
+  m_powerGrid.update();
+  m_waterNetwork.update();
+  m_roadNetwork.update();
+  m_transitLines.update(m_roadNetwork);
+  m_influenceFields.update();
+  m_serviceCoverage.update();
+  updateLandValue();
+  m_jobMarket.update();
+  updateDemand(m_tickCount % TICKS_PER_DAY == 0);
+  updateBuildings();
+  m_lifecycle.tick(m_tickCount / TICKS_PER_DAY);
+  updateFires();
+  updateDataMap();
+  m_stateHash.update();
+
+  if (m_tickCount % TICKS_PER_DAY == 0)
+  {
+    m_history.record(m_cityStats);
+    updateTransit();
+  }
+  if (m_tickCount % TICKS_PER_MONTH == 0)
+  {
+    updatePopulation();
+    m_budget.closeMonth(m_tickCount);
+  }
+
+  debug_scope {
+    if (m_tickCount % CITY_STATS_CHECK_INTERVAL == 0)
+    {
+      CityStats recounted;
+      recounted.recount(m_map);
+      if (recounted != m_cityStats)
+      {
+        LOG(LOG_ERROR) << "City statistics differ from a full recount, population " << m_cityStats.getPopulation()
+                       << " instead of " << recounted.getPopulation();
+      }
+    }
+  }
+}
+
+void Simulation::advance(float seconds) { m_traffic.advance(seconds); }
+
+void Simulation::render()
+{
+  m_dataMapOverlay.render(m_map);
+  renderFires();
+  renderVehicles();
+}
+
+void Simulation::renderVehicles()
+{
+  if (!MapLayers::isLayerActive(Layer::MOVABLE_OBJECTS))
+  {
+    return;
+  }
+
+  const double zoomLevel = Camera::instance().zoomLevel();
+  const int agentSize = std::max(1, static_cast<int>(std::round(3 * zoomLevel)));
+  SDL_Renderer *renderer = WindowManager::instance().getRenderer();
+  SDL_Rect rect;
+
+  m_renderRects.clear();
+  for (size_t agent = 0; agent < m_traffic.getAgentCount(); ++agent)
+  {
+    float x, y;
+    if (m_traffic.getAgentPosition(agent, x, y) && getVehicleRect(x, y, agentSize, rect))
+    {
+      m_renderRects.push_back(rect);
+    }
+  }
+  SDL_SetRenderDrawColor(renderer, 200, 40, 40, SDL_ALPHA_OPAQUE);
+  SDL_RenderFillRects(renderer, m_renderRects.data(), static_cast<int>(m_renderRects.size()));
+
+  // the buses are computed from the schedule, so they don't need to be stepped between the ticks
+  m_renderRects.clear();
+  for (size_t line = 0; line < m_transitLines.getLines().size(); ++line)
+  {
+    for (int vehicle = 0; vehicle < m_transitLines.getLines()[line].vehicles; ++vehicle)
+    {
+      float x, y;
+      if (m_transitLines.getVehiclePosition(line, vehicle, m_tickCount, x, y) && getVehicleRect(x, y, agentSize * 2, rect))
+      {
+        m_renderRects.push_back(rect);
+      }
+    }
+  }
+  SDL_SetRenderDrawColor(renderer, 240, 200, 30, SDL_ALPHA_OPAQUE);
+  SDL_RenderFillRects(renderer, m_renderRects.data(), static_cast<int>(m_renderRects.size()));
+}
+
+bool Simulation::getVehicleRect(float x, float y, int size, SDL_Rect &rect) const
+{
+  const Point node{static_cast<int>(std::lround(x)), static_cast<int>(std::lround(y)), 0, 0};
+  if (!m_map.isNodeVisible(node))
+  {
+    return false;
+  }
+
+  const double zoomLevel = Camera::instance().zoomLevel();
+  const SDL_Point &tileSize = Camera::instance().tileSize();
+
+  // screen coordinates are the bottom corner of the node, move them to the center and add the offset between nodes
+  const SDL_Point screen = convertIsoToScreenCoordinates(m_map.getMapNode(node)->getCoordinates());
+  const float dx = x - static_cast<float>(node.x);
+  const float dy = y - static_cast<float>(node.y);
+  const int centerX = screen.x + static_cast<int>((dx + dy) * tileSize.x * zoomLevel / 2);
+  const int centerY = screen.y - static_cast<int>(tileSize.y * zoomLevel / 2) +
+                      static_cast<int>((dx - dy) * tileSize.y * zoomLevel / 2);
+  rect = {centerX - size / 2, centerY - size / 2, size, size};
+  return true;
+}
+
+void Simulation::onNodeChanged(const MapNodeChange &change)
+{
+  m_stateHash.setNode(change.isoCoordinates.x, change.isoCoordinates.y, getNodeHash(change.isoCoordinates));
+  m_cityStats.onNodeChanged(change);
+  m_budget.onNodeChanged(change);
+  m_spatialIndex.setTile(change.isoCoordinates.x, change.isoCoordinates.y, change.layer, change.newTileData);
+  m_zoneGrowth.onNodeChanged(change);
+
+  if (change.layer == Layer::BUILDINGS)
+  {
+    const Point &coords = change.isoCoordinates;
+    const TileData *tileData = change.newTileData;
+    const bool conductor = tileData && PowerGrid::isConductor(*tileData);
+    // multi-node buildings produce / consume their power on their origin node only
+    const int power = (conductor && coords == change.newOrigCornerPoint) ? tileData->power : 0;
+    m_powerGrid.setNode(coords.x, coords.y, conductor, power);
+
+    if (change.oldTileData && coords == change.oldOrigCornerPoint)
+    {
+      addInfluence(coords, *change.oldTileData, -1);
+    }
+    if (tileData && coords == change.newOrigCornerPoint)
+    {
+      addInfluence(coords, *tileData, 1);
+    }
+
+    const bool building = tileData && BuildingStore::isBuilding(*tileData);
+    const Point &origin = change.newOrigCornerPoint;
+    m_buildings.setNode(coords.x, coords.y, building ? origin.x * m_map.getColumns() + origin.y : 0,
+                        building ? tileData : nullptr);
+
+    if (change.oldTileData && coords == change.oldOrigCornerPoint)
+    {
+      m_jobMarket.removeHousing(coords.x, coords.y);
+      m_jobMarket.removeWorkplace(coords.x, coords.y);
+      if (BuildingStore::isBuilding(*change.oldTileData))
+      {
+        m_demand.addBuilding(coords.x, coords.y, *change.oldTileData, -1);
+        if (CityStats::isResidential(*change.oldTileData))
+        {
+          m_population.addHousing(coords.x, coords.y, change.oldTileData->inhabitants, -1);
+        }
+      }
+    }
+    if (building && coords == origin)
+    {
+      m_lifecycle.add(m_buildings.getBuildingAt(coords.x, coords.y), m_tickCount / TICKS_PER_DAY);
+      m_demand.addBuilding(coords.x, coords.y, *tileData, 1);
+      if (CityStats::isResidential(*tileData))
+      {
+        m_jobMarket.addHousing(coords.x, coords.y, tileData->inhabitants, tileData->educationLevel);
+        m_population.addHousing(coords.x, coords.y, tileData->inhabitants, 1);
+      }
+      else if (tileData->inhabitants > 0)
+      {
+        m_jobMarket.addWorkplace(coords.x, coords.y, tileData->inhabitants, tileData->educationLevel);
+      }
+    }
+    m_fireSpread.setFlammability(coords.x, coords.y, tileData ? FireSpread::getFlammability(*tileData) : 0);
+
+    if (change.oldTileData && ServiceCoverage::getService(*change.oldTileData) != ServiceCoverage::SERVICES_COUNT)
+    {
+      m_serviceCoverage.setStation(coords.x, coords.y, ServiceCoverage::getService(*change.oldTileData), false);
+    }
+    if (tileData && ServiceCoverage::getService(*tileData) != ServiceCoverage::SERVICES_COUNT)
+    {
+      m_serviceCoverage.setStation(coords.x, coords.y, ServiceCoverage::getService(*tileData), true);
+    }
+
+    if (tileData && (tileData->tileType == +TileType::RCI || tileData->water != 0))
+    {
+      m_waterNetwork.setBuildingNode(coords.x, coords.y, change.newOrigCornerPoint.x, change.newOrigCornerPoint.y,
+                                     tileData->water);
+    }
+    else
+    {
+      m_waterNetwork.clearBuildingNode(coords.x, coords.y);
+    }
+  }
+  else if (change.layer == Layer::ROAD)
+  {
+    m_roadNetwork.setRoad(change.isoCoordinates.x, change.isoCoordinates.y, change.newTileData != nullptr);
+    m_serviceCoverage.onRoadChanged(change.isoCoordinates.x, change.isoCoordinates.y);
+  }
+  else if (change.layer == Layer::WATER)
+  {
+    m_landValue.setWater(change.isoCoordinates.x, change.isoCoordinates.y, change.newTileData != nullptr);
+  }
+  else if (change.layer == Layer::TERRAIN)
+  {
+    m_landValue.setHeight(change.isoCoordinates.x, change.isoCoordinates.y, change.isoCoordinates.height);
+  }
+  else if (change.layer == Layer::UNDERGROUND)
+  {
+    const bool pipe = change.newTileData && change.newTileData->tileType == +TileType::UNDERGROUND;
+    m_waterNetwork.setPipe(change.isoCoordinates.x, change.isoCoordinates.y, pipe);
+  }
+}
+
+uint64_t Simulation::getNodeHash(const Point &isoCoordinates) const
+{
+  const MapNode *node = m_map.getMapNode(isoCoordinates);
+  uint64_t hash = static_cast<uint64_t>(node->getCoordinates().height);
+
+  for (unsigned int layer = 0; layer < LAYERS_COUNT; ++layer)
+  {
+    const MapNodeData &mapNodeData = node->getMapNodeDataForLayer(static_cast<Layer>(layer));
+    const int32_t values[] = {static_cast<int32_t>(layer), mapNodeData.tileIndex, mapNodeData.origCornerPoint.x,
+                              mapNodeData.origCornerPoint.y};
+    hash = xxHash64(mapNodeData.tileID.data(), mapNodeData.tileID.size(), hash);
+    hash = xxHash64(values, sizeof(values), hash);
+  }
+  return hash;
+}
+
+void Simulation::addInfluence(const Point &origin, const TileData &tileData, int sign)
+{
+  m_influenceFields.addSource(origin.x, origin.y, InfluenceFields::POLLUTION, sign * tileData.pollutionLevel);
+  m_influenceFields.addSource(origin.x, origin.y, InfluenceFields::CRIME, sign * tileData.crimeLevel);
+  m_influenceFields.addSource(origin.x, origin.y, InfluenceFields::FIRE_HAZARD, sign * tileData.fireHazardLevel);
+  m_influenceFields.addSource(origin.x, origin.y, InfluenceFields::HAPPINESS, sign * tileData.happiness);
+  m_influenceFields.addSource(origin.x, origin.y, InfluenceFields::EDUCATION, sign * tileData.educationLevel);
+}
+
+int Simulation::getCommute(const Point &from, const Point &to)
+{
+  Point fromRoad;
+  Point toRoad;
+  if (!m_spatialIndex.findNearest(SpatialIndex::ROAD, from.x, from.y, ROAD_ACCESS_DISTANCE, fromRoad) ||
+      !m_spatialIndex.findNearest(SpatialIndex::ROAD, to.x, to.y, ROAD_ACCESS_DISTANCE, toRoad))
+  {
+    return std::abs(from.x - to.x) + std::abs(from.y - to.y);
+  }
+
+  const int distance = m_roadNetwork.getDistance(fromRoad, toRoad);
+  if (distance == RoadNetwork::UNREACHABLE)
+  {
+    return JobMarket::UNREACHABLE;
+  }
+  return distance + std::abs(from.x - fromRoad.x) + std::abs(from.y - fromRoad.y) + std::abs(to.x - toRoad.x) +
+         std::abs(to.y - toRoad.y);
+}
+
+void Simulation::updateLandValue()
+{
+  const int tileColumns = m_influenceFields.getTileColumns();
+  for (int tile : m_influenceFields.getUpdatedTiles())
+  {
+    const int x = (tile / tileColumns) * InfluenceFields::TileSize;
+    const int y = (tile % tileColumns) * InfluenceFields::TileSize;
+    m_landValue.markDirty(x, y, x + InfluenceFields::TileSize - 1, y + InfluenceFields::TileSize - 1);
+  }
+  for (const ServiceCoverage::Bounds &bounds : m_serviceCoverage.getChangedBounds())
+  {
+    m_landValue.markDirty(bounds.minX, bounds.minY, bounds.maxX, bounds.maxY);
+  }
+
+  m_landValue.update();
+
+  for (int chunk : m_landValue.getUpdatedChunks())
+  {
+    int minX, minY, maxX, maxY;
+    m_landValue.getChunkBounds(chunk, minX, minY, maxX, maxY);
+    for (int x = minX; x < maxX; x++)
+    {
+      for (int y = minY; y < maxY; y++)
+      {
+        m_zoneGrowth.setNodeWealth(Point{x, y}, LandValue::getWealth(m_landValue.getValue(x, y)));
+      }
+    }
+  }
+}
+
+void Simulation::updateDemand(bool newDay)
+{
+  m_demand.setEmployed(m_jobMarket.getEmployed());
+  if (newDay)
+  {
+    m_demand.updateDay();
+  }
+  m_zoneGrowth.setSpawnWeight(Zones::RESIDENTIAL, m_demand.getSpawnWeight(Demand::RESIDENTIAL));
+  m_zoneGrowth.setSpawnWeight(Zones::COMMERCIAL, m_demand.getSpawnWeight(Demand::COMMERCIAL));
+  m_zoneGrowth.setSpawnWeight(Zones::INDUSTRIAL, m_demand.getSpawnWeight(Demand::INDUSTRIAL));
+  m_zoneGrowth.setSpawnWeight(Zones::AGRICULTURAL, m_demand.getSpawnWeight(Demand::INDUSTRIAL));
+}
+
+void Simulation::updateTransit()
+{
+  m_transitLines.updateRidership(m_buildings);
+  m_traffic.setDensity(TRAFFIC_DENSITY * (1.f - m_transitLines.getRiderShare()));
+}
+
+void Simulation::updatePopulation()
+{
+  for (int chunkX = 0; chunkX < m_population.getChunkRows(); ++chunkX)
+  {
+    for (int chunkY = 0; chunkY < m_population.getChunkColumns(); ++chunkY)
+    {
+      // the coverage of the chunk center stands for the whole chunk
+      const int x = std::min(chunkX * Population::ChunkSize + Population::ChunkSize / 2, m_map.getRows() - 1);
+      const int y = std::min(chunkY * Population::ChunkSize + Population::ChunkSize / 2, m_map.getColumns() - 1);
+      m_population.setEducation(chunkX, chunkY, m_serviceCoverage.getCoverage(ServiceCoverage::EDUCATION, x, y));
+    }
+  }
+  m_population.setAttractiveness(m_demand.getDemand(Demand::RESIDENTIAL));
+  m_population.updateMonth();
+}
+
+void Simulation::updateBuildings()
+{
+  const std::vector<int> &origins = m_buildings.getOrigins();
+  std::vector<uint8_t> &powered = m_buildings.getPowered();
+  std::vector<float> &waterServed = m_buildings.getWaterServed();
+  std::vector<float> &landValue = m_buildings.getLandValue();
+  const bool newDay = m_tickCount % TICKS_PER_DAY == 0;
+
+  for (size_t building = 0; building < m_buildings.size(); ++building)
+  {
+    const int x = origins[building] / m_map.getColumns();
+    const int y = origins[building] % m_map.getColumns();
+    powered[building] = m_powerGrid.isPowered(x, y);
+    waterServed[building] = m_waterNetwork.getServedFraction(x, y);
+    landValue[building] = m_landValue.getValue(x, y) / 255.f;
+  }
+
+  if (newDay)
+  {
+    for (uint32_t &age : m_buildings.getAge())
+    {
+      age++;
+    }
+  }
+}
+
+void Simulation::updateFires()
+{
+  if (m_serviceCoverage.getRecomputeCount() != m_suppressionVersion)
+  {
+    m_suppressionVersion = m_serviceCoverage.getRecomputeCount();
+    for (int x = 0; x < m_map.getRows(); x++)
+    {
+      for (int y = 0; y < m_map.getColumns(); y++)
+      {
+        const float coverage = m_serviceCoverage.getCoverage(ServiceCoverage::FIRE, x, y);
+        m_fireSpread.setSuppression(x, y, static_cast<uint8_t>(std::lround(coverage * 255)));
+      }
+    }
+  }
+
+  if (m_tickCount % TICKS_PER_SPARK == 0)
+  {
+    m_fireSpread.trySpark();
+  }
+  m_fireSpread.step();
+
+  if (!m_fireSpread.getBurntOutNodes().empty())
+  {
+    // copy the nodes, demolishing them changes the flammability of the fire spread
+    const std::vector<Point> burntOut = m_fireSpread.getBurntOutNodes();
+    m_fireSpread.clearBurntOutNodes();
+    m_map.demolishNode(burntOut, false, Layer::BUILDINGS);
+  }
+}
+
+void Simulation::renderFires()
+{
+  m_fireSpread.getBurningNodes(m_burningNodes);
+  if (m_burningNodes.empty() || !MapLayers::isLayerActive(Layer::BUILDINGS))
+  {
+    return;
+  }
+
+  const double zoomLevel = Camera::instance().zoomLevel();
+  const SDL_Point &tileSize = Camera::instance().tileSize();
+  const int width = std::max(1, static_cast<int>(tileSize.x * zoomLevel / 4));
+  const int height = std::max(1, static_cast<int>(tileSize.y * zoomLevel / 2));
+
+  m_renderRects.clear();
+  for (const Point &node : m_burningNodes)
+  {
+    if (m_map.isNodeVisible(node))
+    {
+      const SDL_Point screen = convertIsoToScreenCoordinates(m_map.getMapNode(node)->getCoordinates());
+      m_renderRects.push_back({screen.x - width / 2, screen.y - height * 3 / 2, width, height});
+    }
+  }
+
+  SDL_Renderer *renderer = WindowManager::instance().getRenderer();
+  SDL_SetRenderDrawColor(renderer, 255, 120, 20, SDL_ALPHA_OPAQUE);
+  SDL_RenderFillRects(renderer, m_renderRects.data(), static_cast<int>(m_renderRects.size()));
+}
+
+void Simulation::nextDataMap()
+{
+  m_dataMapOverlay.nextDataMap();
+  m_dataMapVersion = std::numeric_limits<size_t>::max();
+  updateDataMap();
+}
+
+void Simulation::nextColorRamp()
+{
+  m_dataMapOverlay.setColorRamp(
+      static_cast<DataMapOverlay::ColorRamp>((m_dataMapOverlay.getColorRamp() + 1) % DataMapOverlay::COLOR_RAMPS_COUNT));
+}
+
+size_t Simulation::getDataMapVersion() const
+{
+  switch (m_dataMapOverlay.getDataMap())
+  {
+  case DataMapOverlay::NONE:
+    return 0;
+  case DataMapOverlay::POLICE_COVERAGE:
+  case DataMapOverlay::FIRE_COVERAGE:
+  case DataMapOverlay::EDUCATION_COVERAGE:
+  case DataMapOverlay::HEALTH_COVERAGE:
+    return m_serviceCoverage.getRecomputeCount();
+  case DataMapOverlay::POWER:
+    return m_powerGrid.getVersion();
+  case DataMapOverlay::WATER:
+    return m_waterNetwork.getVersion();
+  case DataMapOverlay::LAND_VALUE:
+    return m_landValue.getComputedChunkCount();
+  default:
+    return m_influenceFields.getBlurredTileCount();
+  }
+}
+
+void Simulation::updateDataMap()
+{
+  const size_t version = getDataMapVersion();
+  if (version == m_dataMapVersion)
+  {
+    return;
+  }
+  m_dataMapVersion = version;
+
+  InfluenceFields::Field field = InfluenceFields::FIELDS_COUNT;
+  ServiceCoverage::Service service = ServiceCoverage::SERVICES_COUNT;
+  bool invert = false;
+
+  switch (m_dataMapOverlay.getDataMap())
+  {
+  case DataMapOverlay::NONE:
+    return;
+  case DataMapOverlay::POLICE_COVERAGE:
+    service = ServiceCoverage::POLICE;
+    break;
+  case DataMapOverlay::FIRE_COVERAGE:
+    service = ServiceCoverage::FIRE;
+    break;
+  case DataMapOverlay::EDUCATION_COVERAGE:
+    service = ServiceCoverage::EDUCATION;
+    break;
+  case DataMapOverlay::HEALTH_COVERAGE:
+    service = ServiceCoverage::HEALTH;
+    break;
+  case DataMapOverlay::POWER:
+  case DataMapOverlay::WATER:
+  case DataMapOverlay::LAND_VALUE:
+    break;
+  case DataMapOverlay::POLLUTION:
+    field = InfluenceFields::POLLUTION;
+    break;
+  case DataMapOverlay::CRIME:
+    field = InfluenceFields::CRIME;
+    break;
+  case DataMapOverlay::FIRE_HAZARD:
+    field = InfluenceFields::FIRE_HAZARD;
+    break;
+  case DataMapOverlay::HAPPINESS:
+    field = InfluenceFields::HAPPINESS;
+    invert = true;
+    break;
+  case DataMapOverlay::EDUCATION:
+  default:
+    field = InfluenceFields::EDUCATION;
+    invert = true;
+    break;
+  }
+
+  m_dataMapValues.assign(static_cast<size_t>(m_map.getColumns()) * m_map.getRows(), DataMapOverlay::NO_DATA);
+  const bool power = m_dataMapOverlay.getDataMap() == DataMapOverlay::POWER;
+  const bool landValue = m_dataMapOverlay.getDataMap() == DataMapOverlay::LAND_VALUE;
+  size_t node = 0;
+
+  for (int x = 0; x < m_map.getRows(); x++)
+  {
+    for (int y = 0; y < m_map.getColumns(); y++, node++)
+    {
+      if (service != ServiceCoverage::SERVICES_COUNT)
+      {
+        if (m_serviceCoverage.getDistance(service, x, y) != ServiceCoverage::UNCOVERED)
+        {
+          m_dataMapValues[node] = 1.f - m_serviceCoverage.getCoverage(service, x, y);
+        }
+      }
+      else if (field != InfluenceFields::FIELDS_COUNT)
+      {
+        const float value = m_influenceFields.getValue(field, x, y) / DATA_MAP_FIELD_RANGE;
+        if (value != 0.f)
+        {
+          m_dataMapValues[node] = std::max(0.f, std::min(1.f, invert ? 1.f - value : value));
+        }
+      }
+      else if (landValue)
+      {
+        m_dataMapValues[node] = 1.f - m_landValue.getValue(x, y) / 255.f;
+      }
+      else if (power && m_powerGrid.hasConductor(x, y))
+      {
+        m_dataMapValues[node] = m_powerGrid.isPowered(x, y) ? 0.f : 1.f;
+      }
+      else if (!power && !landValue && m_waterNetwork.hasBuilding(x, y))
+      {
+        m_dataMapValues[node] = 1.f - m_waterNetwork.getServedFraction(x, y);
+      }
+    }
+  }
+
+  m_dataMapOverlay.setValues(m_dataMapValues);
+}
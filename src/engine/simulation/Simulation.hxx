@@ -0,0 +1,229 @@
+#ifndef SIMULATION_HXX_
+#define SIMULATION_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <SDL.h>
+
+#include "Budget.hxx"
+#include "BuildingStore.hxx"
+#include "CityStats.hxx"
+#include "CommandLog.hxx"
+#include "Demand.hxx"
+#include "History.hxx"
+#include "JobMarket.hxx"
+#include "LandValue.hxx"
+#include "Lifecycle.hxx"
+#include "ZoneGrowth.hxx"
+#include "PowerGrid.hxx"
+#include "Population.hxx"
+#include "RandomStreams.hxx"
+#include "StateHash.hxx"
+#include "WaterNetwork.hxx"
+#include "RoadNetwork.hxx"
+#include "Traffic.hxx"
+#include "TransitLines.hxx"
+#include "InfluenceFields.hxx"
+#include "ServiceCoverage.hxx"
+#include "SpatialIndex.hxx"
+#include "FireSpread.hxx"
+#include "DataMapOverlay.hxx"
+
+class Map;
+struct MapNodeChange;
+
+/** @brief Owns all simulation systems of a map.
+  * Listens to the changes of the map and forwards them to the simulation systems, so they can update incrementally.
+  * Must be destroyed before the map it has been created for.
+  */
+class Simulation
+{
+public:
+  /** @brief Create the simulation for a map.
+    * @param seed seed of all random numbers drawn by the simulation.
+    */
+  explicit Simulation(Map &map, uint64_t seed = 0);
+  ~Simulation();
+
+  Simulation(Simulation const &) = delete;
+  Simulation &operator=(Simulation const &) = delete;
+
+  /** @brief Feed the complete map to all simulation systems.
+    * Needs to be called once after a map has been created or loaded.
+    */
+  void rebuild();
+
+  /** @brief Seed all random number streams of the simulation and start a new command log.
+    */
+  void setSeed(uint64_t seed);
+
+  /** @brief Append the state of the simulation that can't be derived from the map, like the history.
+    */
+  void save(std::vector<uint8_t> &buffer) const;
+
+  /** @brief Restore the state written by save().
+    * Malformed data is logged and ignored, the simulation keeps its fresh state in that case.
+    */
+  void load(const std::vector<uint8_t> &buffer);
+
+  /** @brief Apply an edit of the player to the map and pay for the placed and demolished tiles.
+    * Commands that add or remove transit lines change the lines instead of the map.
+    * @see Map#applyCommand
+    */
+  void applyCommand(const MapCommand &command);
+
+  /** @brief Advance the simulation by one game clock tick.
+    * The result only depends on the map, the seed and the number of ticks, so runs that execute the same commands after
+    * the same ticks end up with the same state hash.
+    */
+  void tick();
+
+  /** @brief Advance the systems that run in real time, like traffic.
+    * @param seconds elapsed real time since the last call.
+    */
+  void advance(float seconds);
+
+  /** @brief Render the data map overlay and the moving objects of the simulation on top of the map.
+    */
+  void render();
+
+  /** @brief Show the next data map in the overlay.
+    */
+  void nextDataMap();
+
+  /** @brief Use the next color ramp for the data map overlay.
+    */
+  void nextColorRamp();
+
+  unsigned int getTickCount() const { return m_tickCount; };
+  CommandLog &getCommandLog() { return m_commandLog; };
+  const StateHash &getStateHash() const { return m_stateHash; };
+  const CityStats &getCityStats() const { return m_cityStats; };
+  Budget &getBudget() { return m_budget; };
+  const BuildingStore &getBuildings() const { return m_buildings; };
+  const History &getHistory() const { return m_history; };
+  ZoneGrowth &getZoneGrowth() { return m_zoneGrowth; };
+  const PowerGrid &getPowerGrid() const { return m_powerGrid; };
+  const WaterNetwork &getWaterNetwork() const { return m_waterNetwork; };
+  RoadNetwork &getRoadNetwork() { return m_roadNetwork; };
+  Traffic &getTraffic() { return m_traffic; };
+  const TransitLines &getTransitLines() const { return m_transitLines; };
+  const InfluenceFields &getInfluenceFields() const { return m_influenceFields; };
+  const ServiceCoverage &getServiceCoverage() const { return m_serviceCoverage; };
+  LandValue &getLandValue() { return m_landValue; };
+  const SpatialIndex &getSpatialIndex() const { return m_spatialIndex; };
+  const JobMarket &getJobMarket() const { return m_jobMarket; };
+  const Demand &getDemand() const { return m_demand; };
+  const Population &getPopulation() const { return m_population; };
+  FireSpread &getFireSpread() { return m_fireSpread; };
+  const DataMapOverlay &getDataMapOverlay() const { return m_dataMapOverlay; };
+
+private:
+  Map &m_map;
+  size_t m_nodeChangedConnection;
+  unsigned int m_tickCount = 0;
+  RandomStreams m_randomStreams;
+  CommandLog m_commandLog;
+  /// hash of the map nodes, updated after every tick
+  StateHash m_stateHash;
+  CityStats m_cityStats;
+  Budget m_budget;
+  BuildingStore m_buildings;
+  History m_history;
+  ZoneGrowth m_zoneGrowth;
+  Lifecycle m_lifecycle;
+  PowerGrid m_powerGrid;
+  WaterNetwork m_waterNetwork;
+  RoadNetwork m_roadNetwork;
+  Traffic m_traffic;
+  TransitLines m_transitLines;
+  InfluenceFields m_influenceFields;
+  ServiceCoverage m_serviceCoverage;
+  LandValue m_landValue;
+  FireSpread m_fireSpread;
+  SpatialIndex m_spatialIndex;
+  JobMarket m_jobMarket;
+  Demand m_demand;
+  Population m_population;
+  /// recompute count of the service coverage the fire suppression has been updated for
+  size_t m_suppressionVersion = 0;
+  DataMapOverlay m_dataMapOverlay;
+  /// change counter of the data the overlay has been updated for
+  size_t m_dataMapVersion = std::numeric_limits<size_t>::max();
+  /// scratch buffer for the values of the data map overlay
+  std::vector<float> m_dataMapValues;
+  /// scratch buffers for rendering the traffic agents and fires
+  std::vector<SDL_Rect> m_renderRects;
+  std::vector<Point> m_burningNodes;
+
+  void onNodeChanged(const MapNodeChange &change);
+
+  /** @brief Get the hash of all layers and the height of a map node.
+    */
+  uint64_t getNodeHash(const Point &isoCoordinates) const;
+
+  /** @brief Add or remove the influence of a building.
+    * @param origin the origin node of the building.
+    * @param tileData the building.
+    * @param sign 1 to add the building, -1 to remove it.
+    */
+  void addInfluence(const Point &origin, const TileData &tileData, int sign);
+
+  /** @brief Get the commute length between two buildings along the roads.
+    * Falls back to the Manhattan distance if one of the buildings has no road nearby.
+    * @return the commute length or JobMarket::UNREACHABLE if the roads of both buildings aren't connected.
+    */
+  int getCommute(const Point &from, const Point &to);
+
+  /** @brief Recompute the land value where its inputs changed and pass it on to the wealth of spawning buildings.
+    */
+  void updateLandValue();
+
+  /** @brief Pass the employment to the demand, smooth it once per day and hand the spawn weights to the zone growth.
+    * @param newDay whether a new day started, otherwise only the counters are updated.
+    */
+  void updateDemand(bool newDay);
+
+  /** @brief Pass the school coverage and the residential demand to the population and advance it by one month.
+    */
+  void updatePopulation();
+
+  /** @brief Update the land value and utility supply of all buildings, and their age once per day.
+    */
+  void updateBuildings();
+
+  /** @brief Advance the fires, update their suppression by fire stations and demolish burnt out buildings.
+    */
+  void updateFires();
+
+  /** @brief Render the burning nodes.
+    */
+  void renderFires();
+
+  /** @brief Count the riders of the transit lines and take the cars of the commuters that switched off the roads.
+    */
+  void updateTransit();
+
+  /** @brief Render the traffic agents and the transit vehicles.
+    */
+  void renderVehicles();
+
+  /** @brief Get the screen rectangle of a vehicle at fractional node coordinates.
+    * @return false if the vehicle is not visible.
+    */
+  bool getVehicleRect(float x, float y, int size, SDL_Rect &rect) const;
+
+  /** @brief Get a counter that changes whenever the data shown by the selected data map may have changed.
+    */
+  size_t getDataMapVersion() const;
+
+  /** @brief Collect the values of the selected data map and pass them to the overlay, if its data changed.
+    * All values are oriented so that 0 is good and 1 is bad.
+    */
+  void updateDataMap();
+};
+
+#endif
@@ -0,0 +1,237 @@
+#include "SpatialIndex.hxx"
+
+#include "ServiceCoverage.hxx"
+#include "tileData.hxx"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdlib>
+
+namespace
+{
+/// Bits of the first and the last column of all rows of a chunk
+constexpr uint64_t FIRST_COLUMN = 0x0101010101010101ULL;
+constexpr uint64_t LAST_COLUMN = 0x8080808080808080ULL;
+
+/// Mask of the rows first to last and the columns first to last of a chunk, all inclusive
+uint64_t chunkMask(int firstRow, int lastRow, int firstColumn, int lastColumn)
+{
+  const uint64_t columns = ((1ULL << (lastColumn - firstColumn + 1)) - 1) << firstColumn;
+  const int rowBits = (lastRow - firstRow + 1) * ChunkBitmap::ChunkSize;
+  const uint64_t rows = (rowBits == 64 ? ~0ULL : (1ULL << rowBits) - 1) << (firstRow * ChunkBitmap::ChunkSize);
+  return columns * FIRST_COLUMN & rows;
+}
+} // namespace
+
+ChunkBitmap::ChunkBitmap(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_chunkColumns((columns + ChunkSize - 1) / ChunkSize),
+      m_chunkRows((rows + ChunkSize - 1) / ChunkSize), m_chunks(m_chunkColumns * m_chunkRows, 0)
+{
+}
+
+void ChunkBitmap::set(int x, int y, bool value)
+{
+  const uint64_t bit = 1ULL << bitIdx(x, y);
+  uint64_t &chunk = m_chunks[chunkIdx(x, y)];
+  chunk = value ? (chunk | bit) : (chunk & ~bit);
+}
+
+int ChunkBitmap::count(int x0, int y0, int x1, int y1) const
+{
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, m_rows - 1);
+  y1 = std::min(y1, m_columns - 1);
+  int count = 0;
+
+  for (int chunkX = x0 / ChunkSize; chunkX <= x1 / ChunkSize && x0 <= x1; ++chunkX)
+  {
+    const int firstRow = std::max(x0 - chunkX * ChunkSize, 0);
+    const int lastRow = std::min(x1 - chunkX * ChunkSize, ChunkSize - 1);
+
+    for (int chunkY = y0 / ChunkSize; chunkY <= y1 / ChunkSize && y0 <= y1; ++chunkY)
+    {
+      const int firstColumn = std::max(y0 - chunkY * ChunkSize, 0);
+      const int lastColumn = std::min(y1 - chunkY * ChunkSize, ChunkSize - 1);
+      const uint64_t bits = m_chunks[chunkX * m_chunkColumns + chunkY] & chunkMask(firstRow, lastRow, firstColumn, lastColumn);
+      count += static_cast<int>(std::bitset<64>(bits).count());
+    }
+  }
+
+  return count;
+}
+
+void ChunkBitmap::dilate(int steps)
+{
+  std::vector<uint64_t> scratch(m_chunks.size());
+  for (int step = 0; step < steps; ++step)
+  {
+    dilateOnce(scratch);
+  }
+}
+
+void ChunkBitmap::dilateOnce(std::vector<uint64_t> &scratch)
+{
+  for (int chunkX = 0; chunkX < m_chunkRows; ++chunkX)
+  {
+    for (int chunkY = 0; chunkY < m_chunkColumns; ++chunkY)
+    {
+      const int chunk = chunkX * m_chunkColumns + chunkY;
+      const uint64_t bits = m_chunks[chunk];
+      uint64_t result = bits | ((bits << 1) & ~FIRST_COLUMN) | ((bits >> 1) & ~LAST_COLUMN) | (bits << 8) | (bits >> 8);
+
+      // carry the border rows and columns over from the neighboring chunks
+      if (chunkY > 0)
+      {
+        result |= (m_chunks[chunk - 1] & LAST_COLUMN) >> 7;
+      }
+      if (chunkY < m_chunkColumns - 1)
+      {
+        result |= (m_chunks[chunk + 1] & FIRST_COLUMN) << 7;
+      }
+      if (chunkX > 0)
+      {
+        result |= m_chunks[chunk - m_chunkColumns] >> 56;
+      }
+      if (chunkX < m_chunkRows - 1)
+      {
+        result |= m_chunks[chunk + m_chunkColumns] << 56;
+      }
+
+      // don't grow beyond the border of the map in partial chunks
+      const int lastRow = std::min(m_rows - chunkX * ChunkSize, ChunkSize) - 1;
+      const int lastColumn = std::min(m_columns - chunkY * ChunkSize, ChunkSize) - 1;
+      scratch[chunk] = result & chunkMask(0, lastRow, 0, lastColumn);
+    }
+  }
+
+  m_chunks.swap(scratch);
+}
+
+bool ChunkBitmap::findNearest(int x, int y, int maxDistance, Point &nearest) const
+{
+  const int queryChunkX = x / ChunkSize;
+  const int queryChunkY = y / ChunkSize;
+  const int maxRing = std::max(m_chunkRows, m_chunkColumns);
+  int best = maxDistance + 1;
+
+  for (int ring = 0; ring <= maxRing; ++ring)
+  {
+    // every node of the chunks in this ring is at least this far away
+    if (ring > 0 && (ring - 1) * ChunkSize + 1 >= best)
+    {
+      break;
+    }
+
+    for (int chunkX = queryChunkX - ring; chunkX <= queryChunkX + ring; ++chunkX)
+    {
+      if (chunkX < 0 || chunkX >= m_chunkRows)
+      {
+        continue;
+      }
+
+      // inner rows of the ring only have a chunk on the left and on the right
+      const bool fullRow = std::abs(chunkX - queryChunkX) == ring;
+      const int stepY = (fullRow || ring == 0) ? 1 : 2 * ring;
+
+      for (int chunkY = queryChunkY - ring; chunkY <= queryChunkY + ring; chunkY += stepY)
+      {
+        if (chunkY < 0 || chunkY >= m_chunkColumns)
+        {
+          continue;
+        }
+
+        uint64_t bits = m_chunks[chunkX * m_chunkColumns + chunkY];
+        for (int bit = 0; bits != 0; ++bit, bits >>= 1)
+        {
+          if (!(bits & 1))
+          {
+            continue;
+          }
+
+          const int nodeX = chunkX * ChunkSize + bit / ChunkSize;
+          const int nodeY = chunkY * ChunkSize + bit % ChunkSize;
+          const int distance = std::abs(nodeX - x) + std::abs(nodeY - y);
+          if (distance < best)
+          {
+            best = distance;
+            nearest = Point{nodeX, nodeY, 0, 0};
+          }
+        }
+      }
+    }
+  }
+
+  return best <= maxDistance;
+}
+
+SpatialIndex::SpatialIndex(int columns, int rows)
+{
+  m_bitmaps.fill(ChunkBitmap(columns, rows));
+  m_versions.fill(0);
+}
+
+void SpatialIndex::set(int x, int y, QueryClass queryClass, bool value)
+{
+  if (m_bitmaps[queryClass].get(x, y) != value)
+  {
+    m_bitmaps[queryClass].set(x, y, value);
+    ++m_versions[queryClass];
+  }
+}
+
+void SpatialIndex::setTile(int x, int y, Layer layer, const TileData *tileData)
+{
+  switch (layer)
+  {
+  case Layer::ROAD:
+    set(x, y, ROAD, tileData != nullptr);
+    break;
+  case Layer::WATER:
+    set(x, y, WATER, tileData != nullptr);
+    break;
+  case Layer::ZONE:
+  {
+    size_t zoneIndex = Zones::_size();
+    if (tileData)
+    {
+      auto zone = Zones::_from_string_nocase_nothrow(tileData->subCategory.c_str());
+      zoneIndex = zone ? zone->_to_index() : zoneIndex;
+    }
+    for (size_t index = 0; index < Zones::_size(); ++index)
+    {
+      set(x, y, static_cast<QueryClass>(RESIDENTIAL_ZONE + index), index == zoneIndex);
+    }
+    break;
+  }
+  case Layer::BUILDINGS:
+  {
+    const bool building = tileData && (tileData->tileType == +TileType::DEFAULT || tileData->tileType == +TileType::RCI);
+    set(x, y, BUILDING, building);
+    for (size_t index = 0; index < Zones::_size(); ++index)
+    {
+      const bool zoned = building && tileData->tileType == +TileType::RCI && !tileData->zones.empty() &&
+                         tileData->zones.front()._to_index() == index;
+      set(x, y, static_cast<QueryClass>(RESIDENTIAL_BUILDING + index), zoned);
+    }
+    set(x, y, SERVICE_BUILDING, building && ServiceCoverage::getService(*tileData) != ServiceCoverage::SERVICES_COUNT);
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+bool SpatialIndex::isWithinDistance(QueryClass queryClass, int x, int y, int distance) const
+{
+  auto it = m_dilations.find({queryClass, distance});
+
+  if (it == m_dilations.end() || it->second.version != m_versions[queryClass])
+  {
+    Dilation dilation{m_versions[queryClass], m_bitmaps[queryClass]};
+    dilation.bitmap.dilate(distance);
+    it = m_dilations.insert_or_assign({queryClass, distance}, std::move(dilation)).first;
+  }
+
+  return it->second.bitmap.get(x, y);
+}
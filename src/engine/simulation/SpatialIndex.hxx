@@ -0,0 +1,123 @@
+#ifndef SPATIALINDEX_HXX_
+#define SPATIALINDEX_HXX_
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "basics/point.hxx"
+#include "common/enums.hxx"
+
+struct TileData;
+
+/** @brief One bit per node, stored in chunks of 8x8 nodes.
+  * Each chunk is a 64 bit word, with one byte per row (x) and one bit per column (y), so rectangles can be counted with
+  * masks and popcounts.
+  */
+class ChunkBitmap
+{
+public:
+  static constexpr int ChunkSize = 8;
+
+  ChunkBitmap(int columns = 0, int rows = 0);
+
+  bool get(int x, int y) const { return (m_chunks[chunkIdx(x, y)] >> bitIdx(x, y)) & 1; };
+  void set(int x, int y, bool value);
+
+  /** @brief Count the set nodes in the rectangle from (x0, y0) to (x1, y1), both inclusive.
+    * The rectangle is clamped to the map.
+    */
+  int count(int x0, int y0, int x1, int y1) const;
+
+  /** @brief Grow the set nodes by one node into each direction, for every step.
+    * Afterwards, a node is set if a node in Manhattan distance of at most steps was set before.
+    */
+  void dilate(int steps);
+
+  /** @brief Find the set node with the smallest Manhattan distance.
+    * The chunks are visited in rings of increasing distance, until no closer node can be found.
+    * @return whether a node within maxDistance has been found.
+    */
+  bool findNearest(int x, int y, int maxDistance, Point &nearest) const;
+
+private:
+  int m_columns;
+  int m_rows;
+  int m_chunkColumns;
+  int m_chunkRows;
+  std::vector<uint64_t> m_chunks;
+
+  int chunkIdx(int x, int y) const { return (x / ChunkSize) * m_chunkColumns + y / ChunkSize; };
+  static int bitIdx(int x, int y) { return (x % ChunkSize) * ChunkSize + y % ChunkSize; };
+  void dilateOnce(std::vector<uint64_t> &scratch);
+};
+
+/** @brief Answers spatial queries like "is there a road within 3 nodes" or "how many industrial buildings are in this
+  * rectangle" without walking the map nodes.
+  * Keeps one ChunkBitmap per query class, updated whenever a tile changes.
+  */
+class SpatialIndex
+{
+public:
+  enum QueryClass : unsigned int
+  {
+    ROAD,
+    WATER,
+    RESIDENTIAL_ZONE,
+    INDUSTRIAL_ZONE,
+    COMMERCIAL_ZONE,
+    AGRICULTURAL_ZONE,
+    BUILDING,
+    RESIDENTIAL_BUILDING,
+    INDUSTRIAL_BUILDING,
+    COMMERCIAL_BUILDING,
+    AGRICULTURAL_BUILDING,
+    SERVICE_BUILDING,
+    CLASSES_COUNT
+  };
+
+  SpatialIndex(int columns, int rows);
+
+  /** @brief Update the classes of a node after the tile of a layer changed.
+    * @param tileData the new tile, or nullptr if it has been demolished.
+    */
+  void setTile(int x, int y, Layer layer, const TileData *tileData);
+
+  void set(int x, int y, QueryClass queryClass, bool value);
+  bool get(int x, int y, QueryClass queryClass) const { return m_bitmaps[queryClass].get(x, y); };
+
+  /** @brief Count the nodes of a class in the rectangle from (x0, y0) to (x1, y1), both inclusive.
+    */
+  int count(QueryClass queryClass, int x0, int y0, int x1, int y1) const
+  {
+    return m_bitmaps[queryClass].count(x0, y0, x1, y1);
+  };
+
+  /** @brief Check if a node of a class is within the Manhattan distance of a node.
+    * The dilated bitmap of each class and distance is cached until the class changes, so repeated queries are O(1).
+    */
+  bool isWithinDistance(QueryClass queryClass, int x, int y, int distance) const;
+
+  /** @brief Find the nearest node of a class.
+    * @return whether a node within maxDistance has been found.
+    */
+  bool findNearest(QueryClass queryClass, int x, int y, int maxDistance, Point &nearest) const
+  {
+    return m_bitmaps[queryClass].findNearest(x, y, maxDistance, nearest);
+  };
+
+private:
+  struct Dilation
+  {
+    unsigned int version;
+    ChunkBitmap bitmap;
+  };
+
+  std::array<ChunkBitmap, CLASSES_COUNT> m_bitmaps;
+  std::array<unsigned int, CLASSES_COUNT> m_versions;
+  mutable std::map<std::pair<unsigned int, int>, Dilation> m_dilations;
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "StateHash.hxx"
+
+#include "Hash.hxx"
+
+#include <algorithm>
+
+StateHash::StateHash(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_chunkColumns((columns + ChunkSize - 1) / ChunkSize),
+      m_chunkRows((rows + ChunkSize - 1) / ChunkSize), m_leafCount(1), m_nodes(columns * rows, 0),
+      m_dirtyChunks(m_chunkColumns * m_chunkRows, true)
+{
+  while (m_leafCount < m_chunkColumns * m_chunkRows)
+  {
+    m_leafCount *= 2;
+  }
+  m_tree.assign(2 * m_leafCount, 0);
+  update();
+}
+
+void StateHash::setNode(int x, int y, uint64_t hash)
+{
+  uint64_t &node = m_nodes[x * m_columns + y];
+  if (node != hash)
+  {
+    node = hash;
+    m_dirtyChunks[(x / ChunkSize) * m_chunkColumns + y / ChunkSize] = true;
+  }
+}
+
+void StateHash::update()
+{
+  m_changedTreeNodes.clear();
+  for (int chunk = 0; chunk < m_chunkColumns * m_chunkRows; ++chunk)
+  {
+    if (m_dirtyChunks[chunk])
+    {
+      hashChunk(chunk);
+      m_dirtyChunks[chunk] = false;
+      m_changedTreeNodes.push_back(m_leafCount + chunk);
+    }
+  }
+
+  // rehash the parents level by level, the changed nodes stay sorted so duplicates are adjacent
+  while (!m_changedTreeNodes.empty() && m_changedTreeNodes.front() > 1)
+  {
+    for (int &treeNode : m_changedTreeNodes)
+    {
+      treeNode /= 2;
+      m_tree[treeNode] = xxHash64(&m_tree[2 * treeNode], 2 * sizeof(uint64_t));
+    }
+    m_changedTreeNodes.erase(std::unique(m_changedTreeNodes.begin(), m_changedTreeNodes.end()), m_changedTreeNodes.end());
+  }
+}
+
+int StateHash::findDifference(const StateHash &other) const
+{
+  if (other.m_tree.size() != m_tree.size())
+  {
+    return 0;
+  }
+
+  int treeNode = 1;
+  if (m_tree[treeNode] == other.m_tree[treeNode])
+  {
+    return NO_CHUNK;
+  }
+  while (treeNode < m_leafCount)
+  {
+    treeNode *= 2;
+    if (m_tree[treeNode] == other.m_tree[treeNode])
+    {
+      treeNode++;
+    }
+  }
+  return treeNode - m_leafCount;
+}
+
+void StateHash::hashChunk(int chunk)
+{
+  const int minX = (chunk / m_chunkColumns) * ChunkSize;
+  const int minY = (chunk % m_chunkColumns) * ChunkSize;
+  const int maxX = std::min(m_rows, minX + ChunkSize);
+  const int width = std::min(m_columns, minY + ChunkSize) - minY;
+
+  // chain the rows of the chunk, the chunk index as seed keeps identical chunks at different places apart
+  uint64_t hash = static_cast<uint64_t>(chunk);
+  for (int x = minX; x < maxX; ++x)
+  {
+    hash = xxHash64(&m_nodes[x * m_columns + minY], width * sizeof(uint64_t), hash);
+  }
+  m_tree[m_leafCount + chunk] = hash;
+  m_hashedChunkCount++;
+}
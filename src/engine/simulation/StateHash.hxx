@@ -0,0 +1,59 @@
+#ifndef STATEHASH_HXX_
+#define STATEHASH_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/** @brief Incremental hash of a per-node state, for checking that two runs of the simulation are identical.
+  * Every node has a 64 bit hash of its own state. The nodes are split into chunks, the hash of a chunk is the xxHash of
+  * its node hashes and the chunk hashes are the leaves of a binary Merkle tree. Changing a node only rehashes its chunk
+  * and the path to the root, and two states can be compared chunk by chunk by descending into the differing subtrees.
+  */
+class StateHash
+{
+public:
+  static constexpr int ChunkSize = 16;
+  static constexpr int NO_CHUNK = -1;
+
+  StateHash(int columns, int rows);
+
+  /** @brief Set the hash of a node's state, takes effect with the next update().
+    */
+  void setNode(int x, int y, uint64_t hash);
+
+  /** @brief Rehash all changed chunks and their paths to the root.
+    */
+  void update();
+
+  /** @brief Get the hash of the whole state as of the last update().
+    */
+  uint64_t getHash() const { return m_tree[1]; };
+
+  /** @brief Find the first chunk whose hash differs from the one of another state of the same size.
+    * @return the chunk as chunkX * chunk columns + chunkY, or NO_CHUNK if the states are identical.
+    */
+  int findDifference(const StateHash &other) const;
+
+  /** @brief Get the number of chunks hashed since the construction, for profiling.
+    */
+  size_t getHashedChunkCount() const { return m_hashedChunkCount; };
+
+private:
+  int m_columns;
+  int m_rows;
+  int m_chunkColumns;
+  int m_chunkRows;
+  /// number of leaves of the tree, the chunk count rounded up to a power of two
+  int m_leafCount;
+  std::vector<uint64_t> m_nodes;
+  /// the root is at index 1, the children of i are 2 * i and 2 * i + 1, chunk c is the leaf m_leafCount + c
+  std::vector<uint64_t> m_tree;
+  std::vector<bool> m_dirtyChunks;
+  std::vector<int> m_changedTreeNodes;
+  size_t m_hashedChunkCount = 0;
+
+  void hashChunk(int chunk);
+};
+
+#endif
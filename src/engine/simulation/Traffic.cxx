@@ -0,0 +1,371 @@
+#include "Traffic.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "RoadNetwork.hxx"
+
+namespace
+{
+/// Agents per thread below which it isn't worth to start another thread
+constexpr size_t MIN_AGENTS_PER_THREAD = 16384;
+/// Maximum number of steps per advance() call, so a long frame doesn't stall the game
+constexpr int MAX_STEPS_PER_ADVANCE = 8;
+} // namespace
+
+Traffic::Traffic(const RoadNetwork &roads, uint32_t seed)
+    : m_roads(roads), m_graphVersion(std::numeric_limits<unsigned int>::max()), m_random(seed), m_arrivals(1)
+{
+}
+
+Traffic::~Traffic() { stopWorkers(); }
+
+void Traffic::setThreadCount(unsigned int threads)
+{
+  m_threadCount = threads > 0 ? threads : 1;
+  stopWorkers();
+
+  m_stopWorkers = false;
+  m_arrivals.resize(m_threadCount);
+  for (size_t block = 1; block < m_threadCount; ++block)
+  {
+    m_workers.emplace_back(&Traffic::runWorker, this, block);
+  }
+}
+
+void Traffic::stopWorkers()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_workerMutex);
+    m_stopWorkers = true;
+  }
+  m_workAvailable.notify_all();
+  for (auto &worker : m_workers)
+  {
+    worker.join();
+  }
+  m_workers.clear();
+}
+
+void Traffic::runWorker(size_t block)
+{
+  unsigned int generation = 0;
+  std::unique_lock<std::mutex> lock(m_workerMutex);
+
+  while (true)
+  {
+    m_workAvailable.wait(lock, [this, &generation] { return m_stopWorkers || m_workGeneration != generation; });
+    if (m_stopWorkers)
+    {
+      return;
+    }
+    generation = m_workGeneration;
+
+    // small steps use less blocks than there are workers
+    if (block < m_blockCount)
+    {
+      const size_t agentCount = m_edge.size();
+      const size_t begin = std::min(agentCount, block * m_blockSize);
+      const size_t end = std::min(agentCount, begin + m_blockSize);
+      lock.unlock();
+      advanceBlock(begin, end, m_arrivals[block]);
+      lock.lock();
+
+      if (--m_pendingBlocks == 0)
+      {
+        m_workDone.notify_one();
+      }
+    }
+  }
+}
+
+void Traffic::clear()
+{
+  m_edge.clear();
+  m_forward.clear();
+  m_progress.clear();
+  m_speed.clear();
+  m_destination.clear();
+  std::fill(m_occupancy.begin(), m_occupancy.end(), 0);
+}
+
+int Traffic::randomVertex()
+{
+  if (m_aliveVertices.empty())
+  {
+    return -1;
+  }
+  return m_aliveVertices[std::uniform_int_distribution<size_t>{0, m_aliveVertices.size() - 1}(m_random)];
+}
+
+void Traffic::spawn(size_t count)
+{
+  syncWithRoads();
+
+  if (m_aliveEdges.empty())
+  {
+    return;
+  }
+
+  std::uniform_int_distribution<size_t> randomEdge{0, m_aliveEdges.size() - 1};
+  std::uniform_real_distribution<float> randomUnit{0.f, 1.f};
+
+  for (size_t i = 0; i < count; ++i)
+  {
+    const int edge = m_aliveEdges[randomEdge(m_random)];
+    m_edge.push_back(edge);
+    m_forward.push_back(randomUnit(m_random) < 0.5f ? 1 : 0);
+    m_progress.push_back(randomUnit(m_random) * m_edgeLength[edge]);
+    m_speed.push_back(2.f + 2.f * randomUnit(m_random));
+    m_destination.push_back(randomVertex());
+    m_occupancy[edge]++;
+  }
+}
+
+void Traffic::despawn(size_t agent)
+{
+  const size_t last = m_edge.size() - 1;
+  m_edge[agent] = m_edge[last];
+  m_forward[agent] = m_forward[last];
+  m_progress[agent] = m_progress[last];
+  m_speed[agent] = m_speed[last];
+  m_destination[agent] = m_destination[last];
+
+  m_edge.pop_back();
+  m_forward.pop_back();
+  m_progress.pop_back();
+  m_speed.pop_back();
+  m_destination.pop_back();
+}
+
+void Traffic::syncWithRoads()
+{
+  if (m_graphVersion == m_roads.getGraphVersion())
+  {
+    return;
+  }
+  m_graphVersion = m_roads.getGraphVersion();
+
+  const std::vector<RoadNetwork::Edge> &edges = m_roads.getEdges();
+  const std::vector<RoadNetwork::Vertex> &vertices = m_roads.getVertices();
+
+  m_edgeLength.assign(edges.size(), 0.f);
+  m_edgeSpeedFactor.assign(edges.size(), 1.f);
+  m_occupancy.assign(edges.size(), 0);
+  m_aliveEdges.clear();
+  m_aliveVertices.clear();
+  m_totalRoadLength = 0;
+
+  for (size_t edge = 0; edge < edges.size(); ++edge)
+  {
+    if (edges[edge].alive)
+    {
+      m_edgeLength[edge] = static_cast<float>(edges[edge].weight);
+      m_aliveEdges.push_back(static_cast<int>(edge));
+      m_totalRoadLength += edges[edge].weight;
+    }
+  }
+  for (size_t vertex = 0; vertex < vertices.size(); ++vertex)
+  {
+    if (vertices[vertex].alive)
+    {
+      m_aliveVertices.push_back(static_cast<int>(vertex));
+    }
+  }
+
+  // agents on demolished roads are removed, the others keep driving
+  for (size_t agent = m_edge.size(); agent-- > 0;)
+  {
+    const int edge = m_edge[agent];
+    if (edge >= static_cast<int>(edges.size()) || !edges[edge].alive)
+    {
+      despawn(agent);
+      continue;
+    }
+
+    m_progress[agent] = std::min(m_progress[agent], m_edgeLength[edge]);
+    m_occupancy[edge]++;
+    const int destination = m_destination[agent];
+    if (destination < 0 || destination >= static_cast<int>(vertices.size()) || !vertices[destination].alive)
+    {
+      m_destination[agent] = randomVertex();
+    }
+  }
+
+  const size_t targetCount = static_cast<size_t>(m_density * static_cast<float>(m_totalRoadLength));
+  if (m_edge.size() < targetCount)
+  {
+    spawn(targetCount - m_edge.size());
+  }
+  while (m_edge.size() > targetCount)
+  {
+    m_occupancy[m_edge.back()]--;
+    despawn(m_edge.size() - 1);
+  }
+}
+
+void Traffic::advance(float seconds)
+{
+  // the agents must leave demolished roads before they are rendered, even if no step is due
+  syncWithRoads();
+  m_timeAccumulator = std::min(m_timeAccumulator + seconds, MAX_STEPS_PER_ADVANCE * TimeStep);
+
+  while (m_timeAccumulator >= TimeStep)
+  {
+    step();
+    m_timeAccumulator -= TimeStep;
+  }
+}
+
+void Traffic::step()
+{
+  syncWithRoads();
+
+  // crowded edges slow down all agents on them
+  for (int edge : m_aliveEdges)
+  {
+    const float load = static_cast<float>(m_occupancy[edge]) / (m_edgeLength[edge] * CapacityPerNode);
+    m_edgeSpeedFactor[edge] = load <= 1.f ? 1.f : std::max(0.1f, 1.f / load);
+  }
+
+  const size_t agentCount = m_edge.size();
+  const size_t threads = std::max<size_t>(1, std::min<size_t>(m_threadCount, agentCount / MIN_AGENTS_PER_THREAD));
+
+  if (threads == 1)
+  {
+    advanceBlock(0, agentCount, m_arrivals[0]);
+  }
+  else
+  {
+    // the blocks don't share any data, the edges are only changed afterwards
+    const size_t blockSize = (agentCount + threads - 1) / threads;
+    {
+      std::lock_guard<std::mutex> lock(m_workerMutex);
+      m_blockSize = blockSize;
+      m_blockCount = threads;
+      m_pendingBlocks = threads - 1;
+      m_workGeneration++;
+    }
+    m_workAvailable.notify_all();
+
+    advanceBlock(0, blockSize, m_arrivals[0]);
+
+    std::unique_lock<std::mutex> lock(m_workerMutex);
+    m_workDone.wait(lock, [this] { return m_pendingBlocks == 0; });
+  }
+
+  // the blocks are in agent order, so the agents take their turns in the same order with any number of threads
+  for (size_t block = 0; block < threads; ++block)
+  {
+    for (size_t agent : m_arrivals[block])
+    {
+      enterNextEdge(agent);
+    }
+  }
+}
+
+void Traffic::advanceBlock(size_t begin, size_t end, std::vector<size_t> &arrivals)
+{
+  const int *edge = m_edge.data();
+  const float *speed = m_speed.data();
+  const float *speedFactor = m_edgeSpeedFactor.data();
+  const float *edgeLength = m_edgeLength.data();
+  float *progress = m_progress.data();
+
+  arrivals.clear();
+  for (size_t agent = begin; agent < end; ++agent)
+  {
+    progress[agent] += speed[agent] * speedFactor[edge[agent]] * TimeStep;
+    if (progress[agent] >= edgeLength[edge[agent]])
+    {
+      arrivals.push_back(agent);
+    }
+  }
+}
+
+void Traffic::enterNextEdge(size_t agent)
+{
+  const std::vector<RoadNetwork::Edge> &edges = m_roads.getEdges();
+  const std::vector<RoadNetwork::Vertex> &vertices = m_roads.getVertices();
+
+  const int currentEdge = m_edge[agent];
+  const RoadNetwork::Edge &edge = edges[currentEdge];
+  const int vertex = m_forward[agent] ? edge.to : edge.from;
+
+  if (m_destination[agent] == vertex || m_destination[agent] < 0)
+  {
+    m_destination[agent] = randomVertex();
+  }
+
+  // drive towards the destination, but sometimes take a random turn so agents don't get stuck in dead ends
+  const Point target = m_roads.getNodeCoordinates(vertices[std::max(m_destination[agent], 0)].node);
+  const bool randomTurn = std::uniform_int_distribution<int>{0, 7}(m_random) == 0;
+  int nextEdge = -1;
+  int bestScore = std::numeric_limits<int>::max();
+
+  for (int candidate : vertices[vertex].edges)
+  {
+    if (candidate < 0)
+    {
+      continue;
+    }
+
+    const RoadNetwork::Edge &next = edges[candidate];
+    const Point end = m_roads.getNodeCoordinates(vertices[next.from == vertex ? next.to : next.from].node);
+    int score = randomTurn ? std::uniform_int_distribution<int>{0, 1023}(m_random)
+                           : std::abs(end.x - target.x) + std::abs(end.y - target.y);
+    if (candidate == currentEdge)
+    {
+      // only turn around in dead ends
+      score = std::numeric_limits<int>::max() - 1;
+    }
+    if (score < bestScore)
+    {
+      bestScore = score;
+      nextEdge = candidate;
+    }
+  }
+
+  const float leftover = m_progress[agent] - m_edgeLength[currentEdge];
+  m_occupancy[currentEdge]--;
+  m_occupancy[nextEdge]++;
+  m_edge[agent] = nextEdge;
+  m_forward[agent] = edges[nextEdge].from == vertex ? 1 : 0;
+  m_progress[agent] = std::min(leftover, m_edgeLength[nextEdge]);
+}
+
+bool Traffic::getAgentPosition(size_t agent, float &x, float &y) const
+{
+  const std::vector<RoadNetwork::Edge> &edges = m_roads.getEdges();
+  if (m_edge[agent] >= static_cast<int>(edges.size()) || !edges[m_edge[agent]].alive)
+  {
+    return false;
+  }
+
+  const RoadNetwork::Edge &edge = edges[m_edge[agent]];
+  const std::vector<RoadNetwork::Vertex> &vertices = m_roads.getVertices();
+  const float length = m_edgeLength[m_edge[agent]];
+  const float distance = m_forward[agent] ? m_progress[agent] : length - m_progress[agent];
+
+  // the k-th node of the edge, counted from its start vertex
+  auto nodeAt = [&](int k) {
+    if (k <= 0)
+    {
+      return m_roads.getNodeCoordinates(vertices[edge.from].node);
+    }
+    if (k >= edge.weight)
+    {
+      return m_roads.getNodeCoordinates(vertices[edge.to].node);
+    }
+    return m_roads.getNodeCoordinates(edge.nodes[k - 1]);
+  };
+
+  const int k = static_cast<int>(distance);
+  const float fraction = distance - static_cast<float>(k);
+  const Point a = nodeAt(k);
+  const Point b = nodeAt(k + 1);
+  x = static_cast<float>(a.x) + fraction * static_cast<float>(b.x - a.x);
+  y = static_cast<float>(a.y) + fraction * static_cast<float>(b.y - a.y);
+  return true;
+}
@@ -0,0 +1,126 @@
+#ifndef TRAFFIC_HXX_
+#define TRAFFIC_HXX_
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+class RoadNetwork;
+
+/** @brief Cars driving along the edges of the road network.
+  * Agents are stored as structure of arrays, so the per step update is a tight loop over plain arrays that can be
+  * split into blocks and run in parallel on a pool of worker threads. Agents only make decisions when they reach a vertex of the road graph.
+  * The number of agents on each edge is tracked and slows down all agents on crowded edges.
+  */
+class Traffic
+{
+public:
+  /// Duration of one simulation step in seconds
+  static constexpr float TimeStep = 1.f / 30.f;
+  /// Number of agents one road node can hold before agents have to slow down
+  static constexpr float CapacityPerNode = 2.f;
+
+  explicit Traffic(const RoadNetwork &roads, uint32_t seed = 0);
+  ~Traffic();
+  Traffic(const Traffic &) = delete;
+  Traffic &operator=(const Traffic &) = delete;
+
+  /** @brief Seed the random placement of spawned agents.
+    */
+  void setSeed(uint32_t seed) { m_random.seed(seed); };
+
+  /** @brief Set the number of agents per road node.
+    * Agents are spawned and despawned whenever the road network changes.
+    */
+  void setDensity(float agentsPerRoadNode) { m_density = agentsPerRoadNode; };
+
+  /** @brief Spawn agents on random road edges.
+    * @param count number of agents to spawn.
+    */
+  void spawn(size_t count);
+
+  /** @brief Remove all agents.
+    */
+  void clear();
+
+  /** @brief Advance the simulation by the elapsed time in fixed time steps.
+    * @param seconds elapsed real time.
+    */
+  void advance(float seconds);
+
+  /** @brief Advance the simulation by one time step.
+    */
+  void step();
+
+  /** @brief Set the number of threads that update the agents.
+    * The worker threads are started once and wait for the steps, so a step doesn't pay for starting threads.
+    * @param threads 1 to update on the calling thread only.
+    */
+  void setThreadCount(unsigned int threads);
+
+  size_t getAgentCount() const { return m_edge.size(); };
+
+  /** @brief Get the number of agents on a road edge.
+    */
+  int getOccupancy(int edge) const { return edge < static_cast<int>(m_occupancy.size()) ? m_occupancy[edge] : 0; };
+
+  /** @brief Get the position of an agent in node coordinates.
+    * @param agent index of the agent.
+    * @param x receives the x coordinate.
+    * @param y receives the y coordinate.
+    * @return false if the road of the agent has been demolished and the agents haven't been updated since.
+    */
+  bool getAgentPosition(size_t agent, float &x, float &y) const;
+
+private:
+  const RoadNetwork &m_roads;
+  unsigned int m_graphVersion;
+  float m_density = 0.f;
+  float m_timeAccumulator = 0.f;
+  unsigned int m_threadCount = 1;
+  std::mt19937 m_random;
+
+  /// structure of arrays, one entry per agent
+  std::vector<int> m_edge;        /// edge the agent drives on
+  std::vector<uint8_t> m_forward; /// 1 if the agent drives from the start to the end of its edge
+  std::vector<float> m_progress;  /// distance driven on the edge
+  std::vector<float> m_speed;     /// speed in nodes per second
+  std::vector<int> m_destination; /// vertex the agent wants to reach
+
+  /// cached per edge data
+  std::vector<float> m_edgeLength;
+  std::vector<float> m_edgeSpeedFactor;
+  std::vector<int> m_occupancy;
+  std::vector<int> m_aliveEdges;
+  std::vector<int> m_aliveVertices;
+  int m_totalRoadLength = 0;
+
+  /// worker pool, the calling thread updates the first block of every step
+  std::vector<std::thread> m_workers;
+  std::mutex m_workerMutex;
+  std::condition_variable m_workAvailable;
+  std::condition_variable m_workDone;
+  unsigned int m_workGeneration = 0;
+  size_t m_blockSize = 0;
+  size_t m_blockCount = 0;
+  size_t m_pendingBlocks = 0;
+  bool m_stopWorkers = false;
+  /// agents of each block that reached the end of their edge in the current step
+  std::vector<std::vector<size_t>> m_arrivals;
+
+  void syncWithRoads();
+  void despawn(size_t agent);
+  int randomVertex();
+
+  /** @brief Move the agents of a block and collect the ones that reached the end of their edge.
+    */
+  void advanceBlock(size_t begin, size_t end, std::vector<size_t> &arrivals);
+  void runWorker(size_t block);
+  void stopWorkers();
+  void enterNextEdge(size_t agent);
+};
+
+#endif
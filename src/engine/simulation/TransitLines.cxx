@@ -0,0 +1,301 @@
+#include "TransitLines.hxx"
+
+#include "BuildingStore.hxx"
+#include "ByteStream.hxx"
+#include "CityStats.hxx"
+#include "RoadNetwork.hxx"
+#include "basics/tileData.hxx"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+TransitLines::TransitLines(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_stopOfNode(columns * rows, NO_STOP), m_stopDistance(columns * rows, FAR_AWAY)
+{
+}
+
+bool TransitLines::addLine(const std::vector<Point> &stops, int vehicles)
+{
+  if (stops.size() < 2 || stops.size() > MaxStops || vehicles < 1 || vehicles > MaxVehicles || m_lines.size() >= MaxLines)
+  {
+    return false;
+  }
+  for (const Point &stop : stops)
+  {
+    if (stop.x < 0 || stop.x >= m_rows || stop.y < 0 || stop.y >= m_columns)
+    {
+      return false;
+    }
+  }
+
+  Line line;
+  line.stops = stops;
+  line.vehicles = vehicles;
+  m_lines.push_back(std::move(line));
+  m_linesChanged = true;
+  return true;
+}
+
+bool TransitLines::removeLineAt(const Point &stop)
+{
+  const auto line = std::find_if(m_lines.begin(), m_lines.end(), [&stop](const Line &candidate) {
+    return std::any_of(candidate.stops.begin(), candidate.stops.end(),
+                       [&stop](const Point &other) { return other.x == stop.x && other.y == stop.y; });
+  });
+  if (line == m_lines.end())
+  {
+    return false;
+  }
+  m_lines.erase(line);
+  m_linesChanged = true;
+  return true;
+}
+
+void TransitLines::clear()
+{
+  m_lines.clear();
+  m_linesChanged = true;
+}
+
+void TransitLines::update(RoadNetwork &roads)
+{
+  if (!m_linesChanged && m_graphVersion == roads.getGraphVersion())
+  {
+    return;
+  }
+  updateTravelTimes(roads);
+  if (m_linesChanged)
+  {
+    updateCatchment();
+  }
+  m_graphVersion = roads.getGraphVersion();
+  m_linesChanged = false;
+}
+
+void TransitLines::updateTravelTimes(RoadNetwork &roads)
+{
+  // measure the legs of all lines in one batch, a line runs only if all of its stops are on connected roads
+  std::vector<std::pair<Point, Point>> legs;
+  std::vector<bool> measured(m_lines.size(), false);
+  for (size_t line = 0; line < m_lines.size(); ++line)
+  {
+    const std::vector<Point> &stops = m_lines[line].stops;
+    measured[line] = std::all_of(stops.begin(), stops.end(), [&roads](const Point &stop) { return roads.isRoad(stop.x, stop.y); });
+    if (measured[line])
+    {
+      for (size_t stop = 0; stop < stops.size(); ++stop)
+      {
+        legs.emplace_back(stops[stop], stops[(stop + 1) % stops.size()]);
+      }
+    }
+  }
+  const std::vector<int> distances = roads.getDistances(legs);
+
+  size_t leg = 0;
+  for (size_t line = 0; line < m_lines.size(); ++line)
+  {
+    std::vector<int> &arrivals = m_lines[line].arrivals;
+    arrivals.clear();
+    if (!measured[line])
+    {
+      continue;
+    }
+
+    const size_t end = leg + m_lines[line].stops.size();
+    const bool connected = std::none_of(distances.begin() + leg, distances.begin() + end,
+                                        [](int distance) { return distance == RoadNetwork::UNREACHABLE; });
+    if (connected)
+    {
+      arrivals.push_back(0);
+      for (; leg < end; ++leg)
+      {
+        arrivals.push_back(arrivals.back() + DwellTicks + distances[leg] * TicksPerNode);
+      }
+    }
+    leg = end;
+  }
+}
+
+void TransitLines::updateCatchment()
+{
+  std::fill(m_stopOfNode.begin(), m_stopOfNode.end(), NO_STOP);
+  std::fill(m_stopDistance.begin(), m_stopDistance.end(), FAR_AWAY);
+
+  // breadth first search from all stops at once, stops of earlier lines win ties
+  m_queue.clear();
+  for (size_t line = 0; line < m_lines.size(); ++line)
+  {
+    for (size_t stop = 0; stop < m_lines[line].stops.size(); ++stop)
+    {
+      const int node = nodeIdx(m_lines[line].stops[stop].x, m_lines[line].stops[stop].y);
+      if (m_stopOfNode[node] == NO_STOP)
+      {
+        m_stopOfNode[node] = packStop(line, stop);
+        m_stopDistance[node] = 0;
+        m_queue.push_back(node);
+      }
+    }
+  }
+
+  constexpr int dx[] = {1, -1, 0, 0};
+  constexpr int dy[] = {0, 0, 1, -1};
+  for (size_t head = 0; head < m_queue.size(); ++head)
+  {
+    const int node = m_queue[head];
+    if (m_stopDistance[node] == CatchmentRadius)
+    {
+      continue;
+    }
+    const int x = node / m_columns;
+    const int y = node % m_columns;
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      const int neighborX = x + dx[direction];
+      const int neighborY = y + dy[direction];
+      if (neighborX < 0 || neighborX >= m_rows || neighborY < 0 || neighborY >= m_columns)
+      {
+        continue;
+      }
+      const int neighbor = nodeIdx(neighborX, neighborY);
+      if (m_stopOfNode[neighbor] == NO_STOP)
+      {
+        m_stopOfNode[neighbor] = m_stopOfNode[node];
+        m_stopDistance[neighbor] = static_cast<uint8_t>(m_stopDistance[node] + 1);
+        m_queue.push_back(neighbor);
+      }
+    }
+  }
+}
+
+void TransitLines::updateRidership(const BuildingStore &buildings)
+{
+  for (Line &line : m_lines)
+  {
+    line.residents = 0;
+    line.jobs = 0;
+  }
+  m_residents = 0;
+
+  const std::vector<int> &origins = buildings.getOrigins();
+  const std::vector<const TileData *> &tileData = buildings.getTileData();
+  for (size_t building = 0; building < buildings.size(); ++building)
+  {
+    const bool residential = CityStats::isResidential(*tileData[building]);
+    if (residential)
+    {
+      m_residents += tileData[building]->inhabitants;
+    }
+
+    const int stop = m_stopOfNode[origins[building]];
+    if (stop == NO_STOP || !m_lines[getStopLine(stop)].isRunning())
+    {
+      continue;
+    }
+    Line &line = m_lines[getStopLine(stop)];
+    (residential ? line.residents : line.jobs) += tileData[building]->inhabitants;
+  }
+
+  // a commute by bus needs a stop near the home and one near the workplace
+  m_riders = 0;
+  for (Line &line : m_lines)
+  {
+    line.ridership = static_cast<int>(RiderShare * static_cast<float>(std::min(line.residents, line.jobs)));
+    m_riders += line.ridership;
+  }
+}
+
+int TransitLines::getTravelTime(size_t line, size_t fromStop, size_t toStop) const
+{
+  const Line &transitLine = m_lines[line];
+  if (!transitLine.isRunning())
+  {
+    return UNREACHABLE;
+  }
+  const int travelTime = transitLine.arrivals[toStop] - transitLine.arrivals[fromStop];
+  return travelTime >= 0 ? travelTime : travelTime + transitLine.getCycleTime();
+}
+
+bool TransitLines::getVehiclePosition(size_t line, int vehicle, double time, float &x, float &y) const
+{
+  const Line &transitLine = m_lines[line];
+  if (!transitLine.isRunning())
+  {
+    return false;
+  }
+
+  // the vehicles are spread evenly over the cycle
+  const double cycle = transitLine.getCycleTime();
+  double phase = std::fmod(time + cycle * vehicle / transitLine.vehicles, cycle);
+  if (phase < 0)
+  {
+    phase += cycle;
+  }
+
+  const auto next = std::upper_bound(transitLine.arrivals.begin(), transitLine.arrivals.end(), phase);
+  const size_t stop = std::min(static_cast<size_t>(next - transitLine.arrivals.begin()) - 1, transitLine.stops.size() - 1);
+  const Point &from = transitLine.stops[stop];
+  const Point &to = transitLine.stops[(stop + 1) % transitLine.stops.size()];
+
+  const float driving = static_cast<float>(transitLine.arrivals[stop + 1] - transitLine.arrivals[stop] - DwellTicks);
+  const float driven = static_cast<float>(phase - (transitLine.arrivals[stop] + DwellTicks));
+  const float progress = driving > 0.f ? std::max(0.f, std::min(1.f, driven / driving)) : 0.f;
+  x = static_cast<float>(from.x) + progress * static_cast<float>(to.x - from.x);
+  y = static_cast<float>(from.y) + progress * static_cast<float>(to.y - from.y);
+  return true;
+}
+
+void TransitLines::save(ByteWriter &writer) const
+{
+  writer.writeVarint(m_lines.size());
+  for (const Line &line : m_lines)
+  {
+    writer.writeVarint(static_cast<uint64_t>(line.vehicles));
+    writer.writeVarint(line.stops.size());
+    Point previous{0, 0, 0, 0};
+    for (const Point &stop : line.stops)
+    {
+      writer.writeSignedVarint(stop.x - previous.x);
+      writer.writeSignedVarint(stop.y - previous.y);
+      previous = stop;
+    }
+  }
+}
+
+void TransitLines::load(ByteReader &reader)
+{
+  TransitLines loaded(m_columns, m_rows);
+  const uint64_t lineCount = reader.readVarint();
+  if (lineCount > MaxLines)
+  {
+    throw CytopiaError{TRACE_INFO "Too many transit lines"};
+  }
+  for (uint64_t line = 0; line < lineCount; ++line)
+  {
+    const uint64_t vehicles = reader.readVarint();
+    if (vehicles < 1 || vehicles > MaxVehicles)
+    {
+      throw CytopiaError{TRACE_INFO "Invalid number of vehicles on a transit line"};
+    }
+    const uint64_t stopCount = reader.readVarint();
+    if (stopCount > MaxStops)
+    {
+      throw CytopiaError{TRACE_INFO "Too many stops on a transit line"};
+    }
+    std::vector<Point> stops;
+    Point stop{0, 0, 0, 0};
+    for (uint64_t index = 0; index < stopCount; ++index)
+    {
+      stop.x += static_cast<int>(reader.readSignedVarint());
+      stop.y += static_cast<int>(reader.readSignedVarint());
+      stops.push_back(stop);
+    }
+    if (!loaded.addLine(stops, static_cast<int>(vehicles)))
+    {
+      throw CytopiaError{TRACE_INFO "Invalid transit line"};
+    }
+  }
+
+  m_lines = std::move(loaded.m_lines);
+  m_linesChanged = true;
+}
@@ -0,0 +1,146 @@
+#ifndef TRANSITLINES_HXX_
+#define TRANSITLINES_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "basics/point.hxx"
+
+class BuildingStore;
+class ByteReader;
+class ByteWriter;
+class RoadNetwork;
+
+/** @brief Bus lines defined by the player, as cyclic lists of stops on road nodes.
+  * Every line has a table of the arrival times at its stops, measured along the roads, so the travel time between any
+  * two stops is a difference of two entries. The vehicles run on a fixed cyclic schedule, their position is computed
+  * from the time when it is needed instead of being stepped every tick.
+  * A grid keeps the nearest stop and the walking distance to it for every node, the residents and jobs around each stop
+  * are counted from it to estimate the ridership.
+  */
+class TransitLines
+{
+public:
+  static constexpr int NO_STOP = -1;
+  static constexpr int UNREACHABLE = -1;
+  /// Ticks a vehicle needs to pass one road node
+  static constexpr int TicksPerNode = 1;
+  /// Ticks a vehicle waits at every stop
+  static constexpr int DwellTicks = 2;
+  /// Largest walking distance to a stop, in nodes
+  static constexpr int CatchmentRadius = 6;
+  /// Share of the commuters with stops at both ends of their commute that take the bus
+  static constexpr float RiderShare = 0.3f;
+  /// Largest number of vehicles on a line
+  static constexpr int MaxVehicles = 64;
+  /// Largest number of lines, so the packed stops of all lines fit into a positive int
+  static constexpr size_t MaxLines = 0x7FFF;
+
+  struct Line
+  {
+    std::vector<Point> stops;
+    int vehicles = 1;
+    /// ticks from the arrival at the first stop to the arrival at each stop, the last entry is the cycle time
+    std::vector<int> arrivals;
+    /// residents and jobs within the catchment of the stops
+    int residents = 0;
+    int jobs = 0;
+    int ridership = 0;
+
+    /** @brief Check if all stops are connected by the roads, otherwise the line doesn't run.
+      */
+    bool isRunning() const { return !arrivals.empty(); };
+    int getCycleTime() const { return arrivals.empty() ? 0 : arrivals.back(); };
+  };
+
+  TransitLines(int columns, int rows);
+
+  /** @brief Add a line that runs through the stops in their order and back to the first one.
+    * @param stops at least two road nodes.
+    * @param vehicles number of vehicles from 1 to MaxVehicles, they are spread evenly over the cycle.
+    * @return false if the line has less than two stops, the number of vehicles is out of range or there are already
+    * MaxLines lines.
+    */
+  bool addLine(const std::vector<Point> &stops, int vehicles);
+
+  /** @brief Remove the line with a stop at the node.
+    * @return false if no line stops there.
+    */
+  bool removeLineAt(const Point &stop);
+
+  void clear();
+
+  /** @brief Rebuild the travel times of the lines after the lines or the roads changed, and the catchment grid after
+    * the stops changed.
+    */
+  void update(RoadNetwork &roads);
+
+  /** @brief Count the residents and jobs in the catchment of every line and estimate its ridership.
+    */
+  void updateRidership(const BuildingStore &buildings);
+
+  const std::vector<Line> &getLines() const { return m_lines; };
+
+  /** @brief Get the travel time between two stops of a line, including the stops in between.
+    * @return the ticks or UNREACHABLE if the line doesn't run.
+    */
+  int getTravelTime(size_t line, size_t fromStop, size_t toStop) const;
+
+  /** @brief Get the position of a vehicle at the given time.
+    * The vehicles move on a straight line between the stops, only their timing follows the roads.
+    * @param time the time in ticks, fractions move the vehicles smoothly.
+    * @return false if the line doesn't run.
+    */
+  bool getVehiclePosition(size_t line, int vehicle, double time, float &x, float &y) const;
+
+  /** @brief Get the nearest stop of any line within walking distance of a node.
+    * @return the line and stop index packed by packStop(), or NO_STOP.
+    */
+  int getNearestStop(int x, int y) const { return m_stopOfNode[nodeIdx(x, y)]; };
+
+  /** @brief Get the walking distance to the nearest stop, or a value larger than CatchmentRadius if there is none.
+    */
+  int getStopDistance(int x, int y) const { return m_stopDistance[nodeIdx(x, y)]; };
+
+  static int packStop(size_t line, size_t stop) { return static_cast<int>(line << 16 | stop); };
+  static size_t getStopLine(int stop) { return static_cast<size_t>(stop) >> 16; };
+  static size_t getStopIndex(int stop) { return static_cast<size_t>(stop) & 0xFFFF; };
+
+  /** @brief Get the share of all residents that take the bus to work.
+    */
+  float getRiderShare() const { return m_residents > 0 ? static_cast<float>(m_riders) / m_residents : 0.f; };
+
+  void save(ByteWriter &writer) const;
+
+  /** @brief Replace the lines by the ones written with save().
+    * @throws CytopiaError if the data is malformed.
+    */
+  void load(ByteReader &reader);
+
+private:
+  static constexpr uint8_t FAR_AWAY = std::numeric_limits<uint8_t>::max();
+  /// Largest number of stops of a line, so stops can be packed into an int
+  static constexpr size_t MaxStops = 0xFFFF;
+
+  int m_columns;
+  int m_rows;
+  std::vector<Line> m_lines;
+  /// packed nearest stop of each node
+  std::vector<int> m_stopOfNode;
+  std::vector<uint8_t> m_stopDistance;
+  /// scratch queue of the walking distance search
+  std::vector<int> m_queue;
+  /// graph version of the roads the travel times have been measured on
+  unsigned int m_graphVersion = std::numeric_limits<unsigned int>::max();
+  bool m_linesChanged = false;
+  int m_residents = 0;
+  int m_riders = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  void updateTravelTimes(RoadNetwork &roads);
+  void updateCatchment();
+};
+
+#endif
@@ -0,0 +1,341 @@
+#include "WaterNetwork.hxx"
+
+#include <algorithm>
+#include <deque>
+#include <numeric>
+
+WaterNetwork::WaterNetwork(int columns, int rows)
+    : m_columns(columns), m_rows(rows), m_pipe(columns * rows, false), m_networkOfNode(columns * rows, NONE),
+      m_buildingOrigin(columns * rows, NONE), m_water(columns * rows, 0), m_networkOfBuilding(columns * rows, NONE),
+      m_servedFraction(columns * rows, 0.f)
+{
+}
+
+int WaterNetwork::neighbor(int node, int direction) const
+{
+  const int x = node / m_columns;
+  const int y = node % m_columns;
+
+  switch (direction)
+  {
+  case 0:
+    return x > 0 ? node - m_columns : NONE;
+  case 1:
+    return x < m_rows - 1 ? node + m_columns : NONE;
+  case 2:
+    return y > 0 ? node - 1 : NONE;
+  default:
+    return y < m_columns - 1 ? node + 1 : NONE;
+  }
+}
+
+void WaterNetwork::markDirty(int node)
+{
+  m_seeds.push_back(node);
+
+  for (int direction = -1; direction < 4; ++direction)
+  {
+    const int n = direction < 0 ? node : neighbor(node, direction);
+
+    if (n != NONE && m_networkOfNode[n] != NONE)
+    {
+      m_networks[m_networkOfNode[n]].dirty = true;
+    }
+    if (n != NONE && m_pipe[n])
+    {
+      m_seeds.push_back(n);
+    }
+  }
+}
+
+void WaterNetwork::setPipe(int x, int y, bool pipe)
+{
+  const int node = nodeIdx(x, y);
+
+  if (m_pipe[node] != pipe)
+  {
+    m_pipe[node] = pipe;
+    markDirty(node);
+  }
+}
+
+void WaterNetwork::setBuildingNode(int x, int y, int originX, int originY, int water)
+{
+  const int node = nodeIdx(x, y);
+  const int origin = nodeIdx(originX, originY);
+
+  if (m_buildingOrigin[node] != NONE && m_buildingOrigin[node] != origin)
+  {
+    clearBuildingNode(x, y);
+  }
+
+  m_buildingOrigin[node] = origin;
+  m_water[origin] = water;
+  if (m_networkOfBuilding[origin] != NONE)
+  {
+    m_networks[m_networkOfBuilding[origin]].dirty = true;
+  }
+  markDirty(node);
+}
+
+void WaterNetwork::clearBuildingNode(int x, int y)
+{
+  const int node = nodeIdx(x, y);
+  const int origin = m_buildingOrigin[node];
+
+  if (origin == NONE)
+  {
+    return;
+  }
+
+  if (m_networkOfBuilding[origin] != NONE)
+  {
+    m_networks[m_networkOfBuilding[origin]].dirty = true;
+  }
+  if (origin == node)
+  {
+    m_water[origin] = 0;
+    m_servedFraction[origin] = 0.f;
+  }
+  m_buildingOrigin[node] = NONE;
+  markDirty(node);
+}
+
+bool WaterNetwork::isVertex(int node) const
+{
+  unsigned int pipes = 0;
+
+  for (int direction = 0; direction < 4; ++direction)
+  {
+    const int n = neighbor(node, direction);
+
+    if (n != NONE && m_pipe[n])
+    {
+      pipes |= 1u << direction;
+    }
+    // buildings need to know which network they are attached to
+    if (n != NONE && m_buildingOrigin[n] != NONE)
+    {
+      return true;
+    }
+  }
+
+  // everything but a straight pipe run is a vertex
+  return m_buildingOrigin[node] != NONE || (pipes != 0b0011 && pipes != 0b1100);
+}
+
+int WaterNetwork::createNetwork()
+{
+  if (!m_freeNetworks.empty())
+  {
+    const int id = m_freeNetworks.back();
+    m_freeNetworks.pop_back();
+    return id;
+  }
+
+  m_networks.emplace_back();
+  return static_cast<int>(m_networks.size()) - 1;
+}
+
+void WaterNetwork::update()
+{
+  std::vector<int> dirtyNetworks;
+  for (size_t id = 0; id < m_networks.size(); ++id)
+  {
+    if (m_networks[id].alive && m_networks[id].dirty)
+    {
+      dirtyNetworks.push_back(static_cast<int>(id));
+    }
+  }
+  if (dirtyNetworks.empty() && m_seeds.empty())
+  {
+    return;
+  }
+  ++m_version;
+
+  for (size_t i = 0; i < dirtyNetworks.size(); ++i)
+  {
+    const int id = dirtyNetworks[i];
+    Network &network = m_networks[id];
+
+    for (int node : network.nodes)
+    {
+      m_networkOfNode[node] = NONE;
+      m_seeds.push_back(node);
+    }
+    for (int building : network.buildings)
+    {
+      if (m_networkOfBuilding[building] == id)
+      {
+        m_networkOfBuilding[building] = NONE;
+        m_servedFraction[building] = 0.f;
+      }
+    }
+    // the released buildings may still be next to other networks, those are rebuilt too so they can claim them
+    for (int contender : network.contenders)
+    {
+      if (m_networks[contender].alive && !m_networks[contender].dirty)
+      {
+        m_networks[contender].dirty = true;
+        dirtyNetworks.push_back(contender);
+      }
+    }
+    network = Network{};
+    m_freeNetworks.push_back(id);
+  }
+
+  for (int seed : m_seeds)
+  {
+    if (m_pipe[seed] && m_networkOfNode[seed] == NONE)
+    {
+      buildNetwork(seed);
+    }
+  }
+  m_seeds.clear();
+}
+
+void WaterNetwork::buildNetwork(int start)
+{
+  const int id = createNetwork();
+  Network &network = m_networks[id];
+  network.alive = true;
+
+  // a straight pipe run always ends in a vertex
+  int vertex = start;
+  if (!isVertex(vertex))
+  {
+    const int direction = (neighbor(vertex, 0) != NONE && m_pipe[neighbor(vertex, 0)]) ? 0 : 2;
+    while (!isVertex(vertex))
+    {
+      vertex = neighbor(vertex, direction);
+    }
+  }
+
+  std::deque<int> queue{vertex};
+  m_networkOfNode[vertex] = id;
+  network.nodes.push_back(vertex);
+  network.vertices.push_back(vertex);
+
+  while (!queue.empty())
+  {
+    const int from = queue.front();
+    queue.pop_front();
+
+    for (int direction = 0; direction < 4; ++direction)
+    {
+      int node = neighbor(from, direction);
+      if (node == NONE || !m_pipe[node])
+      {
+        continue;
+      }
+
+      int length = 1;
+      while (!isVertex(node))
+      {
+        if (m_networkOfNode[node] == NONE)
+        {
+          m_networkOfNode[node] = id;
+          network.nodes.push_back(node);
+        }
+        node = neighbor(node, direction);
+        length++;
+      }
+
+      if (m_networkOfNode[node] == NONE)
+      {
+        m_networkOfNode[node] = id;
+        network.nodes.push_back(node);
+        network.vertices.push_back(node);
+        queue.push_back(node);
+      }
+      if (from < node)
+      {
+        network.edges.push_back(Edge{from, node, length});
+      }
+    }
+  }
+
+  // only vertices can be next to a building
+  for (int node : network.vertices)
+  {
+    for (int direction = -1; direction < 4; ++direction)
+    {
+      const int n = direction < 0 ? node : neighbor(node, direction);
+
+      if (n == NONE || m_buildingOrigin[n] == NONE)
+      {
+        continue;
+      }
+
+      const int owner = m_networkOfBuilding[m_buildingOrigin[n]];
+      if (owner == NONE)
+      {
+        m_networkOfBuilding[m_buildingOrigin[n]] = id;
+        network.buildings.push_back(m_buildingOrigin[n]);
+      }
+      else if (owner != id)
+      {
+        std::vector<int> &contenders = m_networks[owner].contenders;
+        if (std::find(contenders.begin(), contenders.end(), id) == contenders.end())
+        {
+          contenders.push_back(id);
+        }
+      }
+    }
+  }
+  std::sort(network.buildings.begin(), network.buildings.end());
+
+  distributeWater(network);
+}
+
+void WaterNetwork::distributeWater(Network &network)
+{
+  std::vector<int> consumers;
+
+  for (int building : network.buildings)
+  {
+    if (m_water[building] > 0)
+    {
+      network.supply += m_water[building];
+    }
+    else if (m_water[building] < 0)
+    {
+      network.demand -= m_water[building];
+      consumers.push_back(building);
+    }
+  }
+
+  // max-min fair share: serve the smallest demands first, every consumer gets at most an equal share of the rest
+  std::stable_sort(consumers.begin(), consumers.end(), [this](int a, int b) { return m_water[a] > m_water[b]; });
+
+  int remaining = network.supply;
+  int count = static_cast<int>(consumers.size());
+  for (int consumer : consumers)
+  {
+    const int demand = -m_water[consumer];
+    const int served = std::min(demand, remaining / count);
+    m_servedFraction[consumer] = static_cast<float>(served) / demand;
+    remaining -= served;
+    count--;
+  }
+
+  for (int building : network.buildings)
+  {
+    if (m_water[building] >= 0)
+    {
+      m_servedFraction[building] = network.supply > 0 ? 1.f : 0.f;
+    }
+  }
+}
+
+float WaterNetwork::getServedFraction(int x, int y) const
+{
+  const int origin = m_buildingOrigin[nodeIdx(x, y)];
+  return origin == NONE ? 0.f : m_servedFraction[origin];
+}
+
+const WaterNetwork::Network *WaterNetwork::getNetwork(int x, int y) const
+{
+  const int id = m_networkOfNode[nodeIdx(x, y)];
+  return id == NONE ? nullptr : &m_networks[id];
+}
@@ -0,0 +1,112 @@
+#ifndef WATERNETWORK_HXX_
+#define WATERNETWORK_HXX_
+
+#include <vector>
+
+/** @brief Water pipe networks on the UNDERGROUND layer.
+  * Each network is stored as a compact graph: pipe junctions, corners, dead ends and nodes next to buildings are
+  * vertices, straight pipe runs between them are collapsed into weighted edges.
+  * Changes only mark the affected networks dirty, update() rebuilds the dirty networks and distributes their water
+  * supply among the connected consumers with a max-min fair share.
+  */
+class WaterNetwork
+{
+public:
+  /// A straight pipe run between two vertices of a network
+  struct Edge
+  {
+    int from;   /// node index of the first vertex
+    int to;     /// node index of the second vertex
+    int length; /// number of pipe segments between both vertices
+  };
+
+  /// A connected set of pipes
+  struct Network
+  {
+    std::vector<int> nodes;      /// all pipe nodes of the network
+    std::vector<int> vertices;   /// pipe nodes that are vertices of the compact graph
+    std::vector<Edge> edges;     /// collapsed pipe runs
+    std::vector<int> buildings;  /// origin nodes of all connected buildings, ascending
+    std::vector<int> contenders; /// networks next to a building of this network that couldn't claim it
+    int supply = 0;
+    int demand = 0;
+    bool alive = false;
+    bool dirty = false;
+  };
+
+  WaterNetwork(int columns, int rows);
+
+  /** @brief Place or remove a pipe.
+    */
+  void setPipe(int x, int y, bool pipe);
+
+  /** @brief Set the building that covers a node.
+    * @param x the x coordinate of the node.
+    * @param y the y coordinate of the node.
+    * @param originX the x coordinate of the building's origin node.
+    * @param originY the y coordinate of the building's origin node.
+    * @param water water production of the building, negative for consumption.
+    */
+  void setBuildingNode(int x, int y, int originX, int originY, int water);
+
+  /** @brief Remove the building that covers a node.
+    */
+  void clearBuildingNode(int x, int y);
+
+  /** @brief Rebuild all dirty networks and distribute their water.
+    */
+  void update();
+
+  /** @brief Get a counter that changes whenever update() rebuilt a network.
+    */
+  unsigned int getVersion() const { return m_version; };
+
+  /** @brief Get the fraction of the water demand that is served for the building covering the node.
+    * @return a value between 0 and 1, 0 if no building covers the node or it isn't connected to a network.
+    */
+  float getServedFraction(int x, int y) const;
+
+  /** @brief Check if a building that consumes or produces water covers the node.
+    */
+  bool hasBuilding(int x, int y) const { return m_buildingOrigin[nodeIdx(x, y)] != NONE; };
+
+  /** @brief Get the served fractions, indexed by the origin node of each building.
+    */
+  const std::vector<float> &getServedFractions() const { return m_servedFraction; };
+
+  /** @brief Get the network a pipe belongs to, or nullptr if there is no pipe.
+    * @note only valid after update() has been called.
+    */
+  const Network *getNetwork(int x, int y) const;
+
+private:
+  static constexpr int NONE = -1;
+
+  int m_columns;
+  int m_rows;
+  std::vector<bool> m_pipe;
+  /// network index of each pipe node
+  std::vector<int> m_networkOfNode;
+  /// origin node index of the building covering each node
+  std::vector<int> m_buildingOrigin;
+  /// water production of each building, stored at its origin node
+  std::vector<int> m_water;
+  /// network each building is connected to, stored at its origin node
+  std::vector<int> m_networkOfBuilding;
+  std::vector<float> m_servedFraction;
+  std::vector<Network> m_networks;
+  std::vector<int> m_freeNetworks;
+  /// changed nodes that need to be assigned to a network
+  std::vector<int> m_seeds;
+  unsigned int m_version = 0;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  int neighbor(int node, int direction) const;
+  void markDirty(int node);
+  bool isVertex(int node) const;
+  int createNetwork();
+  void buildNetwork(int start);
+  void distributeWater(Network &network);
+};
+
+#endif
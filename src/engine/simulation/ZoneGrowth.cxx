@@ -0,0 +1,170 @@
+#include "ZoneGrowth.hxx"
+
+#include "Map.hxx"
+#include "TileManager.hxx"
+
+#include <algorithm>
+
+ZoneGrowth::ZoneGrowth(Map &map)
+    : m_map(map), m_columns(map.getColumns()), m_rows(map.getRows()), m_zone(m_columns * m_rows, NO_ZONE),
+      m_wealth(m_columns * m_rows, static_cast<uint8_t>(Wealth(Wealth::LOW)._to_index())), m_blocked(m_columns * m_rows, false),
+      m_candidatePosition(m_columns * m_rows, NOT_A_CANDIDATE)
+{
+  m_spawnWeight.fill(1.f);
+}
+
+void ZoneGrowth::onNodeChanged(const MapNodeChange &change)
+{
+  const Point &coords = change.isoCoordinates;
+  const int nodeIndex = nodeIdx(coords.x, coords.y);
+
+  switch (change.layer)
+  {
+  case Layer::ZONE:
+  {
+    m_zone[nodeIndex] = NO_ZONE;
+    if (change.newTileData)
+    {
+      auto zone = Zones::_from_string_nocase_nothrow(change.newTileData->subCategory.c_str());
+      if (zone)
+      {
+        m_zone[nodeIndex] = static_cast<uint8_t>(zone->_to_index());
+      }
+    }
+    break;
+  }
+  case Layer::BUILDINGS:
+  case Layer::ROAD:
+  case Layer::WATER:
+  {
+    const MapNode *node = m_map.getMapNode(coords);
+    const TileData *building = node->getTileData(Layer::BUILDINGS);
+    // ground decoration and overplacable tiles are replaced by spawning buildings
+    m_blocked[nodeIndex] = node->isLayerOccupied(Layer::ROAD) || node->isLayerOccupied(Layer::WATER) ||
+                           (building && building->tileType != +TileType::GROUNDDECORATION && !building->isOverPlacable);
+    break;
+  }
+  default:
+    return;
+  }
+
+  updateCandidate(nodeIndex);
+}
+
+void ZoneGrowth::updateCandidate(int nodeIndex)
+{
+  const bool isCandidate = m_zone[nodeIndex] != NO_ZONE && !m_blocked[nodeIndex];
+  int &position = m_candidatePosition[nodeIndex];
+
+  if (isCandidate && position == NOT_A_CANDIDATE)
+  {
+    position = static_cast<int>(m_candidates.size());
+    m_candidates.push_back(nodeIndex);
+  }
+  else if (!isCandidate && position != NOT_A_CANDIDATE)
+  {
+    // swap with the last candidate so removing is O(1)
+    const int last = m_candidates.back();
+    m_candidates[position] = last;
+    m_candidatePosition[last] = position;
+    m_candidates.pop_back();
+    position = NOT_A_CANDIDATE;
+  }
+}
+
+void ZoneGrowth::tick()
+{
+  const size_t count = std::min(MaxCandidatesPerTick, m_candidates.size());
+
+  for (size_t i = 0; i < count && !m_candidates.empty(); ++i)
+  {
+    if (m_cursor >= m_candidates.size())
+    {
+      m_cursor = 0;
+    }
+
+    // placing a building removes candidates from the worklist, so the cursor only advances if the node stays empty
+    if (!trySpawn(m_candidates[m_cursor]))
+    {
+      ++m_cursor;
+    }
+  }
+}
+
+bool ZoneGrowth::fitsFootprint(const Point &origin, const RequiredTilesData &footprint, Zones zone) const
+{
+  const auto zoneIndex = static_cast<uint8_t>(zone._to_index());
+  for (int i = 0; i < static_cast<int>(footprint.width); i++)
+  {
+    for (int j = 0; j < static_cast<int>(footprint.height); j++)
+    {
+      const int x = origin.x - i;
+      const int y = origin.y + j;
+
+      if (!isInside(x, y))
+      {
+        return false;
+      }
+
+      const int nodeIndex = nodeIdx(x, y);
+      if (m_zone[nodeIndex] != zoneIndex || m_blocked[nodeIndex])
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool ZoneGrowth::trySpawn(int nodeIndex)
+{
+  const uint8_t zoneIndex = m_zone[nodeIndex];
+  const Zones zone = Zones::_from_index(zoneIndex);
+  const Wealth wealth = Wealth::_from_index(m_wealth[nodeIndex]);
+  const Point origin{nodeIndex / m_columns, nodeIndex % m_columns, 0, 0};
+
+  // without demand, the candidates of a zone are skipped
+  const float spawnWeight = m_spawnWeight[zoneIndex];
+  if (spawnWeight < 1.f && std::uniform_real_distribution<float>{0.f, 1.f}(m_random) >= spawnWeight)
+  {
+    return false;
+  }
+
+  const std::vector<RequiredTilesData> &footprints = TileManager::instance().getRCISpawnFootprints(zone, wealth, m_style);
+
+  // collect all footprints that fit and choose one of them, so big and small buildings mix
+  m_fittingFootprints.clear();
+  for (size_t i = 0; i < footprints.size(); ++i)
+  {
+    if (fitsFootprint(origin, footprints[i], zone))
+    {
+      m_fittingFootprints.push_back(i);
+    }
+  }
+
+  if (m_fittingFootprints.empty())
+  {
+    return false;
+  }
+
+  const size_t footprintIndex =
+      m_fittingFootprints[std::uniform_int_distribution<size_t>{0, m_fittingFootprints.size() - 1}(m_random)];
+  const std::vector<std::string> &tileIDs = TileManager::instance().getRCISpawnCandidates(zone, wealth, m_style, footprintIndex);
+  const std::string &tileID = tileIDs[std::uniform_int_distribution<size_t>{0, tileIDs.size() - 1}(m_random)];
+
+  std::vector<Point> coords = m_map.getObjectCoords(origin, tileID);
+  m_map.setTileIDOfNode(coords.begin(), coords.end(), tileID, coords.size() == 1);
+
+  // setTileIDOfNode rejects the placement if e.g. the slope doesn't allow it
+  return m_blocked[nodeIndex];
+}
+
+void ZoneGrowth::setNodeWealth(const Point &isoCoordinates, Wealth wealth)
+{
+  m_wealth[nodeIdx(isoCoordinates.x, isoCoordinates.y)] = static_cast<uint8_t>(wealth._to_index());
+}
+
+Wealth ZoneGrowth::getNodeWealth(const Point &isoCoordinates) const
+{
+  return Wealth::_from_index(m_wealth[nodeIdx(isoCoordinates.x, isoCoordinates.y)]);
+}
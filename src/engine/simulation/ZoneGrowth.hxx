@@ -0,0 +1,112 @@
+#ifndef ZONEGROWTH_HXX_
+#define ZONEGROWTH_HXX_
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "basics/point.hxx"
+#include "basics/tileData.hxx"
+
+class Map;
+struct MapNodeChange;
+
+/** @brief Spawns RCI buildings on zoned nodes.
+  * Keeps a worklist of all zoned nodes that are still empty. The worklist is updated incrementally whenever the map
+  * announces a changed node, so a growth tick never has to scan the whole map.
+  */
+class ZoneGrowth
+{
+public:
+  /// Number of candidates from the worklist that are processed per tick
+  static constexpr size_t MaxCandidatesPerTick = 32;
+
+  explicit ZoneGrowth(Map &map);
+
+  /** @brief Update the worklist for a changed map node.
+    * @param change the change emitted by the map.
+    */
+  void onNodeChanged(const MapNodeChange &change);
+
+  /** @brief Try to spawn buildings on the next batch of candidates.
+    */
+  void tick();
+
+  /** @brief Set the wealth level that is used for buildings spawning on the given node.
+    * @param isoCoordinates the node.
+    * @param wealth the wealth level.
+    */
+  void setNodeWealth(const Point &isoCoordinates, Wealth wealth);
+
+  /** @brief Get the wealth level that is used for buildings spawning on the given node.
+    */
+  Wealth getNodeWealth(const Point &isoCoordinates) const;
+
+  /** @brief Set the chance that a building spawns on a candidate of a zone.
+    * @param zone the zone.
+    * @param weight the chance between 0 (no growth) and 1 (spawn wherever a building fits), 1 by default.
+    */
+  void setSpawnWeight(Zones zone, float weight) { m_spawnWeight[zone._to_index()] = weight; };
+
+  /** @brief Set the art style of the spawned buildings.
+    */
+  void setStyle(Style style) { m_style = style; };
+  Style getStyle() const { return m_style; };
+
+  /** @brief Seed the random choice of the spawned buildings.
+    */
+  void setSeed(uint32_t seed) { m_random.seed(seed); };
+
+  /** @brief Get the number of zoned nodes that are still empty.
+    */
+  size_t getCandidateCount() const { return m_candidates.size(); };
+
+  /** @brief Check if a node is in the worklist.
+    */
+  bool isCandidate(const Point &isoCoordinates) const
+  {
+    return m_candidatePosition[nodeIdx(isoCoordinates.x, isoCoordinates.y)] != NOT_A_CANDIDATE;
+  };
+
+  /** @brief Check if all nodes of the footprint are empty nodes of the zone.
+    * The footprint grows from the origin like Map::getObjectCoords does.
+    */
+  bool fitsFootprint(const Point &origin, const RequiredTilesData &footprint, Zones zone) const;
+
+private:
+  static constexpr uint8_t NO_ZONE = 0xFF;
+  static constexpr int NOT_A_CANDIDATE = -1;
+
+  Map &m_map;
+  int m_columns;
+  int m_rows;
+  /// Zones index of the zone on each node, or NO_ZONE
+  std::vector<uint8_t> m_zone;
+  /// Wealth index of each node
+  std::vector<uint8_t> m_wealth;
+  /// true if the node is blocked by a building, a road or water
+  std::vector<bool> m_blocked;
+  /// node indices of all empty zoned nodes
+  std::vector<int> m_candidates;
+  /// position of each node in m_candidates, or NOT_A_CANDIDATE
+  std::vector<int> m_candidatePosition;
+  /// scratch buffer for the footprints that fit on a candidate
+  std::vector<size_t> m_fittingFootprints;
+  size_t m_cursor = 0;
+  /// spawn weight of each Zones index
+  std::array<float, Zones::_size()> m_spawnWeight;
+  Style m_style = Style::EUROPEAN;
+  std::mt19937 m_random;
+
+  int nodeIdx(int x, int y) const { return x * m_columns + y; };
+  bool isInside(int x, int y) const { return x >= 0 && x < m_rows && y >= 0 && y < m_columns; };
+  void updateCandidate(int nodeIndex);
+
+  /** @brief Try to spawn a building on the given node.
+    * @returns true if a building has been placed.
+    */
+  bool trySpawn(int nodeIndex);
+};
+
+#endif
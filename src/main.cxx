@@ -3,6 +3,7 @@
 #include "Game.hxx"
 #include "Exception.hxx"
 #include "LOG.hxx"
+#include "engine/Engine.hxx"
 #include "engine/basics/Settings.hxx"
 #include "Initializer.hxx"
 
@@ -33,6 +34,11 @@ int protected_main(int argc, char **argv)
   if (!game.initialize())
     return EXIT_FAILURE;
 
+  if (!settings.replayCommands.empty())
+  {
+    return Engine::instance().replay(settings.replayCommands) ? EXIT_SUCCESS : EXIT_FAILURE;
+  }
+
   if (settings.newUI)
   {
     game.newUI();
@@ -0,0 +1,127 @@
+#ifndef BYTE_STREAM_HXX_
+#define BYTE_STREAM_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Exception.hxx"
+#include "LOG.hxx"
+
+/**
+  * @brief Appends variable length encoded integers to a byte buffer.
+  * @details Unsigned values are stored as LEB128 varints, 7 bits per byte. Signed values are zigzag encoded first,
+  * so small negative values stay short as well.
+  */
+class ByteWriter
+{
+public:
+  explicit ByteWriter(std::vector<uint8_t> &buffer) : m_buffer(buffer) {}
+
+  void writeVarint(uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      m_buffer.push_back(static_cast<uint8_t>(value | 0x80));
+      value >>= 7;
+    }
+    m_buffer.push_back(static_cast<uint8_t>(value));
+  }
+
+  void writeSignedVarint(int64_t value) { writeVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63)); }
+
+  /// floats are stored as the varint of their bits, so they survive the round trip exactly and zero takes one byte
+  void writeFloat(float value)
+  {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    writeVarint(bits);
+  }
+
+  void writeBytes(const std::vector<uint8_t> &bytes)
+  {
+    writeVarint(bytes.size());
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+  }
+
+  void writeString(const std::string &string)
+  {
+    writeVarint(string.size());
+    m_buffer.insert(m_buffer.end(), string.begin(), string.end());
+  }
+
+private:
+  std::vector<uint8_t> &m_buffer;
+};
+
+/**
+  * @brief Reads the values written by a ByteWriter.
+  * @throws CytopiaError if the data ends in the middle of a value.
+  */
+class ByteReader
+{
+public:
+  ByteReader(const uint8_t *begin, const uint8_t *end) : m_position(begin), m_end(end) {}
+  explicit ByteReader(const std::vector<uint8_t> &buffer) : ByteReader(buffer.data(), buffer.data() + buffer.size()) {}
+
+  bool atEnd() const { return m_position == m_end; }
+
+  uint64_t readVarint()
+  {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+    {
+      if (m_position == m_end)
+      {
+        throw CytopiaError{TRACE_INFO "Unexpected end of data"};
+      }
+      const uint8_t byte = *m_position++;
+      value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+      if (!(byte & 0x80))
+      {
+        return value;
+      }
+    }
+    throw CytopiaError{TRACE_INFO "Malformed varint"};
+  }
+
+  int64_t readSignedVarint()
+  {
+    const uint64_t value = readVarint();
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+  }
+
+  float readFloat()
+  {
+    const uint32_t bits = static_cast<uint32_t>(readVarint());
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+  }
+
+  std::vector<uint8_t> readBytes()
+  {
+    const uint64_t size = readVarint();
+    if (size > static_cast<uint64_t>(m_end - m_position))
+    {
+      throw CytopiaError{TRACE_INFO "Unexpected end of data"};
+    }
+    std::vector<uint8_t> bytes(m_position, m_position + size);
+    m_position += size;
+    return bytes;
+  }
+
+  std::string readString()
+  {
+    const std::vector<uint8_t> bytes = readBytes();
+    return std::string(bytes.begin(), bytes.end());
+  }
+
+private:
+  const uint8_t *m_position;
+  const uint8_t *m_end;
+};
+
+#endif
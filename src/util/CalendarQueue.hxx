@@ -0,0 +1,96 @@
+#ifndef CALENDAR_QUEUE_HXX_
+#define CALENDAR_QUEUE_HXX_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+  * @brief Priority queue of values that are due on a day, with one bucket per day.
+  * @details The buckets form a ring that covers the days from the current day to the horizon, so every bucket only
+  * holds the values of a single day. Scheduling and taking a due value are O(1), no matter how many values are queued.
+  * Values scheduled beyond the horizon are due at the horizon, values scheduled in the past are due on the current day.
+  */
+template <typename T> class CalendarQueue
+{
+public:
+  explicit CalendarQueue(uint32_t horizon) : m_buckets(horizon) {}
+
+  /**
+    * @brief Get the number of days the queue reaches into the future.
+    */
+  uint32_t getHorizon() const { return static_cast<uint32_t>(m_buckets.size()); }
+
+  /**
+    * @brief Get the first day that may still have due values.
+    */
+  uint32_t getCurrentDay() const { return m_currentDay; }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+
+  /**
+    * @brief Schedule a value for a day.
+    * @return the day the value has been scheduled for, after clamping it to the days the queue covers.
+    */
+  uint32_t schedule(uint32_t day, const T &value)
+  {
+    if (day < m_currentDay)
+    {
+      day = m_currentDay;
+    }
+    else if (day - m_currentDay >= getHorizon())
+    {
+      day = m_currentDay + getHorizon() - 1;
+    }
+    m_buckets[day % getHorizon()].push_back(value);
+    m_size++;
+    return day;
+  }
+
+  /**
+    * @brief Remove all values and continue on another day, e.g. after a saved game has been loaded.
+    */
+  void reset(uint32_t day)
+  {
+    for (std::vector<T> &bucket : m_buckets)
+    {
+      bucket.clear();
+    }
+    m_currentDay = day;
+    m_size = 0;
+  }
+
+  /**
+    * @brief Take a value that is due on or before today, values of earlier days come first.
+    * @return false if no value is due.
+    */
+  bool popDue(uint32_t today, T &value)
+  {
+    while (m_currentDay <= today)
+    {
+      std::vector<T> &bucket = m_buckets[m_currentDay % getHorizon()];
+      if (!bucket.empty())
+      {
+        value = bucket.back();
+        bucket.pop_back();
+        m_size--;
+        return true;
+      }
+      // values may still be scheduled for today
+      if (m_currentDay == today)
+      {
+        break;
+      }
+      m_currentDay++;
+    }
+    return false;
+  }
+
+private:
+  std::vector<std::vector<T>> m_buckets;
+  uint32_t m_currentDay = 0;
+  size_t m_size = 0;
+};
+
+#endif
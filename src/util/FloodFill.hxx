@@ -0,0 +1,130 @@
+#ifndef FLOODFILL_HXX_
+#define FLOODFILL_HXX_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/** @brief Scanline flood fill over a grid of rows x columns nodes.
+  * The fill spreads to the four direct neighbors. Each node is checked for eligibility at most once per fill, the result
+  * and the filled nodes are kept in packed bitmaps with one bit per node.
+  * Node indices are x * columns + y, rows run along y.
+  */
+class FloodFill
+{
+public:
+  FloodFill(int columns, int rows)
+      : m_columns(columns), m_rows(rows), m_checked(wordCount()), m_eligible(wordCount()), m_filled(wordCount())
+  {
+  }
+
+  /** @brief Fill the connected area of eligible nodes around (x, y).
+    * @param isEligible callable taking x and y, returning whether the node may be filled.
+    * @param maxArea the fill stops after this many nodes.
+    * @param nodes receives the indices of the filled nodes.
+    * @return false if the area is bigger than maxArea and has been cut off.
+    */
+  template <typename Predicate> bool fill(int x, int y, Predicate isEligible, size_t maxArea, std::vector<int> &nodes)
+  {
+    nodes.clear();
+    std::fill(m_checked.begin(), m_checked.end(), 0);
+    std::fill(m_filled.begin(), m_filled.end(), 0);
+    m_seeds.clear();
+
+    auto canFill = [&](int nodeX, int nodeY) {
+      const int node = nodeX * m_columns + nodeY;
+      if (!get(m_checked, node))
+      {
+        set(m_checked, node);
+        if (isEligible(nodeX, nodeY))
+        {
+          set(m_eligible, node);
+        }
+        else
+        {
+          clear(m_eligible, node);
+        }
+      }
+      return get(m_eligible, node) && !get(m_filled, node);
+    };
+
+    if (x < 0 || x >= m_rows || y < 0 || y >= m_columns)
+    {
+      return true;
+    }
+    m_seeds.emplace_back(x, y);
+
+    while (!m_seeds.empty())
+    {
+      const auto [seedX, seedY] = m_seeds.back();
+      m_seeds.pop_back();
+
+      if (!canFill(seedX, seedY))
+      {
+        continue;
+      }
+
+      // extend the seed to the whole run of its row
+      int first = seedY;
+      int last = seedY;
+      while (first > 0 && canFill(seedX, first - 1))
+      {
+        --first;
+      }
+      while (last < m_columns - 1 && canFill(seedX, last + 1))
+      {
+        ++last;
+      }
+
+      for (int runY = first; runY <= last; ++runY)
+      {
+        if (nodes.size() == maxArea)
+        {
+          return false;
+        }
+        const int node = seedX * m_columns + runY;
+        set(m_filled, node);
+        nodes.push_back(node);
+      }
+
+      // add one seed for every run of fillable nodes in the rows above and below
+      for (int neighborX : {seedX - 1, seedX + 1})
+      {
+        if (neighborX < 0 || neighborX >= m_rows)
+        {
+          continue;
+        }
+
+        bool inRun = false;
+        for (int runY = first; runY <= last; ++runY)
+        {
+          const bool fillable = canFill(neighborX, runY);
+          if (fillable && !inRun)
+          {
+            m_seeds.emplace_back(neighborX, runY);
+          }
+          inRun = fillable;
+        }
+      }
+    }
+
+    return true;
+  }
+
+private:
+  int m_columns;
+  int m_rows;
+  std::vector<uint64_t> m_checked;
+  std::vector<uint64_t> m_eligible;
+  std::vector<uint64_t> m_filled;
+  std::vector<std::pair<int, int>> m_seeds;
+
+  size_t wordCount() const { return (static_cast<size_t>(m_columns) * m_rows + 63) / 64; };
+  static bool get(const std::vector<uint64_t> &bits, int node) { return (bits[node / 64] >> (node % 64)) & 1; };
+  static void set(std::vector<uint64_t> &bits, int node) { bits[node / 64] |= 1ULL << (node % 64); };
+  static void clear(std::vector<uint64_t> &bits, int node) { bits[node / 64] &= ~(1ULL << (node % 64)); };
+};
+
+#endif
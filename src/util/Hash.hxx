@@ -0,0 +1,88 @@
+#ifndef HASH_HXX_
+#define HASH_HXX_
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+  * @brief 64 bit xxHash (XXH64) of a block of memory.
+  * @details Fast, non-cryptographic hash with good distribution. The input is read as little endian, so the result is
+  * the same on all platforms.
+  * @param data the bytes to hash.
+  * @param length the number of bytes.
+  * @param seed seed of the hash, the result of a previous hash can be passed to chain several blocks.
+  */
+inline uint64_t xxHash64(const void *data, size_t length, uint64_t seed = 0)
+{
+  constexpr uint64_t PRIME1 = 0x9E3779B185EBCA87ULL;
+  constexpr uint64_t PRIME2 = 0xC2B2AE3D27D4EB4FULL;
+  constexpr uint64_t PRIME3 = 0x165667B19E3779F9ULL;
+  constexpr uint64_t PRIME4 = 0x85EBCA77C2B2AE63ULL;
+  constexpr uint64_t PRIME5 = 0x27D4EB2F165667C5ULL;
+
+  auto rotate = [](uint64_t value, int bits) { return (value << bits) | (value >> (64 - bits)); };
+  auto read = [](const uint8_t *bytes, int count) {
+    uint64_t value = 0;
+    for (int i = count - 1; i >= 0; --i)
+    {
+      value = (value << 8) | bytes[i];
+    }
+    return value;
+  };
+  auto round = [&rotate](uint64_t accumulator, uint64_t input) {
+    return rotate(accumulator + input * PRIME2, 31) * PRIME1;
+  };
+  auto merge = [&round](uint64_t hash, uint64_t accumulator) { return (hash ^ round(0, accumulator)) * PRIME1 + PRIME4; };
+
+  const uint8_t *position = static_cast<const uint8_t *>(data);
+  const uint8_t *const end = position + length;
+  uint64_t hash;
+
+  if (length >= 32)
+  {
+    uint64_t accumulators[4] = {seed + PRIME1 + PRIME2, seed + PRIME2, seed, seed - PRIME1};
+    for (; end - position >= 32; position += 32)
+    {
+      for (int lane = 0; lane < 4; ++lane)
+      {
+        accumulators[lane] = round(accumulators[lane], read(position + lane * 8, 8));
+      }
+    }
+
+    hash = rotate(accumulators[0], 1) + rotate(accumulators[1], 7) + rotate(accumulators[2], 12) +
+           rotate(accumulators[3], 18);
+    for (uint64_t accumulator : accumulators)
+    {
+      hash = merge(hash, accumulator);
+    }
+  }
+  else
+  {
+    hash = seed + PRIME5;
+  }
+
+  hash += static_cast<uint64_t>(length);
+
+  for (; end - position >= 8; position += 8)
+  {
+    hash = rotate(hash ^ round(0, read(position, 8)), 27) * PRIME1 + PRIME4;
+  }
+  if (end - position >= 4)
+  {
+    hash = rotate(hash ^ (read(position, 4) * PRIME1), 23) * PRIME2 + PRIME3;
+    position += 4;
+  }
+  for (; position != end; ++position)
+  {
+    hash = rotate(hash ^ (*position * PRIME5), 11) * PRIME1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= PRIME2;
+  hash ^= hash >> 29;
+  hash *= PRIME3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+#endif
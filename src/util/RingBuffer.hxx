@@ -0,0 +1,50 @@
+#ifndef RING_BUFFER_HXX_
+#define RING_BUFFER_HXX_
+
+#include <array>
+#include <cstddef>
+
+/**
+  * @brief Keeps the newest Capacity values, pushing a value into a full buffer overwrites the oldest one.
+  * @details The storage is allocated once with the buffer, pushing never allocates.
+  */
+template <typename T, size_t Capacity> class RingBuffer
+{
+public:
+  void push(const T &value)
+  {
+    m_values[(m_begin + m_size) % Capacity] = value;
+    if (m_size < Capacity)
+    {
+      m_size++;
+    }
+    else
+    {
+      m_begin = (m_begin + 1) % Capacity;
+    }
+  }
+
+  /**
+    * @brief Get a value by its age, 0 is the oldest value and size() - 1 the newest.
+    */
+  const T &operator[](size_t index) const { return m_values[(m_begin + index) % Capacity]; }
+
+  const T &back() const { return (*this)[m_size - 1]; }
+
+  size_t size() const { return m_size; }
+  bool empty() const { return m_size == 0; }
+  static constexpr size_t capacity() { return Capacity; }
+
+  void clear()
+  {
+    m_begin = 0;
+    m_size = 0;
+  }
+
+private:
+  std::array<T, Capacity> m_values{};
+  size_t m_begin = 0;
+  size_t m_size = 0;
+};
+
+#endif
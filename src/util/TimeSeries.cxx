@@ -0,0 +1,247 @@
+#include "TimeSeries.hxx"
+
+#include "ByteStream.hxx"
+
+#include <algorithm>
+#include <cmath>
+
+int TimeSeries::getValuesPerSample(int level)
+{
+  static constexpr std::array<int, LevelCount> valuesPerSample = {1, 7, 30};
+  return valuesPerSample[level];
+}
+
+void TimeSeries::push(int32_t value)
+{
+  ++m_valueCount;
+
+  for (int index = 0; index < LevelCount; ++index)
+  {
+    Level &level = m_levels[index];
+    level.min = level.count == 0 ? value : std::min(level.min, value);
+    level.max = level.count == 0 ? value : std::max(level.max, value);
+    level.sum += value;
+
+    if (++level.count == getValuesPerSample(index))
+    {
+      const int32_t mean = static_cast<int32_t>(std::lround(static_cast<double>(level.sum) / level.count));
+      addSample(level, Sample{level.min, mean, level.max});
+      level.count = 0;
+      level.sum = 0;
+    }
+  }
+}
+
+void TimeSeries::addSample(Level &level, const Sample &sample)
+{
+  if (level.ring.empty())
+  {
+    level.ring.resize(RingCapacity);
+  }
+
+  if (level.size == RingCapacity)
+  {
+    // compress the oldest samples of the ring into a block
+    std::vector<Sample> samples;
+    samples.reserve(BlockSize);
+    for (size_t i = 0; i < BlockSize; ++i)
+    {
+      samples.push_back(level.ring[(level.head + i) % RingCapacity]);
+    }
+    level.blocks.emplace_back();
+    encode(samples, level.blocks.back());
+    level.head = (level.head + BlockSize) % RingCapacity;
+    level.size -= BlockSize;
+
+    if (level.blocks.size() > MaxBlocks)
+    {
+      level.blocks.pop_front();
+      level.first += BlockSize;
+    }
+  }
+
+  level.ring[(level.head + level.size) % RingCapacity] = sample;
+  ++level.size;
+}
+
+size_t TimeSeries::getEndSample(int level) const
+{
+  const Level &data = m_levels[level];
+  return data.first + data.blocks.size() * BlockSize + data.size;
+}
+
+void TimeSeries::getSamples(int level, size_t first, size_t last, std::vector<Sample> &samples) const
+{
+  const Level &data = m_levels[level];
+  first = std::max(first, data.first);
+  last = std::min(last, getEndSample(level));
+  samples.clear();
+  if (first >= last)
+  {
+    return;
+  }
+  samples.reserve(last - first);
+
+  const size_t ringStart = data.first + data.blocks.size() * BlockSize;
+  std::vector<Sample> decoded;
+  size_t index = first;
+
+  while (index < std::min(last, ringStart))
+  {
+    const size_t block = (index - data.first) / BlockSize;
+    const size_t blockStart = data.first + block * BlockSize;
+    decode(data.blocks[block], BlockSize, decoded);
+    const size_t blockEnd = std::min(last, blockStart + BlockSize);
+    samples.insert(samples.end(), decoded.begin() + (index - blockStart), decoded.begin() + (blockEnd - blockStart));
+    index = blockEnd;
+  }
+
+  for (; index < last; ++index)
+  {
+    samples.push_back(data.ring[(data.head + index - ringStart) % RingCapacity]);
+  }
+}
+
+int TimeSeries::selectLevel(uint64_t valueCount, size_t maxPoints) const
+{
+  for (int level = 0; level < LevelCount - 1; ++level)
+  {
+    const uint64_t samples = valueCount / getValuesPerSample(level);
+    const size_t end = getEndSample(level);
+    if (samples <= maxPoints && end - getFirstSample(level) >= std::min<uint64_t>(samples, end))
+    {
+      return level;
+    }
+  }
+  return LevelCount - 1;
+}
+
+size_t TimeSeries::getMemoryUsage() const
+{
+  size_t bytes = sizeof(TimeSeries);
+  for (const Level &level : m_levels)
+  {
+    bytes += level.ring.capacity() * sizeof(Sample);
+    for (const std::vector<uint8_t> &block : level.blocks)
+    {
+      bytes += block.capacity();
+    }
+  }
+  return bytes;
+}
+
+void TimeSeries::encode(const std::vector<Sample> &samples, std::vector<uint8_t> &bytes)
+{
+  ByteWriter writer(bytes);
+
+  // the channels are encoded one after another, consecutive values of one channel are usually close
+  for (int32_t Sample::*channel : {&Sample::min, &Sample::mean, &Sample::max})
+  {
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+    for (const Sample &sample : samples)
+    {
+      const int64_t delta = sample.*channel - previous;
+      writer.writeSignedVarint(delta - previousDelta);
+      previous = sample.*channel;
+      previousDelta = delta;
+    }
+  }
+}
+
+void TimeSeries::decode(const std::vector<uint8_t> &bytes, size_t count, std::vector<Sample> &samples)
+{
+  ByteReader reader(bytes);
+  samples.resize(count);
+
+  for (int32_t Sample::*channel : {&Sample::min, &Sample::mean, &Sample::max})
+  {
+    int64_t previous = 0;
+    int64_t previousDelta = 0;
+    for (Sample &sample : samples)
+    {
+      previousDelta += reader.readSignedVarint();
+      previous += previousDelta;
+      sample.*channel = static_cast<int32_t>(previous);
+    }
+  }
+  if (!reader.atEnd())
+  {
+    throw CytopiaError{TRACE_INFO "Malformed block in time series"};
+  }
+}
+
+void TimeSeries::save(ByteWriter &writer) const
+{
+  writer.writeVarint(m_valueCount);
+
+  for (const Level &level : m_levels)
+  {
+    writer.writeVarint(level.first);
+    writer.writeVarint(level.blocks.size());
+    for (const std::vector<uint8_t> &block : level.blocks)
+    {
+      writer.writeBytes(block);
+    }
+
+    std::vector<Sample> samples;
+    for (size_t i = 0; i < level.size; ++i)
+    {
+      samples.push_back(level.ring[(level.head + i) % RingCapacity]);
+    }
+    std::vector<uint8_t> bytes;
+    encode(samples, bytes);
+    writer.writeVarint(level.size);
+    writer.writeBytes(bytes);
+
+    writer.writeVarint(level.count);
+    writer.writeSignedVarint(level.min);
+    writer.writeSignedVarint(level.max);
+    writer.writeSignedVarint(level.sum);
+  }
+}
+
+void TimeSeries::load(ByteReader &reader)
+{
+  m_valueCount = reader.readVarint();
+
+  std::vector<Sample> samples;
+  for (int index = 0; index < LevelCount; ++index)
+  {
+    Level &level = m_levels[index];
+    level = Level();
+    level.first = reader.readVarint();
+    const uint64_t blockCount = reader.readVarint();
+    if (blockCount > MaxBlocks)
+    {
+      throw CytopiaError{TRACE_INFO "Too many blocks in time series"};
+    }
+    for (uint64_t block = 0; block < blockCount; ++block)
+    {
+      level.blocks.push_back(reader.readBytes());
+      // the blocks are decoded again when they are shown, they must not fail there
+      decode(level.blocks.back(), BlockSize, samples);
+    }
+
+    const uint64_t size = reader.readVarint();
+    if (size > RingCapacity)
+    {
+      throw CytopiaError{TRACE_INFO "Too many samples in time series"};
+    }
+    decode(reader.readBytes(), size, samples);
+    level.ring.resize(RingCapacity);
+    std::copy(samples.begin(), samples.end(), level.ring.begin());
+    level.size = size;
+
+    const uint64_t count = reader.readVarint();
+    // a complete sample would have been added, so the aggregation would never reach the count again
+    if (count >= static_cast<uint64_t>(getValuesPerSample(index)))
+    {
+      throw CytopiaError{TRACE_INFO "Malformed incomplete sample in time series"};
+    }
+    level.count = static_cast<int>(count);
+    level.min = static_cast<int32_t>(reader.readSignedVarint());
+    level.max = static_cast<int32_t>(reader.readSignedVarint());
+    level.sum = reader.readSignedVarint();
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef TIME_SERIES_HXX_
+#define TIME_SERIES_HXX_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+class ByteWriter;
+class ByteReader;
+
+/**
+  * @brief Bounded history of a single value, recorded once per day.
+  * @details The values are kept in several levels of decreasing resolution: days, weeks and months. Each level stores
+  * the minimum, mean and maximum of the values of one sample period. The newest samples of a level are kept
+  * uncompressed in a ring buffer; when the ring is full, its oldest samples are compressed into a block using delta of
+  * delta and varint encoding. Only a fixed number of blocks is kept per level, so the memory usage is bounded.
+  */
+class TimeSeries
+{
+public:
+  struct Sample
+  {
+    int32_t min = 0;
+    int32_t mean = 0;
+    int32_t max = 0;
+  };
+
+  /// Number of resolution levels
+  static constexpr int LevelCount = 3;
+  /// Number of uncompressed samples per level
+  static constexpr size_t RingCapacity = 128;
+  /// Number of samples per compressed block
+  static constexpr size_t BlockSize = 64;
+  /// Number of compressed blocks kept per level
+  static constexpr size_t MaxBlocks = 16;
+
+  /**
+    * @brief Get the number of recorded values that are combined into one sample of a level.
+    */
+  static int getValuesPerSample(int level);
+
+  /**
+    * @brief Record the next value.
+    */
+  void push(int32_t value);
+
+  /**
+    * @brief Get the number of values recorded since the beginning.
+    */
+  uint64_t getValueCount() const { return m_valueCount; }
+
+  /**
+    * @brief Get the index of the oldest sample of a level that is still stored.
+    */
+  size_t getFirstSample(int level) const { return m_levels[level].first; }
+
+  /**
+    * @brief Get the index after the newest complete sample of a level.
+    */
+  size_t getEndSample(int level) const;
+
+  /**
+    * @brief Get the samples of a level in the range [first, last).
+    * @details The range is clamped to the stored samples. Only the compressed blocks that overlap the range are decoded.
+    */
+  void getSamples(int level, size_t first, size_t last, std::vector<Sample> &samples) const;
+
+  /**
+    * @brief Get the finest level that shows the latest values with at most maxPoints samples.
+    */
+  int selectLevel(uint64_t valueCount, size_t maxPoints) const;
+
+  /**
+    * @brief Get the approximate number of bytes used by the stored samples.
+    */
+  size_t getMemoryUsage() const;
+
+  void save(ByteWriter &writer) const;
+
+  /**
+    * @throws CytopiaError if the data is malformed.
+    */
+  void load(ByteReader &reader);
+
+private:
+  struct Level
+  {
+    std::vector<Sample> ring;
+    size_t head = 0;
+    size_t size = 0;
+    std::deque<std::vector<uint8_t>> blocks;
+    /// index of the oldest stored sample
+    size_t first = 0;
+    /// values of the current, incomplete sample
+    int count = 0;
+    int32_t min = 0;
+    int32_t max = 0;
+    int64_t sum = 0;
+  };
+
+  std::array<Level, LevelCount> m_levels;
+  uint64_t m_valueCount = 0;
+
+  static void addSample(Level &level, const Sample &sample);
+  static void encode(const std::vector<Sample> &samples, std::vector<uint8_t> &bytes);
+  static void decode(const std::vector<uint8_t> &bytes, size_t count, std::vector<Sample> &samples);
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef UNION_FIND_HXX_
+#define UNION_FIND_HXX_
+
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <cstddef>
+
+/**
+  * @brief Disjoint set forest with union by size and path halving.
+  */
+class UnionFind
+{
+public:
+  explicit UnionFind(size_t size = 0) { resize(size); }
+
+  /**
+    * @brief Resize the forest, every element becomes its own set.
+    */
+  void resize(size_t size)
+  {
+    m_parent.resize(size);
+    std::iota(m_parent.begin(), m_parent.end(), 0);
+    m_size.assign(size, 1);
+  }
+
+  /**
+    * @brief Make the element a set of its own again.
+    * @details Only valid if no other element of its set references it, e.g. while resetting a whole set.
+    */
+  void reset(int element)
+  {
+    m_parent[element] = element;
+    m_size[element] = 1;
+  }
+
+  /**
+    * @brief Find the representative of the set the element belongs to.
+    */
+  int find(int element)
+  {
+    while (m_parent[element] != element)
+    {
+      m_parent[element] = m_parent[m_parent[element]];
+      element = m_parent[element];
+    }
+    return element;
+  }
+
+  /**
+    * @brief Merge the sets of both elements.
+    * @return the representative of the merged set.
+    */
+  int unite(int a, int b)
+  {
+    a = find(a);
+    b = find(b);
+    if (a == b)
+    {
+      return a;
+    }
+    if (m_size[a] < m_size[b])
+    {
+      std::swap(a, b);
+    }
+    m_parent[b] = a;
+    m_size[a] += m_size[b];
+    return a;
+  }
+
+  /**
+    * @brief Get the number of elements in the set the element belongs to.
+    */
+  int setSize(int element) { return m_size[find(element)]; }
+
+private:
+  std::vector<int> m_parent;
+  std::vector<int> m_size;
+};
+
+#endif // UNION_FIND_HXX_
@@ -0,0 +1,80 @@
+#include <catch.hpp>
+#include <algorithm>
+#include "../../src/engine/TileManager.hxx"
+#include "../GameFixture.hxx"
+
+namespace
+{
+template <typename Enum> bool allowsValue(const std::vector<Enum> &values, Enum value)
+{
+  // tiles without restrictions spawn with every value
+  return values.empty() || std::find(values.begin(), values.end(), value) != values.end();
+}
+} // namespace
+
+TEST_CASE_METHOD(GameFixture, "RCI spawn tables only hold matching tiles", "[engine][tilemanager]")
+{
+  TileManager &tileManager = TileManager::instance();
+  size_t candidates = 0;
+
+  for (Zones zone : Zones::_values())
+  {
+    for (Wealth wealth : Wealth::_values())
+    {
+      for (Style style : Style::_values())
+      {
+        const std::vector<RequiredTilesData> &footprints = tileManager.getRCISpawnFootprints(zone, wealth, style);
+        for (size_t footprint = 0; footprint < footprints.size(); ++footprint)
+        {
+          if (footprint > 0)
+          {
+            CHECK(footprints[footprint - 1].width * footprints[footprint - 1].height >=
+                  footprints[footprint].width * footprints[footprint].height);
+          }
+
+          const std::vector<std::string> &tileIDs = tileManager.getRCISpawnCandidates(zone, wealth, style, footprint);
+          CHECK_FALSE(tileIDs.empty());
+          CHECK(std::is_sorted(tileIDs.begin(), tileIDs.end()));
+          for (const std::string &tileID : tileIDs)
+          {
+            const TileData *tileData = tileManager.getTileData(tileID);
+            REQUIRE(tileData);
+            CHECK(tileData->tileType == +TileType::RCI);
+            CHECK(std::find(tileData->zones.begin(), tileData->zones.end(), zone) != tileData->zones.end());
+            CHECK(allowsValue(tileData->wealth, wealth));
+            CHECK(allowsValue(tileData->style, style));
+            CHECK(tileData->RequiredTiles.width == footprints[footprint].width);
+            CHECK(tileData->RequiredTiles.height == footprints[footprint].height);
+          }
+          candidates += tileIDs.size();
+        }
+      }
+    }
+  }
+
+  CHECK(candidates > 0);
+}
+
+TEST_CASE("Animated tiles get a frame table relative to their clipRect", "[engine][tilemanager]")
+{
+  TileData tileData;
+  tileData.tileType = +TileType::DEFAULT;
+  tileData.tiles.count = 4;
+  tileData.tiles.offset = 2;
+  tileData.tiles.clippingWidth = 32;
+  tileData.tiles.fps = 10;
+
+  SpriteAnimation animation;
+  REQUIRE(TileManager::buildAnimation(tileData, animation));
+  CHECK(animation.frameDuration == 100);
+  // the offset of the tileset is already part of the clipRect
+  CHECK(animation.frameOffset == std::vector<int>{0, 32, 64, 96});
+
+  // the images of autotiles are their orientations
+  tileData.tileType = +TileType::AUTOTILE;
+  CHECK_FALSE(TileManager::buildAnimation(tileData, animation));
+
+  tileData.tileType = +TileType::DEFAULT;
+  tileData.tiles.fps = 0;
+  CHECK_FALSE(TileManager::buildAnimation(tileData, animation));
+}
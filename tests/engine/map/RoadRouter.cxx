@@ -0,0 +1,95 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/map/RoadRouter.hxx"
+
+TEST_CASE("Routes take the shortest path on open terrain", "[engine][map]")
+{
+  RoadRouter router(16, 16);
+  std::vector<Point> route;
+
+  REQUIRE(router.findRoute({2, 3, 0, 0}, {2, 10, 0, 0}, route));
+  CHECK(route.size() == 8);
+  CHECK(route.front() == Point{2, 3, 0, 0});
+  CHECK(route.back() == Point{2, 10, 0, 0});
+  CHECK(router.getRouteCost() == 7 * RoadRouter::StepCost);
+
+  REQUIRE(router.findRoute({5, 5, 0, 0}, {5, 5, 0, 0}, route));
+  CHECK(route.size() == 1);
+}
+
+TEST_CASE("Routes avoid blocked and expensive nodes", "[engine][map]")
+{
+  RoadRouter router(16, 16);
+  std::vector<Point> route;
+
+  // a wall across the map with a gap at the bottom
+  for (int x = 0; x < 15; ++x)
+  {
+    router.setCost(x, 8, RoadRouter::BLOCKED);
+  }
+  REQUIRE(router.findRoute({0, 0, 0, 0}, {0, 15, 0, 0}, route));
+  CHECK(route.size() == 15 + 15 + 15 + 1);
+  for (size_t i = 1; i < route.size(); ++i)
+  {
+    CHECK(std::abs(route[i].x - route[i - 1].x) + std::abs(route[i].y - route[i - 1].y) == 1);
+    CHECK(router.getCost(route[i].x, route[i].y) != RoadRouter::BLOCKED);
+  }
+
+  // demolishing a building is cheaper than the detour
+  router.setCost(0, 8, RoadRouter::DemolishCost);
+  REQUIRE(router.findRoute({0, 0, 0, 0}, {0, 15, 0, 0}, route));
+  CHECK(route.size() == 16);
+  CHECK(router.getRouteCost() == 15 * RoadRouter::StepCost + RoadRouter::DemolishCost);
+
+  // closing the gap makes the end unreachable
+  router.setCost(0, 8, RoadRouter::BLOCKED);
+  router.setCost(15, 8, RoadRouter::BLOCKED);
+  CHECK_FALSE(router.findRoute({0, 0, 0, 0}, {0, 15, 0, 0}, route));
+  CHECK(route.empty());
+  CHECK_FALSE(router.findRoute({0, 0, 0, 0}, {0, 16, 0, 0}, route));
+}
+
+TEST_CASE("Routes go around hills", "[engine][map]")
+{
+  RoadRouter router(16, 16);
+  std::vector<Point> route;
+
+  // a hill in the middle of a straight line, going around it is cheaper than climbing it
+  for (int x = 3; x <= 5; ++x)
+  {
+    for (int y = 6; y <= 8; ++y)
+    {
+      router.setHeight(x, y, 3);
+    }
+  }
+  REQUIRE(router.findRoute({4, 2, 0, 0}, {4, 12, 0, 0}, route));
+  for (const Point &node : route)
+  {
+    CHECK_FALSE((node.x >= 3 && node.x <= 5 && node.y >= 6 && node.y <= 8));
+  }
+  CHECK(router.getRouteCost() == 14 * RoadRouter::StepCost);
+}
+
+TEST_CASE("Routes across a big map", "[engine][map]")
+{
+  const int size = 256;
+  RoadRouter router(size, size);
+  std::vector<Point> route;
+
+  // walls with alternating gaps force a long zigzag route
+  for (int y = 16; y < size; y += 16)
+  {
+    const bool gapAtTop = (y / 16) % 2 == 0;
+    for (int x = 0; x < size; ++x)
+    {
+      if (gapAtTop ? x > 0 : x < size - 1)
+      {
+        router.setCost(x, y, RoadRouter::BLOCKED);
+      }
+    }
+  }
+
+  REQUIRE(router.findRoute({0, 0, 0, 0}, {size - 1, size - 1, 0, 0}, route));
+  CHECK(route.back() == Point{size - 1, size - 1, 0, 0});
+  CHECK(route.size() > static_cast<size_t>(size * 15));
+}
@@ -0,0 +1,96 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/Budget.hxx"
+#include "../../../src/engine/basics/tileData.hxx"
+#include "../../../src/engine/Map.hxx"
+
+namespace
+{
+MapNodeChange createChange(int x, int y, Layer layer, const TileData *oldTileData, const TileData *newTileData)
+{
+  const Point node{x, y, 0, 0};
+  return MapNodeChange{node, layer, oldTileData, newTileData, oldTileData ? node : Point::INVALID(),
+                       newTileData ? node : Point::INVALID()};
+}
+} // namespace
+
+TEST_CASE("The budget charges edits and closes months from running totals", "[engine][simulation]")
+{
+  TileData house;
+  house.tileType = TileType::RCI;
+  house.category = "Residential";
+  house.zones = {Zones::RESIDENTIAL};
+  house.inhabitants = 100;
+  house.water = -1;
+
+  TileData factory = house;
+  factory.category = "Industrial";
+  factory.zones = {Zones::INDUSTRIAL};
+  factory.inhabitants = 50;
+
+  TileData plant;
+  plant.category = "Power";
+  plant.power = 50;
+  plant.price = 1000;
+  plant.upkeepCost = 20;
+
+  TileData road;
+  road.tileType = TileType::AUTOTILE;
+  road.price = 10;
+  road.upkeepCost = 1;
+
+  Budget budget;
+  CHECK(Budget::getUpkeepCategory(Layer::BUILDINGS, house) == Budget::OTHER);
+  CHECK(Budget::getTaxCategory(Layer::BUILDINGS, house) == Budget::RESIDENTIAL_TAX);
+  CHECK(Budget::getTaxCategory(Layer::BUILDINGS, factory) == Budget::INDUSTRIAL_TAX);
+  CHECK(Budget::getUpkeepCategory(Layer::BUILDINGS, plant) == Budget::POWER);
+
+  // the player builds a power plant and a road of 3 nodes, the houses and the factory grow by themselves
+  budget.beginEdit();
+  budget.onNodeChanged(createChange(0, 0, Layer::BUILDINGS, nullptr, &plant));
+  budget.endEdit(5);
+  budget.beginEdit();
+  for (int y = 0; y < 3; ++y)
+  {
+    budget.onNodeChanged(createChange(1, y, Layer::ROAD, nullptr, &road));
+  }
+  // updating the shape of a road doesn't cost anything
+  budget.onNodeChanged(createChange(1, 0, Layer::ROAD, &road, &road));
+  budget.endEdit(5);
+  budget.onNodeChanged(createChange(2, 0, Layer::BUILDINGS, nullptr, &house));
+  budget.onNodeChanged(createChange(2, 1, Layer::BUILDINGS, nullptr, &house));
+  budget.onNodeChanged(createChange(3, 0, Layer::BUILDINGS, nullptr, &factory));
+
+  CHECK(budget.getFunds() == Budget::StartingFunds - 1030);
+  REQUIRE(budget.getLedger().size() == 2);
+  CHECK(budget.getLedger()[1].amount == -30);
+  CHECK(budget.getUpkeep(Budget::POWER) == 20);
+  CHECK(budget.getUpkeep(Budget::ROADS) == 3);
+  CHECK(budget.getTaxBase(Budget::RESIDENTIAL_TAX) == 200);
+  CHECK(budget.getTaxBase(Budget::INDUSTRIAL_TAX) == 50);
+
+  budget.setTaxRate(Budget::INDUSTRIAL_TAX, 100);
+  CHECK(budget.getTaxRate(Budget::INDUSTRIAL_TAX) == Budget::MaxTaxRate);
+  // 200 residents * 7% * 10 + 50 workers * 20% * 10 - 23 upkeep
+  budget.closeMonth(100);
+  CHECK(budget.getFunds() == Budget::StartingFunds - 1030 + 140 + 100 - 23);
+  CHECK(budget.getLastMonth(Budget::CONSTRUCTION) == -1030);
+  CHECK(budget.getLastMonth(Budget::RESIDENTIAL_TAX) == 140);
+  CHECK(budget.getLedger().back().tick == 100);
+
+  // demolishing the plant costs a quarter of its price and stops its upkeep
+  budget.beginEdit();
+  budget.onNodeChanged(createChange(0, 0, Layer::BUILDINGS, &plant, nullptr));
+  budget.endEdit(200);
+  CHECK(budget.getLedger().back().amount == -250);
+  CHECK(budget.getUpkeep(Budget::POWER) == 0);
+
+  // the ledger keeps the newest transactions
+  for (uint32_t month = 0; month < Budget::LedgerSize; ++month)
+  {
+    budget.closeMonth(300 + month);
+  }
+  CHECK(budget.getLedger().size() == Budget::LedgerSize);
+  CHECK(budget.getLedger().back().tick == 300 + Budget::LedgerSize - 1);
+  CHECK(budget.getLedger()[0].tick > 200);
+}
@@ -0,0 +1,136 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/BuildingStore.hxx"
+#include "../../../src/engine/basics/tileData.hxx"
+#include "../../../src/util/ByteStream.hxx"
+
+namespace
+{
+/// Place a building with its origin at (x, y) covering size x size nodes
+void place(BuildingStore &store, int columns, int x, int y, int size, const TileData *tileData)
+{
+  for (int nodeX = x; nodeX < x + size; ++nodeX)
+  {
+    for (int nodeY = y; nodeY < y + size; ++nodeY)
+    {
+      store.setNode(nodeX, nodeY, x * columns + y, tileData);
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Buildings are created and destroyed with their nodes", "[engine][simulation]")
+{
+  const int columns = 16;
+  TileData house;
+  house.tileType = TileType::RCI;
+  house.inhabitants = 6;
+  TileData tower = house;
+  tower.inhabitants = 40;
+
+  BuildingStore store(columns, 16);
+  place(store, columns, 2, 3, 1, &house);
+  place(store, columns, 5, 5, 2, &tower);
+
+  REQUIRE(store.size() == 2);
+  const BuildingId houseId = store.getBuildingAt(2, 3);
+  const BuildingId towerId = store.getBuildingAt(6, 6);
+  CHECK(houseId.isValid());
+  CHECK(store.getBuildingAt(5, 5) == towerId);
+  CHECK(store.getBuildingAt(5, 6) == towerId);
+  CHECK_FALSE(store.getBuildingAt(0, 0).isValid());
+  CHECK(store.getOccupancy()[store.getIndex(towerId)] == 40);
+  CHECK(store.getOrigins()[store.getIndex(towerId)] == 5 * columns + 5);
+
+  // the building only disappears when its last node is cleared
+  place(store, columns, 5, 5, 1, nullptr);
+  CHECK(store.isAlive(towerId));
+  place(store, columns, 5, 5, 2, nullptr);
+  CHECK_FALSE(store.isAlive(towerId));
+  CHECK(store.getIndex(towerId) == -1);
+  CHECK(store.size() == 1);
+  CHECK(store.isAlive(houseId));
+
+  // reusing the slot doesn't revive old handles
+  place(store, columns, 9, 9, 1, &house);
+  const BuildingId newId = store.getBuildingAt(9, 9);
+  CHECK(newId.index == towerId.index);
+  CHECK(newId != towerId);
+  CHECK_FALSE(store.isAlive(towerId));
+}
+
+TEST_CASE("Removing a building keeps the components dense", "[engine][simulation]")
+{
+  const int columns = 8;
+  TileData house;
+  house.tileType = TileType::RCI;
+
+  BuildingStore store(columns, 8);
+  for (int x = 0; x < 4; ++x)
+  {
+    place(store, columns, x, 0, 1, &house);
+    store.getAge()[x] = x * 10;
+  }
+
+  const BuildingId lastId = store.getBuildingAt(3, 0);
+  place(store, columns, 1, 0, 1, nullptr);
+
+  REQUIRE(store.size() == 3);
+  const int index = store.getIndex(lastId);
+  CHECK(index == 1);
+  CHECK(store.getId(index) == lastId);
+  CHECK(store.getAge()[index] == 30);
+  CHECK(store.getOrigins()[index] == 3 * columns);
+}
+
+TEST_CASE("Replacing a building at the same origin creates a new building", "[engine][simulation]")
+{
+  const int columns = 8;
+  TileData small;
+  small.tileType = TileType::RCI;
+  TileData big = small;
+
+  BuildingStore store(columns, 8);
+  place(store, columns, 2, 2, 2, &small);
+  const BuildingId smallId = store.getBuildingAt(2, 2);
+  store.getAge()[store.getIndex(smallId)] = 100;
+
+  // the new building can be announced before the rest of the old one has been cleared
+  place(store, columns, 2, 2, 2, &big);
+  CHECK_FALSE(store.isAlive(smallId));
+  REQUIRE(store.size() == 1);
+  CHECK(store.getTileData()[0] == &big);
+  CHECK(store.getAge()[0] == 0);
+}
+
+TEST_CASE("The ages of the buildings are restored by their origin", "[engine][simulation]")
+{
+  const int columns = 8;
+  TileData house;
+  house.tileType = TileType::RCI;
+
+  BuildingStore store(columns, 8);
+  place(store, columns, 1, 1, 1, &house);
+  place(store, columns, 4, 4, 2, &house);
+  store.getAge()[store.getIndex(store.getBuildingAt(1, 1))] = 12;
+  store.getAge()[store.getIndex(store.getBuildingAt(4, 4))] = 345;
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer);
+  store.save(writer);
+
+  // the map is placed in a different order when it is loaded, a building that is gone is skipped
+  BuildingStore loaded(columns, 8);
+  place(loaded, columns, 4, 4, 2, &house);
+  place(loaded, columns, 6, 0, 1, &house);
+  ByteReader reader(buffer);
+  loaded.load(reader);
+  CHECK(reader.atEnd());
+  CHECK(loaded.getAge()[loaded.getIndex(loaded.getBuildingAt(4, 4))] == 345);
+  CHECK(loaded.getAge()[loaded.getIndex(loaded.getBuildingAt(6, 0))] == 0);
+
+  // truncated data leaves the ages untouched
+  buffer.pop_back();
+  ByteReader truncated(buffer);
+  CHECK_THROWS(loaded.load(truncated));
+  CHECK(loaded.getAge()[loaded.getIndex(loaded.getBuildingAt(4, 4))] == 345);
+}
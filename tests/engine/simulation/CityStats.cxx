@@ -0,0 +1,60 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/CityStats.hxx"
+#include "../../../src/engine/basics/tileData.hxx"
+
+TEST_CASE("City statistics follow placed and demolished tiles", "[engine][simulation]")
+{
+  TileData house;
+  house.tileType = TileType::RCI;
+  house.category = "Residential";
+  house.zones = {Zones::RESIDENTIAL};
+  house.inhabitants = 6;
+  house.power = -2;
+  house.water = -1;
+
+  TileData shop = house;
+  shop.category = "Commercial";
+  shop.zones = {Zones::COMMERCIAL};
+  shop.inhabitants = 4;
+
+  TileData plant;
+  plant.category = "Power";
+  plant.power = 50;
+  plant.upkeepCost = 20;
+
+  TileData road;
+  road.tileType = TileType::ROAD;
+  road.upkeepCost = 1;
+
+  CityStats stats;
+  stats.addTile(Layer::BUILDINGS, house, 1);
+  stats.addTile(Layer::BUILDINGS, house, 1);
+  stats.addTile(Layer::BUILDINGS, shop, 1);
+  stats.addTile(Layer::BUILDINGS, plant, 1);
+  stats.addTile(Layer::ROAD, road, 1);
+
+  CHECK(stats.getPopulation() == 12);
+  CHECK(stats.getJobs() == 4);
+  CHECK(stats.getUpkeep() == 21);
+  CHECK(stats.getPowerProduction() == 50);
+  CHECK(stats.getPowerConsumption() == 6);
+  CHECK(stats.getWaterConsumption() == 3);
+  CHECK(stats.getBuildingCount() == 4);
+  CHECK(stats.getBuildingCount("Residential") == 2);
+
+  WHEN("Buildings are demolished")
+  {
+    CityStats expected = stats;
+    stats.addTile(Layer::BUILDINGS, house, -1);
+    expected.addTile(Layer::BUILDINGS, house, -1);
+    stats.addTile(Layer::BUILDINGS, shop, -1);
+
+    CHECK(stats.getPopulation() == 6);
+    CHECK(stats.getBuildingCount("Commercial") == 0);
+    CHECK(stats != expected);
+
+    expected.addTile(Layer::BUILDINGS, shop, -1);
+    CHECK(stats == expected);
+  }
+}
@@ -0,0 +1,119 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/CommandLog.hxx"
+
+namespace
+{
+MapCommand createCommand(uint32_t tick, MapCommand::Type type)
+{
+  MapCommand command;
+  command.tick = tick;
+  command.type = type;
+  return command;
+}
+
+void checkEqual(const MapCommand &command, const MapCommand &other)
+{
+  CHECK(command.tick == other.tick);
+  CHECK(command.type == other.type);
+  CHECK(command.tileID == other.tileID);
+  CHECK(command.nodes == other.nodes);
+  CHECK(command.layer == other.layer);
+  CHECK(command.updateNeighbors == other.updateNeighbors);
+  CHECK(command.cameraX == other.cameraX);
+  CHECK(command.cameraY == other.cameraY);
+  CHECK(command.value == other.value);
+}
+} // namespace
+
+TEST_CASE("Command logs survive a binary round trip", "[engine][simulation]")
+{
+  CommandLog log;
+  log.reset(0x123456789ABCDEF);
+  log.setStart({"resources/save.cts", 128, 96, -42});
+
+  MapCommand road = createCommand(3, MapCommand::PLACE);
+  road.tileID = "road";
+  for (int x = 10; x < 40; ++x)
+  {
+    road.nodes.push_back(Point{x, 20, 0, 0});
+  }
+  log.record(road);
+  MapCommand house = createCommand(3, MapCommand::PLACE_OBJECT);
+  house.tileID = "house";
+  house.nodes = {Point{5, 5, 0, 0}, Point{5, 4, 0, 0}, Point{4, 5, 0, 0}, Point{4, 4, 0, 0}};
+  log.record(house);
+  MapCommand moreRoad = road;
+  moreRoad.tick = 70;
+  moreRoad.nodes = {Point{0, 0, 0, 0}};
+  log.record(moreRoad);
+  MapCommand demolish = createCommand(80, MapCommand::DEMOLISH);
+  demolish.layer = Layer::ROAD;
+  demolish.updateNeighbors = true;
+  demolish.nodes = {Point{12, 20, 0, 0}};
+  log.record(demolish);
+  MapCommand raise = createCommand(80, MapCommand::RAISE_TERRAIN);
+  raise.nodes = {Point{60, 90, 0, 0}};
+  log.record(raise);
+  MapCommand camera = createCommand(81, MapCommand::CAMERA);
+  camera.cameraX = -300;
+  camera.cameraY = 1200;
+  camera.value = 1.5F;
+  log.record(camera);
+  MapCommand speed = createCommand(1000, MapCommand::SPEED);
+  speed.value = 4.0F;
+  log.record(speed);
+  log.setEnd(1234, 0xFEDCBA9876543210);
+
+  std::vector<uint8_t> buffer;
+  log.save(buffer);
+  // the ticks, the coordinates and the repeated tileID are stored compactly
+  CHECK(buffer.size() < 200);
+
+  CommandLog loaded;
+  loaded.load(buffer);
+  CHECK(loaded.getSeed() == log.getSeed());
+  CHECK(loaded.getStart().saveGame == "resources/save.cts");
+  CHECK(loaded.getStart().columns == 128);
+  CHECK(loaded.getStart().rows == 96);
+  CHECK(loaded.getStart().terrainSeed == -42);
+  CHECK(loaded.getEndTick() == 1234);
+  CHECK(loaded.getEndHash() == 0xFEDCBA9876543210);
+  REQUIRE(loaded.getCommands().size() == log.getCommands().size());
+  for (size_t i = 0; i < log.getCommands().size(); ++i)
+  {
+    checkEqual(loaded.getCommands()[i], log.getCommands()[i]);
+  }
+
+  buffer.pop_back();
+  CHECK_THROWS(loaded.load(buffer));
+  // a failed load keeps the log
+  CHECK(loaded.getCommands().size() == log.getCommands().size());
+  CHECK_THROWS(loaded.load({1, 2, 3}));
+}
+
+TEST_CASE("Only the last view change of a tick is recorded", "[engine][simulation]")
+{
+  CommandLog log;
+  MapCommand camera = createCommand(5, MapCommand::CAMERA);
+  for (int x = 0; x < 10; ++x)
+  {
+    camera.cameraX = x;
+    log.record(camera);
+  }
+  REQUIRE(log.getCommands().size() == 1);
+  CHECK(log.getCommands().back().cameraX == 9);
+
+  log.record(createCommand(5, MapCommand::SPEED));
+  camera.tick = 6;
+  log.record(camera);
+  camera.cameraX = 20;
+  log.record(camera);
+  CHECK(log.getCommands().size() == 3);
+  CHECK(log.getCommands().back().cameraX == 20);
+
+  // edits are never merged
+  log.record(createCommand(6, MapCommand::DEMOLISH));
+  log.record(createCommand(6, MapCommand::DEMOLISH));
+  CHECK(log.getCommands().size() == 5);
+}
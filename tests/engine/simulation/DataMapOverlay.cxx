@@ -0,0 +1,39 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/DataMapOverlay.hxx"
+
+TEST_CASE("Color ramps interpolate between their stops", "[engine][simulation]")
+{
+  const SDL_Color black = DataMapOverlay::getColor(DataMapOverlay::GRAYSCALE, 0.f);
+  const SDL_Color gray = DataMapOverlay::getColor(DataMapOverlay::GRAYSCALE, 0.5f);
+  const SDL_Color white = DataMapOverlay::getColor(DataMapOverlay::GRAYSCALE, 2.f);
+  CHECK(black.r == 0);
+  CHECK(gray.r == 128);
+  CHECK(white.r == 255);
+  CHECK(gray.a == white.a);
+
+  const SDL_Color low = DataMapOverlay::getColor(DataMapOverlay::HEAT, 0.f);
+  const SDL_Color high = DataMapOverlay::getColor(DataMapOverlay::HEAT, 1.f);
+  CHECK(low.b > low.r);
+  CHECK(high.r > high.b);
+
+  CHECK(DataMapOverlay::getColor(DataMapOverlay::GREEN_RED, DataMapOverlay::NO_DATA).a == 0);
+}
+
+TEST_CASE("The overlay colors the nodes with data", "[engine][simulation]")
+{
+  DataMapOverlay overlay(4, 4);
+  overlay.setDataMap(DataMapOverlay::POLLUTION);
+  std::vector<float> values(16, DataMapOverlay::NO_DATA);
+  values[1 * 4 + 2] = 0.75f;
+  overlay.setValues(values);
+  CHECK(overlay.getNodeColor(0, 0).a == 0);
+  CHECK(overlay.getNodeColor(1, 2).r == DataMapOverlay::getColor(DataMapOverlay::HEAT, 0.75f).r);
+
+  overlay.setColorRamp(DataMapOverlay::GRAYSCALE);
+  CHECK(overlay.getNodeColor(1, 2).r == DataMapOverlay::getColor(DataMapOverlay::GRAYSCALE, 0.75f).r);
+
+  // the values of another data map are cleared
+  overlay.setDataMap(DataMapOverlay::CRIME);
+  CHECK(overlay.getNodeColor(1, 2).a == 0);
+}
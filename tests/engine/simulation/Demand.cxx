@@ -0,0 +1,72 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/Demand.hxx"
+
+namespace
+{
+TileData createBuilding(Zones zone, int inhabitants)
+{
+  TileData tileData;
+  tileData.tileType = TileType::RCI;
+  tileData.zones = {zone};
+  tileData.inhabitants = inhabitants;
+  return tileData;
+}
+} // namespace
+
+TEST_CASE("Demand follows the incremental supply counters", "[engine][simulation]")
+{
+  const TileData house = createBuilding(Zones::RESIDENTIAL, 20);
+  const TileData shop = createBuilding(Zones::COMMERCIAL, 10);
+  const TileData farm = createBuilding(Zones::AGRICULTURAL, 30);
+
+  Demand demand(64, 64);
+  demand.resetAverage();
+  // an empty city wants residents and industry, shops need customers first
+  CHECK(demand.getDemand(Demand::RESIDENTIAL) > 0.f);
+  CHECK(demand.getDemand(Demand::INDUSTRIAL) > 0.f);
+  CHECK(demand.getSpawnWeight(Demand::COMMERCIAL) == 0.f);
+
+  for (int i = 0; i < 10; ++i)
+  {
+    demand.addBuilding(i, 0, house, 1);
+  }
+  CHECK(demand.getHousing() == 200);
+  CHECK(demand.getInstantDemand(Demand::RESIDENTIAL) < 0.f);
+  CHECK(demand.getInstantDemand(Demand::COMMERCIAL) > 0.f);
+  CHECK(demand.getInstantDemand(Demand::INDUSTRIAL) > 0.f);
+
+  // a shop reaches the houses in its own and the neighboring chunks only
+  demand.addBuilding(60, 60, shop, 1);
+  CHECK(demand.getCustomersInReach() == 0);
+  demand.addBuilding(20, 10, shop, 1);
+  CHECK(demand.getCustomersInReach() == 200);
+  demand.addBuilding(50, 0, house, 1);
+  CHECK(demand.getCustomersInReach() == 200);
+  demand.addBuilding(20, 10, shop, -1);
+  CHECK(demand.getCustomersInReach() == 0);
+  CHECK(demand.getJobs(Demand::COMMERCIAL) == 10);
+
+  demand.addBuilding(30, 30, farm, 1);
+  demand.addBuilding(31, 30, farm, 1);
+  CHECK(demand.getJobs(Demand::INDUSTRIAL) == 60);
+  CHECK(demand.getJobs() == 70);
+
+  // the moving average approaches the demand of the day
+  const float target = demand.getInstantDemand(Demand::RESIDENTIAL);
+  const float before = demand.getDemand(Demand::RESIDENTIAL);
+  demand.updateDay();
+  const float after = demand.getDemand(Demand::RESIDENTIAL);
+  CHECK(std::abs(after - target) < std::abs(before - target));
+  for (int day = 0; day < 100; ++day)
+  {
+    demand.updateDay();
+  }
+  CHECK(demand.getDemand(Demand::RESIDENTIAL) == Approx(target).margin(1e-4));
+
+  for (unsigned int zone = 0; zone < Demand::ZONES_COUNT; ++zone)
+  {
+    CHECK(demand.getDemand(static_cast<Demand::Zone>(zone)) >= -1.f);
+    CHECK(demand.getDemand(static_cast<Demand::Zone>(zone)) <= 1.f);
+  }
+}
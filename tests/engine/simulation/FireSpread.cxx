@@ -0,0 +1,97 @@
+#include <catch.hpp>
+#include <vector>
+
+#include "../../../src/engine/simulation/FireSpread.hxx"
+
+namespace
+{
+FireSpread createForest(int size, uint32_t seed)
+{
+  FireSpread fire(size, size, seed);
+  for (int x = 0; x < size; ++x)
+  {
+    for (int y = 0; y < size; ++y)
+    {
+      fire.setFlammability(x, y, 200);
+    }
+  }
+  return fire;
+}
+
+std::vector<Point> burnDown(FireSpread &fire, int steps)
+{
+  std::vector<Point> burntOut;
+  for (int step = 0; step < steps; ++step)
+  {
+    fire.step();
+    burntOut.insert(burntOut.end(), fire.getBurntOutNodes().begin(), fire.getBurntOutNodes().end());
+    fire.clearBurntOutNodes();
+  }
+  return burntOut;
+}
+} // namespace
+
+TEST_CASE("Fires spread to flammable neighbors and burn out", "[engine][simulation]")
+{
+  FireSpread fire = createForest(64, 1);
+  // a firebreak at y = 40
+  for (int x = 0; x < 64; ++x)
+  {
+    fire.setFlammability(x, 40, 0);
+  }
+
+  fire.ignite(20, 20);
+  CHECK(fire.isBurning(20, 20));
+  const std::vector<Point> burntOut = burnDown(fire, 400);
+
+  std::vector<Point> burning;
+  fire.getBurningNodes(burning);
+  CHECK(burning.empty());
+  CHECK(burntOut.size() > 500);
+  for (const Point &node : burntOut)
+  {
+    CHECK(node.y < 40);
+  }
+
+  // burnt out nodes don't burn again
+  fire.ignite(20, 20);
+  CHECK_FALSE(fire.isBurning(20, 20));
+}
+
+TEST_CASE("Fire spread is deterministic for a seed", "[engine][simulation]")
+{
+  FireSpread first = createForest(48, 7);
+  FireSpread second = createForest(48, 7);
+  FireSpread other = createForest(48, 8);
+  first.ignite(10, 10);
+  second.ignite(10, 10);
+  other.ignite(10, 10);
+
+  const std::vector<Point> firstBurntOut = burnDown(first, 30);
+  const std::vector<Point> secondBurntOut = burnDown(second, 30);
+  const std::vector<Point> otherBurntOut = burnDown(other, 30);
+
+  REQUIRE(firstBurntOut.size() == secondBurntOut.size());
+  for (size_t i = 0; i < firstBurntOut.size(); ++i)
+  {
+    CHECK(firstBurntOut[i] == secondBurntOut[i]);
+  }
+  CHECK(firstBurntOut.size() != otherBurntOut.size());
+}
+
+TEST_CASE("Fire stations suppress fires", "[engine][simulation]")
+{
+  FireSpread fire = createForest(32, 3);
+  for (int x = 0; x < 32; ++x)
+  {
+    for (int y = 0; y < 32; ++y)
+    {
+      fire.setSuppression(x, y, 255);
+    }
+  }
+
+  fire.ignite(16, 16);
+  const std::vector<Point> burntOut = burnDown(fire, 50);
+  REQUIRE(burntOut.size() == 1);
+  CHECK(fire.getProcessedChunkCount() == 0);
+}
@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/InfluenceFields.hxx"
+
+TEST_CASE("Influence falls off around a building", "[engine][simulation]")
+{
+  InfluenceFields fields(64, 64);
+  fields.addSource(32, 32, InfluenceFields::POLLUTION, 40);
+  fields.update();
+
+  const int reach = InfluenceFields::BlurPasses * InfluenceFields::getRadius(InfluenceFields::POLLUTION);
+
+  CHECK(fields.getValue(InfluenceFields::POLLUTION, 32, 32) == Approx(40).margin(0.1));
+  CHECK(fields.getValue(InfluenceFields::POLLUTION, 34, 32) < fields.getValue(InfluenceFields::POLLUTION, 33, 32));
+  CHECK(fields.getValue(InfluenceFields::POLLUTION, 32, 30) == fields.getValue(InfluenceFields::POLLUTION, 32, 34));
+  CHECK(fields.getValue(InfluenceFields::POLLUTION, 32 + reach + 1, 32) == 0);
+  CHECK(fields.getValue(InfluenceFields::CRIME, 32, 32) == 0);
+}
+
+TEST_CASE("Incremental updates match a full computation", "[engine][simulation]")
+{
+  InfluenceFields incremental(80, 80);
+  incremental.addSource(10, 10, InfluenceFields::HAPPINESS, 20);
+  incremental.addSource(15, 60, InfluenceFields::HAPPINESS, -12);
+  incremental.addSource(70, 40, InfluenceFields::HAPPINESS, 30);
+  incremental.update();
+
+  WHEN("A building is removed and another one is placed")
+  {
+    const size_t blurredBefore = incremental.getBlurredTileCount();
+    incremental.addSource(70, 40, InfluenceFields::HAPPINESS, -30);
+    incremental.addSource(72, 45, InfluenceFields::HAPPINESS, 8);
+    incremental.update();
+
+    InfluenceFields full(80, 80);
+    full.addSource(10, 10, InfluenceFields::HAPPINESS, 20);
+    full.addSource(15, 60, InfluenceFields::HAPPINESS, -12);
+    full.addSource(72, 45, InfluenceFields::HAPPINESS, 8);
+    full.update();
+
+    THEN("Only the nearby tiles are blurred and the result is the same")
+    {
+      CHECK(incremental.getBlurredTileCount() - blurredBefore < 25);
+      CHECK(incremental.getField(InfluenceFields::HAPPINESS) == full.getField(InfluenceFields::HAPPINESS));
+      CHECK(incremental.getValue(InfluenceFields::HAPPINESS, 15, 60) < 0);
+    }
+  }
+}
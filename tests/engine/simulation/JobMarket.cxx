@@ -0,0 +1,109 @@
+#include <catch.hpp>
+#include <cstdlib>
+
+#include "../../../src/engine/simulation/JobMarket.hxx"
+
+TEST_CASE("Residents take the closest jobs first", "[engine][simulation]")
+{
+  JobMarket market(64, 64);
+  market.addHousing(10, 10, 10, 0);
+  market.addWorkplace(12, 10, 4, 0);
+  market.addWorkplace(50, 50, 20, 0);
+  market.update();
+
+  CHECK(market.getResidents() == 10);
+  CHECK(market.getJobs() == 24);
+  CHECK(market.getEmployed() == 10);
+  CHECK(market.getFilledJobs(12, 10) == 4);
+  CHECK(market.getFilledJobs(50, 50) == 6);
+  CHECK(market.getEmploymentRate() == Approx(1.f));
+  CHECK(market.getAverageCommute() == Approx((4 * 2 + 6 * 80) / 10.f));
+}
+
+TEST_CASE("Residents need enough education for their jobs", "[engine][simulation]")
+{
+  JobMarket market(32, 32);
+  market.addHousing(0, 0, 5, 0);
+  market.addHousing(0, 1, 5, 2);
+  market.addWorkplace(1, 0, 8, 2);
+  market.update();
+
+  CHECK(market.getEmployed(0, 0) == 0);
+  CHECK(market.getEmployed(0, 1) == 5);
+  CHECK(market.getEmploymentRate() == Approx(0.5f));
+}
+
+TEST_CASE("Removing buildings rebalances the matches", "[engine][simulation]")
+{
+  JobMarket market(64, 64);
+  market.addHousing(5, 5, 6, 0);
+  market.addHousing(40, 40, 6, 0);
+  market.addWorkplace(6, 5, 6, 0);
+  market.update();
+  REQUIRE(market.getEmployed() == 6);
+  CHECK(market.getEmployed(5, 5) == 6);
+
+  // the freed jobs go to the other housing
+  market.removeHousing(5, 5);
+  CHECK(market.getEmployed() == 0);
+  market.update();
+  CHECK(market.getEmployed(40, 40) == 6);
+
+  // the residents find new jobs when their workplace closes
+  market.addWorkplace(45, 45, 6, 0);
+  market.update();
+  market.removeWorkplace(6, 5);
+  CHECK(market.getEmployed() == 0);
+  market.update();
+  CHECK(market.getEmployed(40, 40) == 6);
+  CHECK(market.getFilledJobs(45, 45) == 6);
+  CHECK(market.getAverageCommute() == Approx(10.f));
+}
+
+TEST_CASE("Unreachable jobs are not taken", "[engine][simulation]")
+{
+  JobMarket market(32, 32);
+  market.setCommuteFunction([](const Point &, const Point &to) { return to.x > 20 ? JobMarket::UNREACHABLE : 1; });
+  market.addHousing(0, 0, 4, 0);
+  market.addWorkplace(25, 0, 4, 0);
+  market.update();
+  CHECK(market.getEmployed() == 0);
+
+  market.addWorkplace(10, 0, 2, 0);
+  market.update();
+  CHECK(market.getEmployed() == 2);
+  CHECK(market.getAverageCommute() == Approx(1.f));
+}
+
+TEST_CASE("Unemployed residents only look at the new jobs", "[engine][simulation]")
+{
+  JobMarket market(64, 64);
+  // two parts of the city that aren't connected to each other
+  int commutes = 0;
+  market.setCommuteFunction([&commutes](const Point &from, const Point &to) {
+    ++commutes;
+    if ((from.x < 32) != (to.x < 32))
+    {
+      return JobMarket::UNREACHABLE;
+    }
+    return std::abs(from.x - to.x) + std::abs(from.y - to.y);
+  });
+  market.addHousing(0, 0, 5, 0);
+  market.addHousing(40, 40, 5, 0);
+  market.addWorkplace(1, 0, 5, 0);
+  market.update();
+  REQUIRE(market.getEmployed(0, 0) == 5);
+  REQUIRE(market.getEmployed(40, 40) == 0);
+
+  // the full workplace isn't measured again
+  commutes = 0;
+  market.addWorkplace(2, 0, 3, 0);
+  market.update();
+  CHECK(commutes == 1);
+  CHECK(market.getEmployed(40, 40) == 0);
+
+  market.addWorkplace(45, 45, 3, 0);
+  market.update();
+  CHECK(market.getEmployed(40, 40) == 3);
+  CHECK(market.getFilledJobs(45, 45) == 3);
+}
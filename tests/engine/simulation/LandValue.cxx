@@ -0,0 +1,85 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/InfluenceFields.hxx"
+#include "../../../src/engine/simulation/LandValue.hxx"
+#include "../../../src/engine/simulation/RoadNetwork.hxx"
+#include "../../../src/engine/simulation/ServiceCoverage.hxx"
+
+TEST_CASE("Land value combines its factors", "[engine][simulation]")
+{
+  InfluenceFields fields(64, 64);
+  RoadNetwork roads(64, 64);
+  ServiceCoverage coverage(roads, 64, 64);
+  LandValue landValue(fields, coverage, 64, 64);
+
+  landValue.update();
+  CHECK(landValue.getUpdatedChunks().size() == 16);
+  CHECK(landValue.getValue(5, 5) == LandValue::BaseValue);
+  CHECK(landValue.getValue(63, 63) == LandValue::BaseValue);
+
+  // nothing changed, nothing to recompute
+  landValue.update();
+  CHECK(landValue.getUpdatedChunks().empty());
+
+  SECTION("Water raises the value of its surroundings")
+  {
+    landValue.setWater(10, 10, true);
+    landValue.update();
+
+    CHECK(landValue.getValue(10, 11) ==
+          LandValue::BaseValue + landValue.getWeight(LandValue::WATER) * (LandValue::WaterRange - 1) / LandValue::WaterRange);
+    CHECK(landValue.getValue(12, 12) > landValue.getValue(14, 14));
+    CHECK(landValue.getValue(10, 10 + LandValue::WaterRange) == LandValue::BaseValue);
+    // the water reaches into the neighboring chunks, but not into the diagonal one
+    CHECK(landValue.getUpdatedChunks().size() == 3);
+
+    landValue.setWeight(LandValue::WATER, 0);
+    landValue.update();
+    CHECK(landValue.getValue(10, 11) == LandValue::BaseValue);
+  }
+
+  SECTION("Pollution lowers the value of its surroundings")
+  {
+    fields.addSource(40, 40, InfluenceFields::POLLUTION, 10);
+    fields.update();
+    for (int tile : fields.getUpdatedTiles())
+    {
+      const int x = (tile / fields.getTileColumns()) * InfluenceFields::TileSize;
+      const int y = (tile % fields.getTileColumns()) * InfluenceFields::TileSize;
+      landValue.markDirty(x, y, x + InfluenceFields::TileSize - 1, y + InfluenceFields::TileSize - 1);
+    }
+    landValue.update();
+
+    CHECK(landValue.getValue(40, 40) < LandValue::BaseValue);
+    CHECK(landValue.getValue(40, 40) < landValue.getValue(40, 44));
+    CHECK(landValue.getValue(5, 5) == LandValue::BaseValue);
+    CHECK(landValue.getUpdatedChunks().size() == fields.getUpdatedTiles().size());
+  }
+
+  SECTION("Services raise the value of the nodes they cover")
+  {
+    for (int y = 0; y < 64; ++y)
+    {
+      roads.setRoad(10, y, true);
+      coverage.onRoadChanged(10, y);
+    }
+    coverage.setStation(11, 0, ServiceCoverage::POLICE, true);
+    coverage.update();
+    landValue.markAllDirty();
+    landValue.update();
+
+    CHECK(landValue.getValue(11, 0) > landValue.getValue(11, 10));
+    CHECK(landValue.getValue(11, 10) > LandValue::BaseValue);
+    CHECK(landValue.getValue(30, 10) == LandValue::BaseValue);
+  }
+}
+
+TEST_CASE("Land value selects the wealth", "[engine][simulation]")
+{
+  CHECK(LandValue::getWealth(0) == +Wealth::LOW);
+  CHECK(LandValue::getWealth(LandValue::MediumWealthValue - 1) == +Wealth::LOW);
+  CHECK(LandValue::getWealth(LandValue::MediumWealthValue) == +Wealth::MEDIUM);
+  CHECK(LandValue::getWealth(LandValue::BaseValue) == +Wealth::MEDIUM);
+  CHECK(LandValue::getWealth(LandValue::HighWealthValue) == +Wealth::HIGH);
+  CHECK(LandValue::getWealth(255) == +Wealth::HIGH);
+}
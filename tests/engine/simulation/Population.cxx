@@ -0,0 +1,89 @@
+#include <catch.hpp>
+#include <cmath>
+#include <vector>
+
+#include "../../../src/engine/simulation/Population.hxx"
+#include "../../../src/util/ByteStream.hxx"
+
+namespace
+{
+/// Sum the cohorts of all chunks, the totals must follow them without a recount
+double countResidents(const Population &population)
+{
+  double residents = 0;
+  for (int chunkX = 0; chunkX < population.getChunkRows(); ++chunkX)
+  {
+    for (int chunkY = 0; chunkY < population.getChunkColumns(); ++chunkY)
+    {
+      for (unsigned int band = 0; band < Population::AGE_BANDS_COUNT; ++band)
+      {
+        for (unsigned int tier = 0; tier < Population::EducationTiers; ++tier)
+        {
+          residents += population.getResidents(chunkX, chunkY, static_cast<Population::AgeBand>(band), tier);
+        }
+      }
+    }
+  }
+  return residents;
+}
+} // namespace
+
+TEST_CASE("Residents move in, age and move out with their housing", "[engine][simulation]")
+{
+  Population population(64, 64);
+  population.addHousing(5, 5, 400, 1);
+  population.addHousing(40, 40, 200, 1);
+  CHECK(population.getCapacity() == 600);
+  CHECK(population.getResidents() == 0);
+
+  population.settle();
+  CHECK(population.getResidents() == 600);
+  CHECK(population.getWorkforce() > population.getResidents(Population::PUPILS));
+
+  // a full city doesn't grow, but its residents get older and better educated
+  const int seniors = population.getResidents(Population::SENIORS);
+  const int graduates = population.getEducated(3);
+  population.setAttractiveness(1.f);
+  population.setEducation(0, 0, 1.f);
+  for (int month = 0; month < 24; ++month)
+  {
+    population.updateMonth();
+    CHECK(population.getResidents() <= 600);
+  }
+  CHECK(population.getResidents() > 590);
+  CHECK(population.getResidents(Population::SENIORS) > seniors);
+  CHECK(population.getEducated(3) > graduates);
+  CHECK(std::abs(countResidents(population) - population.getResidents()) < 1.0);
+
+  // the residents of demolished housing leave with the next update
+  population.addHousing(40, 40, 200, -1);
+  population.updateMonth();
+  CHECK(population.getResidents(2, 2, Population::ADULTS, 1) == 0.f);
+  CHECK(population.getResidents() <= 400);
+  CHECK(std::abs(countResidents(population) - population.getResidents()) < 1.0);
+
+  SECTION("Empty housing fills up while the city is attractive")
+  {
+    population.addHousing(20, 20, 100, 1);
+    const int before = population.getResidents();
+    population.updateMonth();
+    CHECK(population.getResidents() > before);
+  }
+
+  SECTION("Residents survive a round trip")
+  {
+    std::vector<uint8_t> buffer;
+    ByteWriter writer(buffer);
+    population.save(writer);
+
+    Population loaded(64, 64);
+    ByteReader reader(buffer);
+    loaded.load(reader);
+    CHECK(loaded.getResidents() == population.getResidents());
+    CHECK(loaded.getResidents(0, 0, Population::ADULTS, 2) == population.getResidents(0, 0, Population::ADULTS, 2));
+
+    Population smaller(32, 32);
+    ByteReader mismatch(buffer);
+    REQUIRE_THROWS_AS(smaller.load(mismatch), CytopiaError);
+  }
+}
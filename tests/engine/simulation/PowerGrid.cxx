@@ -0,0 +1,78 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/PowerGrid.hxx"
+
+TEST_CASE("Power is distributed within connected components", "[engine][simulation]")
+{
+  GIVEN("A power plant connected to a consumer by a power line")
+  {
+    PowerGrid grid(8, 8);
+    grid.setNode(0, 0, true, 100);
+    grid.setNode(1, 0, true, 0);
+    grid.setNode(2, 0, true, 0);
+    grid.setNode(3, 0, true, -40);
+    grid.setNode(6, 6, true, -10);
+    grid.update();
+
+    THEN("Only the connected consumer is powered")
+    {
+      CHECK(grid.isPowered(3, 0));
+      CHECK(grid.getSupply(3, 0) == 100);
+      CHECK(grid.getDemand(3, 0) == 40);
+      CHECK_FALSE(grid.isPowered(6, 6));
+    }
+
+    WHEN("The power line is cut")
+    {
+      grid.setNode(2, 0, false, 0);
+      grid.update();
+
+      THEN("The consumer loses its power")
+      {
+        CHECK_FALSE(grid.isPowered(3, 0));
+        CHECK_FALSE(grid.isPowered(2, 0));
+        CHECK(grid.isPowered(1, 0));
+        CHECK(grid.getDemand(0, 0) == 0);
+      }
+
+      AND_WHEN("The power line is placed again")
+      {
+        grid.setNode(2, 0, true, 0);
+        grid.update();
+
+        THEN("The consumer is powered again")
+        {
+          CHECK(grid.isPowered(3, 0));
+          CHECK(grid.getDemand(0, 0) == 40);
+        }
+      }
+    }
+
+    WHEN("The demand exceeds the supply")
+    {
+      grid.setNode(3, 0, true, -150);
+      grid.update();
+
+      THEN("The whole component is unpowered")
+      {
+        CHECK_FALSE(grid.isPowered(0, 0));
+        CHECK_FALSE(grid.isPowered(3, 0));
+      }
+    }
+  }
+}
+
+TEST_CASE("The power grid version only changes with the network", "[engine][simulation]")
+{
+  PowerGrid grid(8, 8);
+  grid.setNode(0, 0, true, 100);
+  grid.update();
+  const unsigned int version = grid.getVersion();
+
+  grid.update();
+  CHECK(grid.getVersion() == version);
+
+  grid.setNode(1, 0, true, -10);
+  grid.update();
+  CHECK(grid.getVersion() != version);
+}
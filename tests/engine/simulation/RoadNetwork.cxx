@@ -0,0 +1,180 @@
+#include <catch.hpp>
+#include <chrono>
+#include <deque>
+#include <random>
+
+#include "../../../src/engine/simulation/RoadNetwork.hxx"
+#include "LOG.hxx"
+
+namespace
+{
+/// reference distance by a breadth first search over the road nodes
+int bfsDistance(const RoadNetwork &roads, int size, Point from, Point to)
+{
+  if (!roads.isRoad(from.x, from.y) || !roads.isRoad(to.x, to.y))
+  {
+    return RoadNetwork::UNREACHABLE;
+  }
+
+  std::vector<int> distance(size * size, RoadNetwork::UNREACHABLE);
+  std::deque<Point> queue{from};
+  distance[from.x * size + from.y] = 0;
+
+  while (!queue.empty())
+  {
+    const Point p = queue.front();
+    queue.pop_front();
+    if (p == to)
+    {
+      return distance[p.x * size + p.y];
+    }
+    for (Point n : {Point{p.x - 1, p.y, 0, 0}, Point{p.x + 1, p.y, 0, 0}, Point{p.x, p.y - 1, 0, 0}, Point{p.x, p.y + 1, 0, 0}})
+    {
+      if (n.x >= 0 && n.x < size && n.y >= 0 && n.y < size && roads.isRoad(n.x, n.y) &&
+          distance[n.x * size + n.y] == RoadNetwork::UNREACHABLE)
+      {
+        distance[n.x * size + n.y] = distance[p.x * size + p.y] + 1;
+        queue.push_back(n);
+      }
+    }
+  }
+  return RoadNetwork::UNREACHABLE;
+}
+
+/// roads on every 4th row and column
+void buildGrid(RoadNetwork &roads, int size)
+{
+  for (int x = 0; x < size; ++x)
+  {
+    for (int y = 0; y < size; ++y)
+    {
+      if (x % 4 == 0 || y % 4 == 0)
+      {
+        roads.setRoad(x, y, true);
+      }
+    }
+  }
+}
+} // namespace
+
+TEST_CASE("Road segments are collapsed into edges", "[engine][simulation]")
+{
+  RoadNetwork roads(16, 16);
+
+  // a T-junction
+  for (int y = 0; y < 10; ++y)
+  {
+    roads.setRoad(5, y, true);
+  }
+  for (int x = 6; x < 10; ++x)
+  {
+    roads.setRoad(x, 4, true);
+  }
+  roads.update();
+
+  CHECK(roads.getVertexCount() == 4);
+  CHECK(roads.getEdgeCount() == 3);
+  CHECK(roads.getDistance({5, 0, 0, 0}, {9, 4, 0, 0}) == 8);
+  CHECK(roads.getDistance({5, 2, 0, 0}, {5, 7, 0, 0}) == 5);
+  CHECK(roads.getDistance({5, 2, 0, 0}, {0, 0, 0, 0}) == RoadNetwork::UNREACHABLE);
+
+  WHEN("The junction is demolished")
+  {
+    roads.setRoad(5, 4, false);
+
+    THEN("The road is split up")
+    {
+      CHECK(roads.getDistance({5, 0, 0, 0}, {9, 4, 0, 0}) == RoadNetwork::UNREACHABLE);
+      CHECK(roads.getDistance({5, 5, 0, 0}, {5, 9, 0, 0}) == 4);
+      CHECK(roads.getVertexCount() == 6);
+    }
+  }
+}
+
+TEST_CASE("Road distances match a breadth first search after incremental changes", "[engine][simulation]")
+{
+  constexpr int size = 32;
+  RoadNetwork roads(size, size);
+  buildGrid(roads, size);
+  std::mt19937 random(42);
+  std::uniform_int_distribution<int> coordinate(0, size - 1);
+
+  for (int round = 0; round < 20; ++round)
+  {
+    // demolish and place some roads
+    for (int i = 0; i < 10; ++i)
+    {
+      const int x = coordinate(random);
+      const int y = coordinate(random);
+      roads.setRoad(x, y, !roads.isRoad(x, y));
+    }
+
+    std::vector<std::pair<Point, Point>> queries;
+    for (int i = 0; i < 20; ++i)
+    {
+      queries.push_back({{coordinate(random), coordinate(random), 0, 0}, {coordinate(random), coordinate(random), 0, 0}});
+    }
+
+    const std::vector<int> distances = roads.getDistances(queries);
+    roads.buildContractionHierarchy();
+    REQUIRE(roads.hasContractionHierarchy());
+    const std::vector<int> hierarchyDistances = roads.getDistances(queries);
+
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+      const int expected = bfsDistance(roads, size, queries[i].first, queries[i].second);
+      CHECK(distances[i] == expected);
+      CHECK(hierarchyDistances[i] == expected);
+    }
+  }
+}
+
+TEST_CASE("Benchmark road queries on a dense 256x256 grid", "[.][benchmark]")
+{
+  using Clock = std::chrono::steady_clock;
+  constexpr int size = 256;
+  constexpr int queryCount = 1000;
+
+  RoadNetwork roads(size, size);
+  auto start = Clock::now();
+  buildGrid(roads, size);
+  roads.update();
+  const auto buildTime = Clock::now() - start;
+
+  std::mt19937 random(7);
+  std::uniform_int_distribution<int> coordinate(0, size / 4 - 1);
+  std::vector<std::pair<Point, Point>> queries;
+  for (int i = 0; i < queryCount; ++i)
+  {
+    queries.push_back({{coordinate(random) * 4, coordinate(random) * 4, 0, 0}, {coordinate(random) * 4, coordinate(random) * 4, 0, 0}});
+  }
+
+  start = Clock::now();
+  const std::vector<int> altDistances = roads.getDistances(queries);
+  const auto altTime = Clock::now() - start;
+
+  start = Clock::now();
+  roads.setRoad(1, 1, true);
+  roads.update();
+  const auto patchTime = Clock::now() - start;
+  roads.setRoad(1, 1, false);
+
+  start = Clock::now();
+  roads.buildContractionHierarchy();
+  const auto hierarchyBuildTime = Clock::now() - start;
+
+  start = Clock::now();
+  const std::vector<int> hierarchyDistances = roads.getDistances(queries);
+  const auto hierarchyTime = Clock::now() - start;
+
+  CHECK(altDistances == hierarchyDistances);
+
+  using std::chrono::microseconds;
+  using std::chrono::duration_cast;
+  LOG(LOG_INFO) << "Road graph: " << roads.getVertexCount() << " vertices, " << roads.getEdgeCount() << " edges, built in "
+                << duration_cast<microseconds>(buildTime).count() << "us, patched in "
+                << duration_cast<microseconds>(patchTime).count() << "us";
+  LOG(LOG_INFO) << queryCount << " ALT queries: " << duration_cast<microseconds>(altTime).count() << "us";
+  LOG(LOG_INFO) << "Contraction hierarchy built in " << duration_cast<microseconds>(hierarchyBuildTime).count() << "us, "
+                << queryCount << " queries: " << duration_cast<microseconds>(hierarchyTime).count() << "us";
+}
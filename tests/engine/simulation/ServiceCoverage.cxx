@@ -0,0 +1,66 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/RoadNetwork.hxx"
+#include "../../../src/engine/simulation/ServiceCoverage.hxx"
+
+TEST_CASE("Coverage follows the roads", "[engine][simulation]")
+{
+  RoadNetwork roads(64, 64);
+  ServiceCoverage coverage(roads, 64, 64);
+
+  // a straight road along x = 10 and a fire station next to its start
+  for (int y = 0; y < 64; ++y)
+  {
+    roads.setRoad(10, y, true);
+    coverage.onRoadChanged(10, y);
+  }
+  coverage.setStation(11, 0, ServiceCoverage::FIRE, true);
+  coverage.update();
+
+  const int range = ServiceCoverage::getRange(ServiceCoverage::FIRE);
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 11, 0) == 0);
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, 5) == 5);
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 9, 5) == 6);
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, range) == range);
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, range + 1) == ServiceCoverage::UNCOVERED);
+  // close by air, but not connected by a road
+  CHECK(coverage.getDistance(ServiceCoverage::FIRE, 13, 2) == ServiceCoverage::UNCOVERED);
+  CHECK(coverage.getDistance(ServiceCoverage::POLICE, 10, 5) == ServiceCoverage::UNCOVERED);
+
+  WHEN("The road is cut")
+  {
+    roads.setRoad(10, 3, false);
+    coverage.onRoadChanged(10, 3);
+    coverage.update();
+
+    CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, 2) == 2);
+    CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, 5) == ServiceCoverage::UNCOVERED);
+  }
+
+  WHEN("A road outside of the covered area changes")
+  {
+    const size_t recomputeCount = coverage.getRecomputeCount();
+    roads.setRoad(40, 40, true);
+    coverage.onRoadChanged(40, 40);
+    coverage.update();
+
+    CHECK(coverage.getRecomputeCount() == recomputeCount);
+    CHECK(coverage.getChangedBounds().empty());
+  }
+
+  WHEN("The station is removed")
+  {
+    coverage.setStation(11, 0, ServiceCoverage::FIRE, false);
+    coverage.update();
+
+    CHECK(coverage.getDistance(ServiceCoverage::FIRE, 10, 5) == ServiceCoverage::UNCOVERED);
+
+    // only the area the station covered before has changed
+    REQUIRE(coverage.getChangedBounds().size() == 1);
+    const ServiceCoverage::Bounds &bounds = coverage.getChangedBounds().front();
+    CHECK(bounds.contains(9, 5));
+    CHECK(bounds.contains(11, range));
+    CHECK_FALSE(bounds.contains(10, range + 2));
+    CHECK_FALSE(bounds.contains(20, 0));
+  }
+}
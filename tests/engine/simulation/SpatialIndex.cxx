@@ -0,0 +1,75 @@
+#include <catch.hpp>
+#include <cstdlib>
+
+#include "../../../src/engine/simulation/SpatialIndex.hxx"
+
+TEST_CASE("Chunk bitmaps count rectangles", "[engine][simulation]")
+{
+  ChunkBitmap bitmap(30, 21);
+  for (int x = 0; x < 21; ++x)
+  {
+    bitmap.set(x, 13, true);
+  }
+  bitmap.set(5, 5, true);
+  bitmap.set(20, 29, true);
+
+  CHECK(bitmap.count(0, 0, 20, 29) == 23);
+  CHECK(bitmap.count(3, 10, 17, 15) == 15);
+  CHECK(bitmap.count(5, 5, 5, 5) == 1);
+  CHECK(bitmap.count(6, 0, 10, 12) == 0);
+  CHECK(bitmap.count(-5, -5, 100, 100) == 23);
+
+  bitmap.set(5, 5, false);
+  CHECK(bitmap.count(0, 0, 20, 29) == 22);
+}
+
+TEST_CASE("Dilated bitmaps match Manhattan distances", "[engine][simulation]")
+{
+  const int columns = 37;
+  const int rows = 29;
+  ChunkBitmap bitmap(columns, rows);
+  const Point sources[] = {{3, 4, 0, 0}, {15, 30, 0, 0}, {28, 8, 0, 0}, {7, 7, 0, 0}};
+  for (const Point &source : sources)
+  {
+    bitmap.set(source.x, source.y, true);
+  }
+
+  ChunkBitmap dilated = bitmap;
+  dilated.dilate(5);
+
+  for (int x = 0; x < rows; ++x)
+  {
+    for (int y = 0; y < columns; ++y)
+    {
+      int nearestDistance = rows + columns;
+      for (const Point &source : sources)
+      {
+        nearestDistance = std::min(nearestDistance, std::abs(source.x - x) + std::abs(source.y - y));
+      }
+      CHECK(dilated.get(x, y) == (nearestDistance <= 5));
+
+      Point nearest;
+      REQUIRE(bitmap.findNearest(x, y, rows + columns, nearest));
+      CHECK(std::abs(nearest.x - x) + std::abs(nearest.y - y) == nearestDistance);
+      CHECK(bitmap.findNearest(x, y, 2, nearest) == (nearestDistance <= 2));
+    }
+  }
+}
+
+TEST_CASE("The spatial index answers queries per class", "[engine][simulation]")
+{
+  SpatialIndex index(64, 64);
+  for (int y = 0; y < 64; ++y)
+  {
+    index.set(32, y, SpatialIndex::ROAD, true);
+  }
+
+  CHECK(index.isWithinDistance(SpatialIndex::ROAD, 29, 10, 3));
+  CHECK_FALSE(index.isWithinDistance(SpatialIndex::ROAD, 28, 10, 3));
+  CHECK_FALSE(index.isWithinDistance(SpatialIndex::WATER, 32, 10, 3));
+  CHECK(index.count(SpatialIndex::ROAD, 0, 0, 63, 9) == 10);
+
+  // the cached dilation is refreshed after a change
+  index.set(20, 10, SpatialIndex::ROAD, true);
+  CHECK(index.isWithinDistance(SpatialIndex::ROAD, 22, 11, 3));
+}
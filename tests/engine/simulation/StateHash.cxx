@@ -0,0 +1,124 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+
+#include "../../GameFixture.hxx"
+#include "../../../src/engine/Map.hxx"
+#include "../../../src/engine/simulation/CommandLog.hxx"
+#include "../../../src/engine/simulation/Simulation.hxx"
+#include "../../../src/engine/simulation/StateHash.hxx"
+
+namespace
+{
+constexpr int SIZE = 32;
+constexpr int TERRAIN_SEED = 42;
+constexpr uint32_t TICKS = 300;
+
+MapCommand createCommand(uint32_t tick, MapCommand::Type type, const std::string &tileID, int x0, int y0, int x1, int y1)
+{
+  MapCommand command;
+  command.tick = tick;
+  command.type = type;
+  command.tileID = tileID;
+  for (int x = x0; x <= x1; ++x)
+  {
+    for (int y = y0; y <= y1; ++y)
+    {
+      command.nodes.push_back(Point{x, y, 0, 0});
+    }
+  }
+  return command;
+}
+
+/// Execute the commands of a log on a new map after their ticks, like Engine::replay, and collect the hash of every tick
+std::vector<uint64_t> replay(const CommandLog &log)
+{
+  Map map(SIZE, SIZE, true, TERRAIN_SEED);
+  Simulation simulation(map, log.getSeed());
+  simulation.rebuild();
+
+  std::vector<uint64_t> hashes;
+  while (simulation.getTickCount() < TICKS)
+  {
+    size_t command;
+    const size_t end = log.getCommandsAt(simulation.getTickCount(), command);
+    for (; command < end; ++command)
+    {
+      simulation.applyCommand(log.getCommands()[command]);
+    }
+    simulation.tick();
+    hashes.push_back(simulation.getStateHash().getHash());
+  }
+  return hashes;
+}
+} // namespace
+
+TEST_CASE("State hashes only rehash changed chunks", "[engine][simulation]")
+{
+  StateHash state(64, 64);
+  StateHash other(64, 64);
+  const uint64_t emptyHash = state.getHash();
+  CHECK(state.findDifference(other) == StateHash::NO_CHUNK);
+
+  const size_t hashedChunks = state.getHashedChunkCount();
+  state.setNode(20, 40, 5);
+  state.update();
+  CHECK(state.getHashedChunkCount() == hashedChunks + 1);
+  CHECK(state.getHash() != emptyHash);
+  CHECK(state.findDifference(other) == 1 * 4 + 2);
+
+  // setting a node to its current value doesn't rehash anything
+  state.setNode(20, 40, 5);
+  state.update();
+  CHECK(state.getHashedChunkCount() == hashedChunks + 1);
+
+  state.setNode(20, 40, 0);
+  state.update();
+  CHECK(state.getHash() == emptyHash);
+}
+
+TEST_CASE_METHOD(GameFixture, "Replaying the command log reproduces the state hashes", "[engine][simulation]")
+{
+  const uint64_t seed = 1234;
+  Map map(SIZE, SIZE, true, TERRAIN_SEED);
+  Simulation simulation(map, seed);
+  simulation.rebuild();
+  CommandLog log;
+  log.reset(seed);
+
+  MapCommand powerPlant = createCommand(50, MapCommand::PLACE_OBJECT, "ind_3x3_OldPowerPlant", 0, 0, -1, -1);
+  powerPlant.nodes = map.getObjectCoords(Point{12, 20, 0, 0}, powerPlant.tileID);
+
+  const std::vector<MapCommand> commands = {
+      createCommand(0, MapCommand::PLACE, "road_european", 10, 0, 10, 31),
+      createCommand(0, MapCommand::PLACE, "zone_residential_dense", 11, 4, 14, 12),
+      createCommand(0, MapCommand::PLACE, "zone_commercial_light", 6, 4, 9, 12),
+      powerPlant,
+      createCommand(120, MapCommand::PLACE, "road_european", 0, 16, 31, 16),
+      createCommand(120, MapCommand::DEMOLISH, "", 11, 4, 12, 6),
+      createCommand(200, MapCommand::PLACE, "zone_industrial_light", 17, 11, 20, 15)};
+
+  std::vector<uint64_t> hashes;
+  size_t next = 0;
+  while (simulation.getTickCount() < TICKS)
+  {
+    for (; next < commands.size() && commands[next].tick == simulation.getTickCount(); ++next)
+    {
+      log.record(commands[next]);
+      simulation.applyCommand(commands[next]);
+    }
+    simulation.tick();
+    hashes.push_back(simulation.getStateHash().getHash());
+  }
+  REQUIRE(log.getCommands().size() == commands.size());
+  // the city changed over time
+  CHECK(hashes.front() != hashes.back());
+
+  CHECK(replay(log) == hashes);
+
+  size_t first;
+  CHECK(log.getCommandsAt(120, first) == 6);
+  CHECK(first == 4);
+  CHECK(log.getCommandsAt(121, first) == first);
+  CHECK_THROWS(log.record(createCommand(10, MapCommand::PLACE, "road_european", 0, 0, 1, 1)));
+}
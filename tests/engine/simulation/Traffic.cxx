@@ -0,0 +1,159 @@
+#include <catch.hpp>
+#include <chrono>
+
+#include "../../../src/engine/simulation/RoadNetwork.hxx"
+#include "../../../src/engine/simulation/Traffic.hxx"
+#include "LOG.hxx"
+
+namespace
+{
+/// roads on every 4th row and column
+void buildRoadGrid(RoadNetwork &roads, int size)
+{
+  for (int x = 0; x < size; ++x)
+  {
+    for (int y = 0; y < size; ++y)
+    {
+      if (x % 4 == 0 || y % 4 == 0)
+      {
+        roads.setRoad(x, y, true);
+      }
+    }
+  }
+  roads.update();
+}
+
+int totalOccupancy(const Traffic &traffic, const RoadNetwork &roads)
+{
+  int total = 0;
+  for (size_t edge = 0; edge < roads.getEdges().size(); ++edge)
+  {
+    total += traffic.getOccupancy(static_cast<int>(edge));
+  }
+  return total;
+}
+} // namespace
+
+TEST_CASE("Traffic agents drive along the roads", "[engine][simulation]")
+{
+  RoadNetwork roads(32, 32);
+  buildRoadGrid(roads, 32);
+  Traffic traffic(roads, 1);
+  traffic.spawn(500);
+
+  for (int i = 0; i < 300; ++i)
+  {
+    traffic.step();
+  }
+
+  REQUIRE(traffic.getAgentCount() == 500);
+  CHECK(totalOccupancy(traffic, roads) == 500);
+
+  for (size_t agent = 0; agent < traffic.getAgentCount(); ++agent)
+  {
+    float x, y;
+    REQUIRE(traffic.getAgentPosition(agent, x, y));
+    // agents are always between two road nodes
+    const bool onRoad = roads.isRoad(static_cast<int>(x), static_cast<int>(y)) ||
+                        roads.isRoad(static_cast<int>(std::ceil(x)), static_cast<int>(std::ceil(y)));
+    CHECK(onRoad);
+  }
+
+  WHEN("Roads are demolished")
+  {
+    for (int y = 0; y < 32; ++y)
+    {
+      roads.setRoad(0, y, false);
+    }
+    roads.update();
+    traffic.step();
+
+    THEN("The agents on them are removed")
+    {
+      CHECK(traffic.getAgentCount() < 500);
+      CHECK(totalOccupancy(traffic, roads) == static_cast<int>(traffic.getAgentCount()));
+    }
+  }
+
+  WHEN("Roads are demolished between two steps")
+  {
+    for (int y = 0; y < 32; ++y)
+    {
+      roads.setRoad(4, y, false);
+    }
+    roads.update();
+
+    THEN("The agents on them have no position until the traffic is advanced")
+    {
+      size_t stranded = 0;
+      for (size_t agent = 0; agent < traffic.getAgentCount(); ++agent)
+      {
+        float x, y;
+        stranded += traffic.getAgentPosition(agent, x, y) ? 0 : 1;
+      }
+      CHECK(stranded > 0);
+
+      // too little time for a step, the agents still leave the demolished roads
+      traffic.advance(0.f);
+      for (size_t agent = 0; agent < traffic.getAgentCount(); ++agent)
+      {
+        float x, y;
+        CHECK(traffic.getAgentPosition(agent, x, y));
+      }
+    }
+  }
+}
+
+TEST_CASE("The worker threads move the agents like the calling thread", "[engine][simulation]")
+{
+  RoadNetwork roads(128, 128);
+  buildRoadGrid(roads, 128);
+
+  Traffic single(roads, 1);
+  Traffic parallel(roads, 1);
+  parallel.setThreadCount(4);
+  single.spawn(40000);
+  parallel.spawn(40000);
+
+  for (int i = 0; i < 20; ++i)
+  {
+    single.step();
+    parallel.step();
+  }
+
+  bool samePositions = true;
+  for (size_t agent = 0; agent < single.getAgentCount(); ++agent)
+  {
+    float singleX, singleY, parallelX, parallelY;
+    single.getAgentPosition(agent, singleX, singleY);
+    parallel.getAgentPosition(agent, parallelX, parallelY);
+    samePositions = samePositions && singleX == parallelX && singleY == parallelY;
+  }
+  CHECK(samePositions);
+}
+
+TEST_CASE("Benchmark 100k traffic agents", "[.][benchmark]")
+{
+  using Clock = std::chrono::steady_clock;
+  constexpr int steps = 100;
+
+  RoadNetwork roads(256, 256);
+  buildRoadGrid(roads, 256);
+
+  for (unsigned int threads : {1u, 4u})
+  {
+    Traffic traffic(roads, 1);
+    traffic.setThreadCount(threads);
+    traffic.spawn(100000);
+
+    const auto start = Clock::now();
+    for (int i = 0; i < steps; ++i)
+    {
+      traffic.step();
+    }
+    const auto duration = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+
+    CHECK(totalOccupancy(traffic, roads) == 100000);
+    LOG(LOG_INFO) << "100k agents, " << threads << " threads: " << duration.count() / steps << "us per step";
+  }
+}
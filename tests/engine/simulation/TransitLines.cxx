@@ -0,0 +1,138 @@
+#include <catch.hpp>
+#include <vector>
+
+#include "../../../src/engine/simulation/BuildingStore.hxx"
+#include "../../../src/engine/simulation/RoadNetwork.hxx"
+#include "../../../src/engine/simulation/TransitLines.hxx"
+#include "../../../src/engine/basics/tileData.hxx"
+#include "../../../src/util/ByteStream.hxx"
+
+namespace
+{
+/// a straight road along x = 5 from y = 0 to y = 30
+RoadNetwork createRoad()
+{
+  RoadNetwork roads(32, 32);
+  for (int y = 0; y <= 30; ++y)
+  {
+    roads.setRoad(5, y, true);
+  }
+  roads.update();
+  return roads;
+}
+} // namespace
+
+TEST_CASE("Transit lines follow their schedule", "[engine][simulation]")
+{
+  RoadNetwork roads = createRoad();
+  TransitLines lines(32, 32);
+  CHECK_FALSE(lines.addLine({Point{5, 0, 0, 0}}, 1));
+  REQUIRE(lines.addLine({Point{5, 0, 0, 0}, Point{5, 10, 0, 0}, Point{5, 30, 0, 0}}, 2));
+  lines.update(roads);
+
+  // out and back along the road, waiting at every stop
+  const TransitLines::Line &line = lines.getLines().front();
+  REQUIRE(line.isRunning());
+  const int dwell = TransitLines::DwellTicks;
+  CHECK(line.getCycleTime() == 60 * TransitLines::TicksPerNode + 3 * dwell);
+  CHECK(lines.getTravelTime(0, 0, 1) == 10 + dwell);
+  CHECK(lines.getTravelTime(0, 1, 0) == line.getCycleTime() - 10 - dwell);
+
+  float x, y;
+  REQUIRE(lines.getVehiclePosition(0, 0, 0, x, y));
+  CHECK(y == 0.f);
+  REQUIRE(lines.getVehiclePosition(0, 0, dwell + 5, x, y));
+  CHECK(x == 5.f);
+  CHECK(y == Approx(5.f));
+  // the second vehicle is half a cycle ahead, and the schedule repeats
+  float otherX, otherY;
+  lines.getVehiclePosition(0, 1, 0, otherX, otherY);
+  lines.getVehiclePosition(0, 0, line.getCycleTime() / 2.0 + 10 * line.getCycleTime(), x, y);
+  CHECK(y == Approx(otherY));
+
+  // the line stops running when its road is cut
+  roads.setRoad(5, 20, false);
+  roads.update();
+  lines.update(roads);
+  CHECK_FALSE(lines.getLines().front().isRunning());
+  CHECK(lines.getTravelTime(0, 0, 1) == TransitLines::UNREACHABLE);
+
+  CHECK(lines.removeLineAt(Point{5, 10, 0, 0}));
+  CHECK(lines.getLines().empty());
+}
+
+TEST_CASE("Transit riders come from the catchment of the stops", "[engine][simulation]")
+{
+  RoadNetwork roads = createRoad();
+  TransitLines lines(32, 32);
+  REQUIRE(lines.addLine({Point{5, 0, 0, 0}, Point{5, 30, 0, 0}}, 1));
+  lines.update(roads);
+
+  CHECK(lines.getStopDistance(5, 0) == 0);
+  CHECK(lines.getStopDistance(8, 2) == 5);
+  CHECK(lines.getNearestStop(8, 2) == TransitLines::packStop(0, 0));
+  CHECK(lines.getNearestStop(5, 28) == TransitLines::packStop(0, 1));
+  CHECK(lines.getNearestStop(20, 15) == TransitLines::NO_STOP);
+
+  TileData house;
+  house.tileType = TileType::RCI;
+  house.zones = {Zones::RESIDENTIAL};
+  house.inhabitants = 100;
+  TileData office;
+  office.tileType = TileType::RCI;
+  office.zones = {Zones::COMMERCIAL};
+  office.inhabitants = 50;
+
+  BuildingStore buildings(32, 32);
+  buildings.setNode(6, 1, 6 * 32 + 1, &house);
+  buildings.setNode(20, 15, 20 * 32 + 15, &house);
+  buildings.setNode(6, 29, 6 * 32 + 29, &office);
+  lines.updateRidership(buildings);
+
+  const TransitLines::Line &line = lines.getLines().front();
+  CHECK(line.residents == 100);
+  CHECK(line.jobs == 50);
+  CHECK(line.ridership == static_cast<int>(50 * TransitLines::RiderShare));
+  CHECK(lines.getRiderShare() == Approx(line.ridership / 200.f));
+
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer);
+  lines.save(writer);
+  TransitLines loaded(32, 32);
+  ByteReader reader(buffer);
+  loaded.load(reader);
+  loaded.update(roads);
+  REQUIRE(loaded.getLines().size() == 1);
+  CHECK(loaded.getLines().front().getCycleTime() == line.getCycleTime());
+}
+
+TEST_CASE("Transit lines reject too many vehicles and lines", "[engine][simulation]")
+{
+  TransitLines lines(32, 32);
+  const std::vector<Point> stops{Point{5, 0, 0, 0}, Point{5, 30, 0, 0}};
+  CHECK_FALSE(lines.addLine(stops, 0));
+  CHECK_FALSE(lines.addLine(stops, TransitLines::MaxVehicles + 1));
+  REQUIRE(lines.addLine(stops, TransitLines::MaxVehicles));
+
+  // a saved line with too many vehicles is malformed
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer);
+  writer.writeVarint(1);
+  writer.writeVarint(TransitLines::MaxVehicles + 1);
+  writer.writeVarint(stops.size());
+  for (const Point &stop : stops)
+  {
+    writer.writeSignedVarint(stop.x);
+    writer.writeSignedVarint(stop.y);
+  }
+  ByteReader reader(buffer);
+  CHECK_THROWS(lines.load(reader));
+  CHECK(lines.getLines().size() == 1);
+
+  while (lines.getLines().size() < TransitLines::MaxLines)
+  {
+    REQUIRE(lines.addLine(stops, 1));
+  }
+  CHECK_FALSE(lines.addLine(stops, 1));
+  CHECK(TransitLines::packStop(TransitLines::MaxLines - 1, 0xFFFF) > 0);
+}
@@ -0,0 +1,114 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/simulation/WaterNetwork.hxx"
+
+TEST_CASE("Water pipes are collapsed into a compact graph", "[engine][simulation]")
+{
+  WaterNetwork water(16, 16);
+
+  // an L-shaped pipe from (0, 2) over (5, 2) to (5, 8)
+  for (int x = 0; x <= 5; ++x)
+  {
+    water.setPipe(x, 2, true);
+  }
+  for (int y = 3; y <= 8; ++y)
+  {
+    water.setPipe(5, y, true);
+  }
+  water.update();
+
+  const WaterNetwork::Network *network = water.getNetwork(3, 2);
+  REQUIRE(network != nullptr);
+  CHECK(network == water.getNetwork(5, 8));
+  CHECK(network->nodes.size() == 12);
+  CHECK(network->vertices.size() == 3);
+  CHECK(network->edges.size() == 2);
+
+  WHEN("The pipe is cut")
+  {
+    water.setPipe(5, 5, false);
+    water.update();
+
+    THEN("There are two networks")
+    {
+      CHECK(water.getNetwork(5, 5) == nullptr);
+      CHECK(water.getNetwork(0, 2) != water.getNetwork(5, 8));
+      CHECK(water.getNetwork(0, 2)->nodes.size() == 8);
+    }
+  }
+}
+
+TEST_CASE("Water is shared fairly between consumers", "[engine][simulation]")
+{
+  WaterNetwork water(16, 16);
+
+  for (int y = 0; y < 10; ++y)
+  {
+    water.setPipe(1, y, true);
+  }
+  // a water tower and three consumers next to the pipe
+  water.setBuildingNode(0, 0, 0, 0, 100);
+  water.setBuildingNode(0, 3, 0, 3, -10);
+  water.setBuildingNode(2, 5, 2, 5, -60);
+  water.setBuildingNode(0, 9, 0, 9, -80);
+  // a consumer that is not connected
+  water.setBuildingNode(10, 10, 10, 10, -10);
+  water.update();
+
+  THEN("The small consumer is fully served and the rest is split evenly")
+  {
+    CHECK(water.getServedFraction(0, 0) == 1.f);
+    CHECK(water.getServedFraction(0, 3) == 1.f);
+    CHECK(water.getServedFraction(2, 5) == Approx(45.f / 60.f));
+    CHECK(water.getServedFraction(0, 9) == Approx(45.f / 80.f));
+    CHECK(water.getServedFraction(10, 10) == 0.f);
+  }
+
+  WHEN("The water tower is demolished")
+  {
+    water.clearBuildingNode(0, 0);
+    water.update();
+
+    THEN("No consumer is served anymore")
+    {
+      CHECK(water.getServedFraction(0, 3) == 0.f);
+      CHECK(water.getServedFraction(2, 5) == 0.f);
+    }
+  }
+}
+
+TEST_CASE("A building between two networks is reclaimed when its network is removed", "[engine][simulation]")
+{
+  WaterNetwork water(16, 16);
+
+  // a consumer between two separate pipes, each with a water tower
+  for (int y = 0; y < 4; ++y)
+  {
+    water.setPipe(4, y, true);
+    water.setPipe(6, y, true);
+  }
+  water.setBuildingNode(5, 2, 5, 2, -10);
+  water.setBuildingNode(3, 0, 3, 0, 50);
+  water.setBuildingNode(7, 0, 7, 0, 50);
+  water.update();
+
+  const WaterNetwork::Network *first = water.getNetwork(4, 2);
+  const WaterNetwork::Network *second = water.getNetwork(6, 2);
+  REQUIRE(first != second);
+  const bool firstClaimed = first->buildings.size() == 2;
+  CHECK(first->buildings.size() + second->buildings.size() == 3);
+  CHECK(water.getServedFraction(5, 2) == 1.f);
+
+  // remove the pipe that claimed the consumer
+  const int pipeX = firstClaimed ? 4 : 6;
+  for (int y = 0; y < 4; ++y)
+  {
+    water.setPipe(pipeX, y, false);
+  }
+  water.update();
+
+  const WaterNetwork::Network *remaining = water.getNetwork(firstClaimed ? 6 : 4, 2);
+  REQUIRE(remaining != nullptr);
+  CHECK(remaining->buildings.size() == 2);
+  CHECK(water.getServedFraction(5, 2) == 1.f);
+}
@@ -0,0 +1,77 @@
+#include <catch.hpp>
+
+#include "../../../src/engine/Map.hxx"
+#include "../../../src/engine/simulation/ZoneGrowth.hxx"
+
+namespace
+{
+MapNodeChange zoneChange(int x, int y, const TileData *zoneTile)
+{
+  return MapNodeChange{Point{x, y, 0, 0}, Layer::ZONE, nullptr, zoneTile, Point::INVALID(), Point::INVALID()};
+}
+} // namespace
+
+TEST_CASE("Removing a candidate keeps the rest of the worklist", "[engine][simulation]")
+{
+  Map map(8, 8, false);
+  ZoneGrowth zoneGrowth(map);
+  TileData residential;
+  residential.subCategory = "Residential";
+
+  for (int y = 0; y < 4; ++y)
+  {
+    zoneGrowth.onNodeChanged(zoneChange(2, y, &residential));
+  }
+  // zoning a node twice doesn't add it twice
+  zoneGrowth.onNodeChanged(zoneChange(2, 1, &residential));
+  CHECK(zoneGrowth.getCandidateCount() == 4);
+
+  // the last candidate moves into the gap of the removed one
+  zoneGrowth.onNodeChanged(zoneChange(2, 0, nullptr));
+  CHECK(zoneGrowth.getCandidateCount() == 3);
+  CHECK_FALSE(zoneGrowth.isCandidate(Point{2, 0, 0, 0}));
+  CHECK(zoneGrowth.isCandidate(Point{2, 1, 0, 0}));
+  CHECK(zoneGrowth.isCandidate(Point{2, 3, 0, 0}));
+
+  // removing the moved candidate and the last one still finds their positions
+  zoneGrowth.onNodeChanged(zoneChange(2, 3, nullptr));
+  zoneGrowth.onNodeChanged(zoneChange(2, 2, nullptr));
+  CHECK(zoneGrowth.getCandidateCount() == 1);
+  CHECK(zoneGrowth.isCandidate(Point{2, 1, 0, 0}));
+
+  zoneGrowth.onNodeChanged(zoneChange(2, 1, nullptr));
+  CHECK(zoneGrowth.getCandidateCount() == 0);
+}
+
+TEST_CASE("Footprints only fit on empty nodes of one zone inside the map", "[engine][simulation]")
+{
+  Map map(8, 8, false);
+  ZoneGrowth zoneGrowth(map);
+  TileData residential;
+  residential.subCategory = "Residential";
+  TileData commercial;
+  commercial.subCategory = "Commercial";
+
+  for (int x = 0; x < 3; ++x)
+  {
+    for (int y = 0; y < 3; ++y)
+    {
+      zoneGrowth.onNodeChanged(zoneChange(x, y, &residential));
+    }
+  }
+
+  RequiredTilesData footprint;
+  footprint.width = 2;
+  footprint.height = 3;
+  // the footprint grows towards smaller x and larger y
+  CHECK(zoneGrowth.fitsFootprint(Point{2, 0, 0, 0}, footprint, Zones::RESIDENTIAL));
+  CHECK(zoneGrowth.fitsFootprint(Point{1, 0, 0, 0}, footprint, Zones::RESIDENTIAL));
+  CHECK_FALSE(zoneGrowth.fitsFootprint(Point{2, 1, 0, 0}, footprint, Zones::RESIDENTIAL));
+  CHECK_FALSE(zoneGrowth.fitsFootprint(Point{0, 0, 0, 0}, footprint, Zones::RESIDENTIAL));
+  CHECK_FALSE(zoneGrowth.fitsFootprint(Point{2, 0, 0, 0}, footprint, Zones::COMMERCIAL));
+
+  // a node of another zone breaks the footprint
+  zoneGrowth.onNodeChanged(zoneChange(1, 2, &commercial));
+  CHECK_FALSE(zoneGrowth.fitsFootprint(Point{2, 0, 0, 0}, footprint, Zones::RESIDENTIAL));
+  CHECK(zoneGrowth.fitsFootprint(Point{2, 0, 0, 0}, RequiredTilesData{}, Zones::RESIDENTIAL));
+}
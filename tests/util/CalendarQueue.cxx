@@ -0,0 +1,58 @@
+#include <catch.hpp>
+
+#include "CalendarQueue.hxx"
+
+TEST_CASE("Calendar queues return values on their day", "[util]")
+{
+  CalendarQueue<int> queue(8);
+  queue.schedule(3, 30);
+  queue.schedule(1, 10);
+  queue.schedule(3, 31);
+  CHECK(queue.size() == 3);
+
+  int value = 0;
+  CHECK_FALSE(queue.popDue(0, value));
+  REQUIRE(queue.popDue(2, value));
+  CHECK(value == 10);
+  CHECK_FALSE(queue.popDue(2, value));
+
+  // values that are overdue come first
+  queue.schedule(5, 50);
+  REQUIRE(queue.popDue(6, value));
+  CHECK((value == 30 || value == 31));
+  REQUIRE(queue.popDue(6, value));
+  REQUIRE(queue.popDue(6, value));
+  CHECK(value == 50);
+  CHECK(queue.empty());
+}
+
+TEST_CASE("Calendar queues clamp days to their horizon", "[util]")
+{
+  CalendarQueue<int> queue(4);
+  int value = 0;
+  CHECK_FALSE(queue.popDue(10, value));
+  CHECK(queue.getCurrentDay() == 10);
+
+  CHECK(queue.schedule(2, 1) == 10);
+  CHECK(queue.schedule(100, 2) == 13);
+  REQUIRE(queue.popDue(10, value));
+  CHECK(value == 1);
+  CHECK_FALSE(queue.popDue(12, value));
+  REQUIRE(queue.popDue(13, value));
+  CHECK(value == 2);
+}
+
+TEST_CASE("Calendar queues continue on the day they are reset to", "[util]")
+{
+  CalendarQueue<int> queue(4);
+  queue.schedule(2, 1);
+  queue.reset(100);
+  CHECK(queue.empty());
+  CHECK(queue.getCurrentDay() == 100);
+
+  int value = 0;
+  CHECK(queue.schedule(102, 2) == 102);
+  CHECK_FALSE(queue.popDue(101, value));
+  REQUIRE(queue.popDue(102, value));
+  CHECK(value == 2);
+}
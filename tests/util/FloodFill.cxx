@@ -0,0 +1,81 @@
+#include <catch.hpp>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "FloodFill.hxx"
+
+namespace
+{
+/// A map of 8 rows, '#' blocks the fill
+const std::vector<std::string> GRID = {"..........", //
+                                       ".####.....", //
+                                       ".#..#.###.", //
+                                       ".#..#.#.#.", //
+                                       ".##.#.#.#.", //
+                                       "...##.#.##", //
+                                       "......#...", //
+                                       "......#..."};
+const int COLUMNS = 10;
+const int ROWS = 8;
+
+bool isFree(int x, int y) { return GRID[x][y] == '.'; }
+} // namespace
+
+TEST_CASE("Flood fill stops at blocked nodes", "[util]")
+{
+  FloodFill floodFill(COLUMNS, ROWS);
+  std::vector<int> nodes;
+
+  // the pocket inside the first wall
+  CHECK(floodFill.fill(2, 2, isFree, 1000, nodes));
+  std::sort(nodes.begin(), nodes.end());
+  CHECK(nodes == std::vector<int>{2 * COLUMNS + 2, 2 * COLUMNS + 3, 3 * COLUMNS + 2, 3 * COLUMNS + 3, 4 * COLUMNS + 3});
+
+  // the pocket at the bottom right widens below its entrance, so the fill needs seeds in both directions
+  CHECK(floodFill.fill(3, 7, isFree, 1000, nodes));
+  CHECK(nodes.size() == 9);
+  CHECK(floodFill.fill(7, 9, isFree, 1000, nodes));
+  CHECK(nodes.size() == 9);
+
+  // blocked start nodes fill nothing
+  CHECK(floodFill.fill(1, 1, isFree, 1000, nodes));
+  CHECK(nodes.empty());
+  CHECK(floodFill.fill(-1, 3, isFree, 1000, nodes));
+  CHECK(nodes.empty());
+}
+
+TEST_CASE("Flood fill covers the whole connected area", "[util]")
+{
+  FloodFill floodFill(COLUMNS, ROWS);
+  std::vector<int> nodes;
+  std::vector<int> checks(COLUMNS * ROWS, 0);
+  auto countingIsFree = [&checks](int x, int y) {
+    ++checks[x * COLUMNS + y];
+    return isFree(x, y);
+  };
+
+  CHECK(floodFill.fill(0, 0, countingIsFree, 1000, nodes));
+
+  int expected = 0;
+  for (int x = 0; x < ROWS; ++x)
+  {
+    expected += static_cast<int>(std::count(GRID[x].begin(), GRID[x].end(), '.'));
+  }
+  // the two pockets aren't connected to the outside
+  expected -= 5 + 9;
+  CHECK(static_cast<int>(nodes.size()) == expected);
+
+  std::sort(nodes.begin(), nodes.end());
+  CHECK(std::adjacent_find(nodes.begin(), nodes.end()) == nodes.end());
+  CHECK(*std::max_element(checks.begin(), checks.end()) == 1);
+}
+
+TEST_CASE("Flood fill stops at the maximum area", "[util]")
+{
+  FloodFill floodFill(COLUMNS, ROWS);
+  std::vector<int> nodes;
+
+  CHECK_FALSE(floodFill.fill(0, 0, isFree, 7, nodes));
+  CHECK(nodes.size() == 7);
+}
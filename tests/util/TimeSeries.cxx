@@ -0,0 +1,131 @@
+#include <catch.hpp>
+#include <vector>
+
+#include "ByteStream.hxx"
+#include "TimeSeries.hxx"
+
+TEST_CASE("Varints survive a round trip", "[util]")
+{
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer);
+  writer.writeVarint(0);
+  writer.writeVarint(300);
+  writer.writeSignedVarint(-1);
+  writer.writeSignedVarint(-123456789);
+  CHECK(buffer.size() == 1 + 2 + 1 + 4);
+
+  ByteReader reader(buffer);
+  CHECK(reader.readVarint() == 0);
+  CHECK(reader.readVarint() == 300);
+  CHECK(reader.readSignedVarint() == -1);
+  CHECK(reader.readSignedVarint() == -123456789);
+  CHECK(reader.atEnd());
+  REQUIRE_THROWS_AS(reader.readVarint(), CytopiaError);
+}
+
+TEST_CASE("Time series are downsampled and compressed", "[util]")
+{
+  TimeSeries series;
+  const int days = 20 * 365;
+  for (int day = 0; day < days; ++day)
+  {
+    series.push(1000 + day * 3 + (day % 7 == 0 ? 50 : 0));
+  }
+
+  // the daily level only keeps the latest days, the weekly and monthly levels go back further
+  CHECK(series.getEndSample(0) == days);
+  CHECK(series.getFirstSample(0) > 0);
+  CHECK(series.getEndSample(1) == days / 7);
+  CHECK(series.getFirstSample(2) == 0);
+
+  std::vector<TimeSeries::Sample> samples;
+  series.getSamples(0, days - 3, days, samples);
+  REQUIRE(samples.size() == 3);
+  CHECK(samples.back().mean == 1000 + (days - 1) * 3);
+
+  // the oldest stored daily samples come from a compressed block
+  const size_t first = series.getFirstSample(0);
+  series.getSamples(0, 0, first + 2, samples);
+  REQUIRE(samples.size() == 2);
+  CHECK(samples[0].mean == 1000 + static_cast<int>(first) * 3 + (first % 7 == 0 ? 50 : 0));
+
+  series.getSamples(1, 0, 1, samples);
+  REQUIRE(samples.size() == 1);
+  CHECK(samples[0].min == 1003);
+  CHECK(samples[0].max == 1050);
+
+  CHECK(series.getMemoryUsage() < 32 * 1024);
+  CHECK(series.selectLevel(100, 200) == 0);
+  CHECK(series.selectLevel(days, 200) == 2);
+
+  WHEN("The series is saved and loaded")
+  {
+    std::vector<uint8_t> buffer;
+    ByteWriter writer(buffer);
+    series.save(writer);
+
+    TimeSeries loaded;
+    ByteReader reader(buffer);
+    loaded.load(reader);
+
+    std::vector<TimeSeries::Sample> loadedSamples;
+    for (int level = 0; level < TimeSeries::LevelCount; ++level)
+    {
+      series.getSamples(level, 0, series.getEndSample(level), samples);
+      loaded.getSamples(level, 0, loaded.getEndSample(level), loadedSamples);
+      REQUIRE(samples.size() == loadedSamples.size());
+      CHECK(samples.back().mean == loadedSamples.back().mean);
+      CHECK(samples.front().max == loadedSamples.front().max);
+    }
+
+    series.push(5);
+    loaded.push(5);
+    CHECK(series.getEndSample(2) == loaded.getEndSample(2));
+  }
+}
+
+TEST_CASE("Time series reject malformed data when they are loaded", "[util]")
+{
+  // a level without blocks and samples, with the given number of values in its incomplete sample
+  auto writeLevel = [](ByteWriter &writer, uint64_t count) {
+    writer.writeVarint(0);
+    writer.writeVarint(0);
+    writer.writeVarint(0);
+    writer.writeBytes({});
+    writer.writeVarint(count);
+    writer.writeSignedVarint(0);
+    writer.writeSignedVarint(0);
+    writer.writeSignedVarint(0);
+  };
+
+  std::vector<uint8_t> buffer;
+  ByteWriter writer(buffer);
+  writer.writeVarint(6);
+  writeLevel(writer, 0);
+  writeLevel(writer, 6);
+  writeLevel(writer, 6);
+  TimeSeries series;
+  ByteReader reader(buffer);
+  CHECK_NOTHROW(series.load(reader));
+
+  // the daily level combines a single value into a sample, so it can't have an incomplete one
+  std::vector<uint8_t> incomplete;
+  ByteWriter incompleteWriter(incomplete);
+  incompleteWriter.writeVarint(1);
+  for (int level = 0; level < TimeSeries::LevelCount; ++level)
+  {
+    writeLevel(incompleteWriter, 1);
+  }
+  ByteReader incompleteReader(incomplete);
+  CHECK_THROWS(series.load(incompleteReader));
+
+  // a block that is too short to hold its samples
+  std::vector<uint8_t> truncated;
+  ByteWriter truncatedWriter(truncated);
+  truncatedWriter.writeVarint(0);
+  truncatedWriter.writeVarint(0);
+  truncatedWriter.writeVarint(1);
+  truncatedWriter.writeBytes({0, 0, 0});
+  ByteReader truncatedReader(truncated);
+  CHECK_THROWS(series.load(truncatedReader));
+}